@@ -0,0 +1,140 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/api.h"
+#include "cpprelude/Ranges.h"
+#include <atomic>
+
+#if defined(OS_WINDOWS)
+#include <intrin.h>
+#define CPPR_RETURN_ADDRESS() _ReturnAddress()
+#elif defined(OS_LINUX)
+#define CPPR_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+namespace cppr
+{
+	/**
+	 * @brief      A call site which allocated memory
+	 */
+	struct Call_Site
+	{
+		/**
+		 * The return address of the allocation call
+		 */
+		void* address;
+		/**
+		 * The total size of the memory allocated from this call site in bytes
+		 */
+		usize size;
+		/**
+		 * The count of allocations made from this call site
+		 */
+		usize count;
+	};
+
+	namespace internal
+	{
+		struct Call_Site_Entry
+		{
+			std::atomic<void*> address;
+			std::atomic<usize> size;
+			std::atomic<usize> count;
+		};
+	}
+
+	/**
+	 * @brief      Thread safe allocation statistics of an allocator
+	 */
+	struct Allocator_Stats
+	{
+		/**
+		 * The count of histogram buckets, bucket `i` counts the allocations of size [2^i, 2^(i+1))
+		 */
+		constexpr static usize HISTOGRAM_SIZE = sizeof(usize) * 8;
+		/**
+		 * The maximum count of distinct call sites tracked
+		 */
+		constexpr static usize CALL_SITES_CAPACITY = 256;
+
+		/**
+		 * The size of the currently allocated memory in bytes
+		 */
+		std::atomic<usize> live_size;
+		/**
+		 * The maximum size of the allocated memory at any point in time in bytes
+		 */
+		std::atomic<usize> peak_size;
+		/**
+		 * The count of allocations
+		 */
+		std::atomic<usize> alloc_count;
+		/**
+		 * The count of frees
+		 */
+		std::atomic<usize> free_count;
+		/**
+		 * The allocation size histogram
+		 */
+		std::atomic<usize> histogram[HISTOGRAM_SIZE];
+		/**
+		 * Whether to track the allocations per call site or not
+		 * `Allocator_Trait::alloc` is always inlined so the call site resolves to its caller i.e. the container
+		 * function which allocates, in optimized builds that function may be inlined into its own caller too
+		 */
+		std::atomic<bool> track_call_sites;
+
+		internal::Call_Site_Entry _call_sites[CALL_SITES_CAPACITY];
+
+		/**
+		 * @brief      Creates zeroed allocator stats
+		 *
+		 * @param[in]  track_call_sites  Whether to track the allocations per call site or not
+		 */
+		API_CPPR Allocator_Stats(bool track_call_sites = false);
+
+		/**
+		 * @brief      Copy Constructor is deleted
+		 */
+		Allocator_Stats(const Allocator_Stats&) = delete;
+
+		/**
+		 * @brief      Copy assignment operator is deleted
+		 */
+		Allocator_Stats&
+		operator=(const Allocator_Stats&) = delete;
+
+		/**
+		 * @brief      Records an allocation
+		 *
+		 * @param[in]  size       The size of the allocation in bytes
+		 * @param      call_site  The return address of the allocation call
+		 */
+		API_CPPR void
+		record_alloc(usize size, void* call_site);
+
+		/**
+		 * @brief      Records a free
+		 *
+		 * @param[in]  size  The size of the freed memory in bytes
+		 */
+		API_CPPR void
+		record_free(usize size);
+
+		/**
+		 * @brief      Resets all the stats to zero
+		 */
+		API_CPPR void
+		reset();
+
+		/**
+		 * @brief      Fills the given slice with the call sites that allocated the most bytes
+		 *
+		 * @param      result  The slice to fill sorted by the allocated size descending
+		 *
+		 * @return     The count of call sites filled in the result
+		 */
+		API_CPPR usize
+		top_call_sites(Slice<Call_Site> result) const;
+	};
+}
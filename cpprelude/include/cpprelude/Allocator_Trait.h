@@ -7,13 +7,28 @@
 
 namespace cppr
 {
+	namespace internal
+	{
+		/**
+		 * @brief      Rounds the given value up to the nearest multiple of alignment
+		 *
+		 * @param[in]  value      The value to round up
+		 * @param[in]  alignment  The alignment, should be a power of 2
+		 */
+		inline usize
+		align_up(usize value, usize alignment)
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+	}
+
 	/**
 	 * @brief      The Allocator trait
 	 * All allocators should implement this trait
 	 */
 	struct Allocator_Trait
 	{
-		using alloc_func = Owner<byte>(*)(void*, usize);
+		using alloc_func = Owner<byte>(*)(void*, usize, usize);
 		using free_func = void(*)(void*, const Owner<byte>&);
 
 		void *_self = nullptr;
@@ -24,16 +39,18 @@ namespace cppr
 		 * @brief      Allocates the given count of values
 		 *
 		 * @param[in]  count      The count of values to allocate
+		 * @param[in]  alignment  The alignment of the memory block in bytes, should be a power of 2
 		 *
 		 * @tparam     T          The type of the values
 		 *
 		 * @return     An Owner pointer to the underlying memory block
 		 */
+		//it's always inlined so that the return address seen by the allocator is the caller's
 		template<typename T>
-		Owner<T>
-		alloc(usize count = 1)
+		CPPR_FORCE_INLINE Owner<T>
+		alloc(usize count = 1, usize alignment = alignof(T))
 		{
-			return _alloc(_self, sizeof(T) * count).template convert<T>();
+			return _alloc(_self, sizeof(T) * count, alignment).template convert<T>();
 		}
 
 		/**
@@ -4,6 +4,9 @@
 #include "cpprelude/Owner.h"
 #include "cpprelude/OS.h"
 #include "cpprelude/Allocator_Trait.h"
+#include "cpprelude/Allocator_Stats.h"
+#include "cpprelude/IO.h"
+#include <atomic>
 
 namespace cppr
 {
@@ -98,6 +101,28 @@ namespace cppr
 		API_CPPR usize
 		unused_memory_size() const;
 
+		/**
+		 * @brief      A saved position of the stack head
+		 */
+		struct Marker
+		{
+			byte* alloc_head;
+		};
+
+		/**
+		 * @return     A marker of the current stack head
+		 */
+		API_CPPR Marker
+		marker() const;
+
+		/**
+		 * @brief      Frees all the memory allocated after the given marker in O(1)
+		 *
+		 * @param[in]  value  The marker to roll back to
+		 */
+		API_CPPR void
+		rollback(const Marker& value);
+
 		/**
 		 * @brief      Implicit cast operator to Allocator Trait
 		 */
@@ -111,6 +136,7 @@ namespace cppr
 		 * @brief      Allocates the given count of values
 		 *
 		 * @param[in]  count      The count of values to allocate
+		 * @param[in]  alignment  The alignment of the memory block in bytes, should be a power of 2
 		 *
 		 * @tparam     T          The type of the values
 		 *
@@ -118,9 +144,9 @@ namespace cppr
 		 */
 		template<typename T>
 		Owner<T>
-		alloc(usize count = 1)
+		alloc(usize count = 1, usize alignment = alignof(T))
 		{
-			return _allocator_trait.template alloc<T>(count);
+			return _allocator_trait.template alloc<T>(count, alignment);
 		}
 
 		/**
@@ -300,6 +326,231 @@ namespace cppr
 		API_CPPR usize
 		unused_memory_size() const;
 
+		/**
+		 * @brief      A saved position of the arena head
+		 */
+		struct Marker
+		{
+			internal::Arena_Node* node;
+			byte* alloc_head;
+			usize used_size;
+		};
+
+		/**
+		 * @return     A marker of the current arena head
+		 */
+		API_CPPR Marker
+		marker() const;
+
+		/**
+		 * @brief      Frees all the memory allocated after the given marker
+		 * Memory blocks the arena has grown since the marker are returned to its memory context
+		 *
+		 * @param[in]  value  The marker to roll back to
+		 */
+		API_CPPR void
+		rollback(const Marker& value);
+
+		/**
+		 * @brief      Implicit cast operator to Allocator Trait
+		 */
+		inline
+		operator Allocator_Trait*()
+		{
+			return &_allocator_trait;
+		}
+
+		/**
+		 * @brief      Allocates the given count of values
+		 *
+		 * @param[in]  count      The count of values to allocate
+		 * @param[in]  alignment  The alignment of the memory block in bytes, should be a power of 2
+		 *
+		 * @tparam     T          The type of the values
+		 *
+		 * @return     An Owner pointer to the underlying memory block
+		 */
+		template<typename T>
+		Owner<T>
+		alloc(usize count = 1, usize alignment = alignof(T))
+		{
+			return _allocator_trait.template alloc<T>(count, alignment);
+		}
+
+		/**
+		 * @brief      Frees the underlying memory of the given owner pointer
+		 *
+		 * @param      value  The owner pointer to free
+		 *
+		 * @tparam     T      The Type of the values
+		 */
+		template<typename T>
+		void
+		free(Owner<T>& data)
+		{
+			_allocator_trait.template free<T>(data);
+		}
+
+		/**
+		 * @brief      Frees the underlying memory of the given owner pointer
+		 *
+		 * @param      value  The owner pointer to free
+		 *
+		 * @tparam     T      The Type of the values
+		 */
+		template<typename T>
+		void
+		free(Owner<T>&& data)
+		{
+			_allocator_trait.template free<T>(data);
+		}
+
+		/**
+		 * @brief Allocates and invokes the constructor of the allocated elements
+		 * 
+		 * @tparam T Type of the values to allocate
+		 * @tparam TArgs Types of the values to be passed to the constructor
+		 * @param count The number of values to allocate
+		 * @param args The arguments that will be passed to the constructor
+		 * @return Owner<T> The result memory
+		 */
+		template<typename T, typename ... TArgs>
+		Owner<T>
+		construct(usize count, TArgs&& ... args)
+		{
+			return _allocator_trait.construct<T>(count, std::forward<TArgs>(args)...);
+		}
+
+		/**
+		 * @brief Invokes the destructor of the values then frees the memory
+		 * 
+		 * @tparam T Type of the values in the memory
+		 * @param value Owner of the memory to be destructed
+		 */
+		template<typename T>
+		void
+		destruct(Owner<T>& value)
+		{
+			return _allocator_trait.destruct(value);
+		}
+
+		/**
+		 * @brief Invokes the destructor of the values then frees the memory
+		 * 
+		 * @tparam T Type of the values in the memory
+		 * @param value Owner of the memory to be destructed
+		 */
+		template<typename T>
+		void
+		destruct(Owner<T>&& value)
+		{
+			return _allocator_trait.destruct(value);
+		}
+	};
+
+	namespace internal
+	{
+		struct Concurrent_Arena_Node
+		{
+			Owner<byte> memory;
+			std::atomic<usize> cursor;
+			Concurrent_Arena_Node* next_node;
+		};
+	}
+
+	/**
+	 * @brief      A thread safe growable arena allocator
+	 * Allocation is an atomic fetch-add on the cursor of the current block and a new block is installed
+	 * with a compare and swap, so it's safe to allocate from multiple threads (e.g. Loom workers) at once.
+	 * The memory context must be thread safe as well, reset and free_all must not overlap with allocations
+	 */
+	struct Concurrent_Arena_Allocator
+	{
+		/**
+		 * The alignment of every allocation, bigger alignments are padded
+		 */
+		constexpr static usize ALIGN_SIZE = 16;
+
+		Allocator_Trait _allocator_trait;
+		/**
+		 * Memory context used by the arena allocator
+		 */
+		Allocator_Trait* _allocator;
+		std::atomic<internal::Concurrent_Arena_Node*> _head;
+		usize block_size;
+
+		/**
+		 * @brief      Creates a concurrent arena allocator
+		 *
+		 * @param[in]  context  The thread safe memory context used by the arena allocator
+		 */
+		API_CPPR Concurrent_Arena_Allocator(Allocator_Trait* context = allocator());
+
+		/**
+		 * @brief      Creates a concurrent arena allocator
+		 *
+		 * @param[in]  block_size  The memory block size unit of the arena in bytes
+		 * @param[in]  context     The thread safe memory context used by the arena allocator
+		 */
+		API_CPPR Concurrent_Arena_Allocator(usize block_size, Allocator_Trait* context = allocator());
+
+		/**
+		 * @brief      Copy Constructor is deleted
+		 */
+		Concurrent_Arena_Allocator(const Concurrent_Arena_Allocator& other) = delete;
+
+		/**
+		 * @brief      Copy assignment operator is deleted
+		 */
+		Concurrent_Arena_Allocator&
+		operator=(const Concurrent_Arena_Allocator& other) = delete;
+
+		/**
+		 * @brief      Move Constructor, it's not thread safe
+		 *
+		 * @param[in]  other   The other arena allocator to move
+		 */
+		API_CPPR Concurrent_Arena_Allocator(Concurrent_Arena_Allocator&& other);
+
+		/**
+		 * @brief    Move assignment operator, it's not thread safe
+		 * 
+		 * @param[in]  other   The other arena allocator to move
+		 */
+		API_CPPR Concurrent_Arena_Allocator&
+		operator=(Concurrent_Arena_Allocator&& other);
+
+		/**
+		 * @brief      Destroys the arena allocator.
+		 */
+		API_CPPR ~Concurrent_Arena_Allocator();
+
+		/**
+		 * @brief      Frees all the memory blocks of the arena
+		 */
+		API_CPPR void
+		reset();
+
+		/**
+		 * @brief      Frees all the allocated memory at once but keeps the most recent memory block for reuse
+		 */
+		API_CPPR void
+		free_all();
+
+		/**
+		 * @return     The size of the used arena memory in bytes including the alignment padding
+		 * and the tails of the full blocks which were too small for an allocation,
+		 * it's computed from the blocks cursors so it walks the blocks list
+		 */
+		API_CPPR usize
+		used_memory_size() const;
+
+		/**
+		 * @return     The size of the unused arena memory in bytes, it walks the blocks list
+		 */
+		API_CPPR usize
+		unused_memory_size() const;
+
 		/**
 		 * @brief      Implicit cast operator to Allocator Trait
 		 */
@@ -313,6 +564,7 @@ namespace cppr
 		 * @brief      Allocates the given count of values
 		 *
 		 * @param[in]  count      The count of values to allocate
+		 * @param[in]  alignment  The alignment of the memory block in bytes, should be a power of 2
 		 *
 		 * @tparam     T          The type of the values
 		 *
@@ -320,9 +572,9 @@ namespace cppr
 		 */
 		template<typename T>
 		Owner<T>
-		alloc(usize count = 1)
+		alloc(usize count = 1, usize alignment = alignof(T))
 		{
-			return _allocator_trait.template alloc<T>(count);
+			return _allocator_trait.template alloc<T>(count, alignment);
 		}
 
 		/**
@@ -395,4 +647,680 @@ namespace cppr
 			return _allocator_trait.destruct(value);
 		}
 	};
+
+	/**
+	 * @brief      An arena allocator backed by a single reserved virtual address range
+	 * The address range is reserved once and pages are committed on demand, so the arena
+	 * is contiguous and the allocated pointers are stable for the lifetime of the arena
+	 */
+	struct Virtual_Arena_Allocator
+	{
+		Allocator_Trait _allocator_trait;
+		Owner<byte> _memory;
+		byte *_alloc_head, *_commit_head;
+		/**
+		 * The minimum size of memory committed at once in bytes, it's rounded up to the page size
+		 * or to the huge page size with `HUGE_PAGES`
+		 */
+		usize commit_size;
+		/**
+		 * The size of committed memory in bytes that's kept on reset, committed memory
+		 * beyond this mark is decommitted and returned to the OS, it's rounded up like the `commit_size`
+		 */
+		usize high_water_mark;
+		/**
+		 * The virtual memory flags, `HUGE_PAGES` backs the arena with huge pages and
+		 * `POPULATE` pre-faults the memory as soon as it's committed
+		 */
+		VIRTUAL_FLAGS flags;
+
+		/**
+		 * @brief      Creates a virtual arena allocator
+		 *
+		 * @param[in]  reserve_size     The size of the reserved virtual address range in bytes
+		 * @param[in]  commit_size      The minimum size of memory committed at once in bytes
+		 * @param[in]  high_water_mark  The size of committed memory in bytes that's kept on reset
+		 * @param[in]  flags            The virtual memory flags
+		 */
+		API_CPPR Virtual_Arena_Allocator(usize reserve_size = GIGABYTES(1),
+										 usize commit_size = KILOBYTES(64),
+										 usize high_water_mark = MEGABYTES(1),
+										 VIRTUAL_FLAGS flags = VIRTUAL_FLAGS::NONE);
+
+		/**
+		 * @brief      Copy Constructor is deleted
+		 */
+		Virtual_Arena_Allocator(const Virtual_Arena_Allocator& other) = delete;
+
+		/**
+		 * @brief      Copy assignment operator is deleted
+		 */
+		Virtual_Arena_Allocator&
+		operator=(const Virtual_Arena_Allocator& other) = delete;
+
+		/**
+		 * @brief      Move Constructor
+		 *
+		 * @param[in]  other   The other virtual arena allocator to move
+		 */
+		API_CPPR Virtual_Arena_Allocator(Virtual_Arena_Allocator&& other);
+
+		/**
+		 * @brief    Move assignment operator
+		 * 
+		 * @param[in]  other   The other virtual arena allocator to move
+		 */
+		API_CPPR Virtual_Arena_Allocator&
+		operator=(Virtual_Arena_Allocator&& other);
+
+		/**
+		 * @brief      Destroys the virtual arena allocator and releases its address range
+		 */
+		API_CPPR ~Virtual_Arena_Allocator();
+
+		/**
+		 * @brief      Commits memory so that at least the given size is available for allocation
+		 *
+		 * @param[in]  grow_size  The size needed in bytes
+		 *
+		 * @return     True if succeeded, false if the reserved address range is exhausted
+		 */
+		API_CPPR bool
+		grow(usize grow_size);
+
+		/**
+		 * @brief      Frees all the allocated memory and decommits the memory beyond the high water mark
+		 */
+		API_CPPR void
+		reset();
+
+		/**
+		 * @return     The size of the used arena memory in bytes
+		 */
+		API_CPPR usize
+		used_memory_size() const;
+
+		/**
+		 * @return     The size of the committed but unused arena memory in bytes
+		 */
+		API_CPPR usize
+		unused_memory_size() const;
+
+		/**
+		 * @return     The size of the committed arena memory in bytes
+		 */
+		API_CPPR usize
+		committed_memory_size() const;
+
+		/**
+		 * @return     The size of the reserved address range in bytes
+		 */
+		API_CPPR usize
+		reserved_memory_size() const;
+
+		/**
+		 * @brief      A saved position of the arena head
+		 */
+		struct Marker
+		{
+			byte* alloc_head;
+		};
+
+		/**
+		 * @return     A marker of the current arena head
+		 */
+		API_CPPR Marker
+		marker() const;
+
+		/**
+		 * @brief      Frees all the memory allocated after the given marker in O(1)
+		 * The committed memory is kept as is
+		 *
+		 * @param[in]  value  The marker to roll back to
+		 */
+		API_CPPR void
+		rollback(const Marker& value);
+
+		/**
+		 * @brief      Implicit cast operator to Allocator Trait
+		 */
+		inline
+		operator Allocator_Trait*()
+		{
+			return &_allocator_trait;
+		}
+
+		/**
+		 * @brief      Allocates the given count of values
+		 *
+		 * @param[in]  count      The count of values to allocate
+		 * @param[in]  alignment  The alignment of the memory block in bytes, should be a power of 2
+		 *
+		 * @tparam     T          The type of the values
+		 *
+		 * @return     An Owner pointer to the underlying memory block
+		 */
+		template<typename T>
+		Owner<T>
+		alloc(usize count = 1, usize alignment = alignof(T))
+		{
+			return _allocator_trait.template alloc<T>(count, alignment);
+		}
+
+		/**
+		 * @brief      Frees the underlying memory of the given owner pointer
+		 *
+		 * @param      value  The owner pointer to free
+		 *
+		 * @tparam     T      The Type of the values
+		 */
+		template<typename T>
+		void
+		free(Owner<T>& data)
+		{
+			_allocator_trait.template free<T>(data);
+		}
+
+		/**
+		 * @brief      Frees the underlying memory of the given owner pointer
+		 *
+		 * @param      value  The owner pointer to free
+		 *
+		 * @tparam     T      The Type of the values
+		 */
+		template<typename T>
+		void
+		free(Owner<T>&& data)
+		{
+			_allocator_trait.template free<T>(data);
+		}
+
+		/**
+		 * @brief Allocates and invokes the constructor of the allocated elements
+		 * 
+		 * @tparam T Type of the values to allocate
+		 * @tparam TArgs Types of the values to be passed to the constructor
+		 * @param count The number of values to allocate
+		 * @param args The arguments that will be passed to the constructor
+		 * @return Owner<T> The result memory
+		 */
+		template<typename T, typename ... TArgs>
+		Owner<T>
+		construct(usize count, TArgs&& ... args)
+		{
+			return _allocator_trait.construct<T>(count, std::forward<TArgs>(args)...);
+		}
+
+		/**
+		 * @brief Invokes the destructor of the values then frees the memory
+		 * 
+		 * @tparam T Type of the values in the memory
+		 * @param value Owner of the memory to be destructed
+		 */
+		template<typename T>
+		void
+		destruct(Owner<T>& value)
+		{
+			return _allocator_trait.destruct(value);
+		}
+
+		/**
+		 * @brief Invokes the destructor of the values then frees the memory
+		 * 
+		 * @tparam T Type of the values in the memory
+		 * @param value Owner of the memory to be destructed
+		 */
+		template<typename T>
+		void
+		destruct(Owner<T>&& value)
+		{
+			return _allocator_trait.destruct(value);
+		}
+	};
+
+	namespace internal
+	{
+		struct TLSF_Block
+		{
+			/**
+			 * The physically previous block in memory
+			 */
+			TLSF_Block* prev_physical;
+			/**
+			 * The size of the block payload in bytes, the lowest 2 bits are used as flags
+			 */
+			usize size;
+			/**
+			 * The free list links which overlap with the payload so they're only valid in free blocks
+			 */
+			TLSF_Block *next_free, *prev_free;
+		};
+	}
+
+	/**
+	 * @brief      A Two-Level Segregated Fit allocator with O(1) bounded alloc and free
+	 * It manages a single memory pool, free blocks are indexed by a two level size class
+	 * bitmap and adjacent free blocks are coalesced immediately on free
+	 */
+	struct TLSF_Allocator
+	{
+		/**
+		 * The log2 of the count of second level size classes per first level class
+		 */
+		constexpr static usize SL_INDEX_COUNT_LOG2 = 5;
+		constexpr static usize SL_INDEX_COUNT = 1 << SL_INDEX_COUNT_LOG2;
+		/**
+		 * The log2 of the alignment of all the block payloads
+		 */
+		constexpr static usize ALIGN_SIZE_LOG2 = 4;
+		constexpr static usize ALIGN_SIZE = 1 << ALIGN_SIZE_LOG2;
+		/**
+		 * Blocks smaller than this size are linearly split into second level classes
+		 */
+		constexpr static usize FL_INDEX_SHIFT = SL_INDEX_COUNT_LOG2 + ALIGN_SIZE_LOG2;
+		constexpr static usize SMALL_BLOCK_SIZE = 1 << FL_INDEX_SHIFT;
+		/**
+		 * The log2 of the maximum supported block size
+		 */
+		constexpr static usize FL_INDEX_MAX = 40;
+		constexpr static usize FL_INDEX_COUNT = FL_INDEX_MAX - FL_INDEX_SHIFT + 1;
+
+		Allocator_Trait _allocator_trait;
+		/**
+		 * Memory context used to allocate the pool memory
+		 */
+		Allocator_Trait* _allocator;
+		Owner<byte> _memory;
+		u32 _fl_bitmap;
+		u32 _sl_bitmap[FL_INDEX_COUNT];
+		internal::TLSF_Block* _blocks[FL_INDEX_COUNT][SL_INDEX_COUNT];
+		usize _used_size, _free_size;
+
+		/**
+		 * @brief      Creates a tlsf allocator with no memory
+		 *
+		 * @param[in]  context  The memory context used to init the pool memory
+		 */
+		API_CPPR TLSF_Allocator(Allocator_Trait* context = allocator());
+
+		/**
+		 * @brief      Creates a tlsf allocator
+		 *
+		 * @param[in]  pool_size  The pool size in bytes
+		 * @param[in]  context    The memory context used to init the pool memory i.e. `os->virtual_memory`
+		 */
+		API_CPPR TLSF_Allocator(usize pool_size, Allocator_Trait* context = allocator());
+
+		/**
+		 * @brief      Creates a tlsf allocator which manages the given memory
+		 *
+		 * @param[in]  memory   The pool memory, it's freed on destruction using the given context
+		 * @param[in]  context  The memory context the pool memory was allocated from
+		 */
+		API_CPPR TLSF_Allocator(Owner<byte>&& memory, Allocator_Trait* context);
+
+		/**
+		 * Copy Constructor is deleted
+		 */
+		TLSF_Allocator(const TLSF_Allocator&) = delete;
+
+		/**
+		 * @brief      Copy Assignment operator is deleted
+		 */
+		TLSF_Allocator&
+		operator=(const TLSF_Allocator&) = delete;
+
+		/**
+		 * @brief      Move constructor
+		 *
+		 * @param[in]  other  The other tlsf allocator to move from
+		 */
+		API_CPPR TLSF_Allocator(TLSF_Allocator&& other);
+
+		/**
+		 * @brief      Move Assignment operator
+		 * 
+		 * @param[in]  other  The other tlsf allocator to move from
+		 */
+		API_CPPR TLSF_Allocator&
+		operator=(TLSF_Allocator&& other);
+
+		/**
+		 * @brief      Destroys the tlsf allocator.
+		 */
+		API_CPPR ~TLSF_Allocator();
+
+		/**
+		 * @brief      Initializes the pool memory
+		 *
+		 * @param[in]  pool_size  The pool size in bytes
+		 */
+		API_CPPR void
+		init(usize pool_size);
+
+		/**
+		 * @brief      Initializes the allocator to manage the given memory
+		 *
+		 * @param[in]  memory  The pool memory, it's freed on destruction using the memory context
+		 */
+		API_CPPR void
+		init(Owner<byte>&& memory);
+
+		/**
+		 * @brief      Frees the pool memory
+		 */
+		API_CPPR void
+		reset();
+
+		/**
+		 * @brief      Frees all the allocated blocks at once
+		 */
+		API_CPPR void
+		free_all();
+
+		/**
+		 * @return     The size of the allocated blocks in bytes
+		 */
+		API_CPPR usize
+		used_memory_size() const;
+
+		/**
+		 * @return     The size of the free blocks in bytes
+		 */
+		API_CPPR usize
+		unused_memory_size() const;
+
+		/**
+		 * @return     The size of the largest free block in bytes which is the largest possible allocation
+		 */
+		API_CPPR usize
+		largest_free_block_size() const;
+
+		/**
+		 * @return     The external fragmentation ratio in the range [0, 1] which is
+		 * computed as `1 - largest_free_block_size / unused_memory_size`
+		 */
+		API_CPPR r64
+		fragmentation() const;
+
+		/**
+		 * @brief      Implicit cast operator to Allocator Trait
+		 */
+		inline
+		operator Allocator_Trait*()
+		{
+			return &_allocator_trait;
+		}
+
+		/**
+		 * @brief      Allocates the given count of values
+		 *
+		 * @param[in]  count      The count of values to allocate
+		 * @param[in]  alignment  The alignment of the memory block in bytes, should be a power of 2
+		 *
+		 * @tparam     T          The type of the values
+		 *
+		 * @return     An Owner pointer to the underlying memory block
+		 */
+		template<typename T>
+		Owner<T>
+		alloc(usize count = 1, usize alignment = alignof(T))
+		{
+			return _allocator_trait.template alloc<T>(count, alignment);
+		}
+
+		/**
+		 * @brief      Frees the underlying memory of the given owner pointer
+		 *
+		 * @param      value  The owner pointer to free
+		 *
+		 * @tparam     T      The Type of the values
+		 */
+		template<typename T>
+		void
+		free(Owner<T>& data)
+		{
+			_allocator_trait.template free<T>(data);
+		}
+
+		/**
+		 * @brief      Frees the underlying memory of the given owner pointer
+		 *
+		 * @param      value  The owner pointer to free
+		 *
+		 * @tparam     T      The Type of the values
+		 */
+		template<typename T>
+		void
+		free(Owner<T>&& data)
+		{
+			_allocator_trait.template free<T>(data);
+		}
+
+		/**
+		 * @brief Allocates and invokes the constructor of the allocated elements
+		 * 
+		 * @tparam T Type of the values to allocate
+		 * @tparam TArgs Types of the values to be passed to the constructor
+		 * @param count The number of values to allocate
+		 * @param args The arguments that will be passed to the constructor
+		 * @return Owner<T> The result memory
+		 */
+		template<typename T, typename ... TArgs>
+		Owner<T>
+		construct(usize count, TArgs&& ... args)
+		{
+			return _allocator_trait.construct<T>(count, std::forward<TArgs>(args)...);
+		}
+
+		/**
+		 * @brief Invokes the destructor of the values then frees the memory
+		 * 
+		 * @tparam T Type of the values in the memory
+		 * @param value Owner of the memory to be destructed
+		 */
+		template<typename T>
+		void
+		destruct(Owner<T>& value)
+		{
+			return _allocator_trait.destruct(value);
+		}
+
+		/**
+		 * @brief Invokes the destructor of the values then frees the memory
+		 * 
+		 * @tparam T Type of the values in the memory
+		 * @param value Owner of the memory to be destructed
+		 */
+		template<typename T>
+		void
+		destruct(Owner<T>&& value)
+		{
+			return _allocator_trait.destruct(value);
+		}
+	};
+
+	/**
+	 * @brief      An allocator which records the allocation statistics of another allocator
+	 */
+	struct Instrumented_Allocator
+	{
+		Allocator_Trait _allocator_trait;
+		/**
+		 * Memory context which the allocations are forwarded to
+		 */
+		Allocator_Trait* _allocator;
+		/**
+		 * The allocation statistics
+		 */
+		Allocator_Stats stats;
+
+		/**
+		 * @brief      Creates an instrumented allocator
+		 *
+		 * @param[in]  context  The memory context which the allocations are forwarded to
+		 */
+		API_CPPR Instrumented_Allocator(Allocator_Trait* context = allocator());
+
+		/**
+		 * @brief      Copy Constructor is deleted
+		 */
+		Instrumented_Allocator(const Instrumented_Allocator&) = delete;
+
+		/**
+		 * @brief      Copy assignment operator is deleted
+		 */
+		Instrumented_Allocator&
+		operator=(const Instrumented_Allocator&) = delete;
+
+		/**
+		 * @brief      Implicit cast operator to Allocator Trait
+		 */
+		inline
+		operator Allocator_Trait*()
+		{
+			return &_allocator_trait;
+		}
+
+		/**
+		 * @brief      Allocates the given count of values
+		 *
+		 * @param[in]  count      The count of values to allocate
+		 * @param[in]  alignment  The alignment of the memory block in bytes, should be a power of 2
+		 *
+		 * @tparam     T          The type of the values
+		 *
+		 * @return     An Owner pointer to the underlying memory block
+		 */
+		template<typename T>
+		CPPR_FORCE_INLINE Owner<T>
+		alloc(usize count = 1, usize alignment = alignof(T))
+		{
+			return _allocator_trait.template alloc<T>(count, alignment);
+		}
+
+		/**
+		 * @brief      Frees the underlying memory of the given owner pointer
+		 *
+		 * @param      value  The owner pointer to free
+		 *
+		 * @tparam     T      The Type of the values
+		 */
+		template<typename T>
+		void
+		free(Owner<T>& data)
+		{
+			_allocator_trait.template free<T>(data);
+		}
+
+		/**
+		 * @brief      Frees the underlying memory of the given owner pointer
+		 *
+		 * @param      value  The owner pointer to free
+		 *
+		 * @tparam     T      The Type of the values
+		 */
+		template<typename T>
+		void
+		free(Owner<T>&& data)
+		{
+			_allocator_trait.template free<T>(data);
+		}
+
+		/**
+		 * @brief Allocates and invokes the constructor of the allocated elements
+		 * 
+		 * @tparam T Type of the values to allocate
+		 * @tparam TArgs Types of the values to be passed to the constructor
+		 * @param count The number of values to allocate
+		 * @param args The arguments that will be passed to the constructor
+		 * @return Owner<T> The result memory
+		 */
+		template<typename T, typename ... TArgs>
+		Owner<T>
+		construct(usize count, TArgs&& ... args)
+		{
+			return _allocator_trait.construct<T>(count, std::forward<TArgs>(args)...);
+		}
+
+		/**
+		 * @brief Invokes the destructor of the values then frees the memory
+		 * 
+		 * @tparam T Type of the values in the memory
+		 * @param value Owner of the memory to be destructed
+		 */
+		template<typename T>
+		void
+		destruct(Owner<T>& value)
+		{
+			return _allocator_trait.destruct(value);
+		}
+
+		/**
+		 * @brief Invokes the destructor of the values then frees the memory
+		 * 
+		 * @tparam T Type of the values in the memory
+		 * @param value Owner of the memory to be destructed
+		 */
+		template<typename T>
+		void
+		destruct(Owner<T>&& value)
+		{
+			return _allocator_trait.destruct(value);
+		}
+	};
+
+	/**
+	 * @brief      Prints the allocator statistics including the size histogram and the top call sites
+	 *
+	 * @param      trait   The IO_Trait to print to
+	 * @param[in]  format  The format style which is ignored
+	 * @param[in]  stats   The allocator statistics to print
+	 *
+	 * @return     The size of the printed string in bytes
+	 */
+	API_CPPR usize
+	print_str(IO_Trait* trait, const Print_Format& format, const Allocator_Stats& stats);
+
+	/**
+	 * @brief      A scope guard which saves the allocator head on construction
+	 * and rolls back to it on destruction
+	 *
+	 * @tparam     TAllocator  The allocator type which should provide a `Marker`, `marker()` and `rollback()`
+	 */
+	template<typename TAllocator>
+	struct Marker_Scope
+	{
+		TAllocator& allocator;
+		typename TAllocator::Marker marker;
+
+		/**
+		 * @brief      Saves the current head of the given allocator
+		 *
+		 * @param      value  The allocator to guard
+		 */
+		Marker_Scope(TAllocator& value)
+			:allocator(value),
+			 marker(value.marker())
+		{}
+
+		/**
+		 * @brief      Copy Constructor is deleted
+		 */
+		Marker_Scope(const Marker_Scope&) = delete;
+
+		/**
+		 * @brief      Copy assignment operator is deleted
+		 */
+		Marker_Scope&
+		operator=(const Marker_Scope&) = delete;
+
+		/**
+		 * @brief      Rolls the allocator back to the saved marker
+		 */
+		~Marker_Scope()
+		{
+			allocator.rollback(marker);
+		}
+	};
 }
\ No newline at end of file
@@ -0,0 +1,1254 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/defaults.h"
+#include "cpprelude/Ranges.h"
+#include "cpprelude/Tree_Map.h"
+#include <type_traits>
+#include <utility>
+#include <new>
+#include <cstring>
+
+namespace cppr
+{
+	namespace internal
+	{
+		//the byte size the B-Tree nodes are fitted into, it's 4 cache lines
+		constexpr usize B_TREE_NODE_SIZE = 256;
+		//every node is at least half full so the tree can't get this tall in a 64-bit address space
+		constexpr usize B_TREE_MAX_HEIGHT = 64;
+
+		constexpr usize
+		_b_tree_capacity(usize header_size, usize item_size)
+		{
+			return (B_TREE_NODE_SIZE - header_size) / item_size < 4 ? 4 : (B_TREE_NODE_SIZE - header_size) / item_size;
+		}
+
+		template<typename TKey, typename TValue>
+		struct B_Tree_Leaf
+		{
+			using Data_Type = Pair_Node<const TKey, TValue>;
+			using Pair_Type = Pair_Node<TKey, TValue>;
+
+			constexpr static usize CAPACITY = _b_tree_capacity(sizeof(void*) * 2 + sizeof(usize), sizeof(Pair_Type));
+
+			B_Tree_Leaf *prev, *next;
+			usize count;
+			alignas(Pair_Type) byte _pairs[CAPACITY * sizeof(Pair_Type)];
+
+			Pair_Type*
+			pairs()
+			{
+				return reinterpret_cast<Pair_Type*>(_pairs);
+			}
+
+			const Pair_Type*
+			pairs() const
+			{
+				return reinterpret_cast<const Pair_Type*>(_pairs);
+			}
+
+			Data_Type&
+			data(usize index)
+			{
+				return reinterpret_cast<Data_Type&>(pairs()[index]);
+			}
+
+			const Data_Type&
+			data(usize index) const
+			{
+				return reinterpret_cast<const Data_Type&>(pairs()[index]);
+			}
+		};
+
+		template<typename TKey>
+		struct B_Tree_Inner
+		{
+			constexpr static usize CAPACITY = _b_tree_capacity(sizeof(usize) + sizeof(void*), sizeof(TKey) + sizeof(void*));
+
+			usize count;
+			//the keys are kept contiguous so the node search walks a packed array
+			alignas(TKey) byte _keys[CAPACITY * sizeof(TKey)];
+			void* children[CAPACITY + 1];
+
+			TKey*
+			keys()
+			{
+				return reinterpret_cast<TKey*>(_keys);
+			}
+
+			const TKey*
+			keys() const
+			{
+				return reinterpret_cast<const TKey*>(_keys);
+			}
+		};
+
+		//count of the node keys which are less than the key
+		//for arithmetic keys it's a branchless count which the compiler turns into SIMD compares
+		//for the rest it's a binary search since each compare could be expensive
+		template<typename TKey, typename TCompare, typename TKeyAt>
+		inline static usize
+		_b_tree_count_less(usize count, const TKey& key, const TCompare& less_than, TKeyAt&& key_at)
+		{
+			if(std::is_arithmetic<TKey>::value || std::is_pointer<TKey>::value)
+			{
+				usize result = 0;
+				for(usize i = 0; i < count; ++i)
+					result += less_than(key_at(i), key);
+				return result;
+			}
+
+			usize low = 0, high = count;
+			while(low < high)
+			{
+				usize mid = (low + high) / 2;
+				if(less_than(key_at(mid), key))
+					low = mid + 1;
+				else
+					high = mid;
+			}
+			return low;
+		}
+
+		//count of the node keys which are less than or equal to the key
+		template<typename TKey, typename TCompare, typename TKeyAt>
+		inline static usize
+		_b_tree_count_less_equal(usize count, const TKey& key, const TCompare& less_than, TKeyAt&& key_at)
+		{
+			if(std::is_arithmetic<TKey>::value || std::is_pointer<TKey>::value)
+			{
+				usize result = 0;
+				for(usize i = 0; i < count; ++i)
+					result += !less_than(key, key_at(i));
+				return result;
+			}
+
+			usize low = 0, high = count;
+			while(low < high)
+			{
+				usize mid = (low + high) / 2;
+				if(!less_than(key, key_at(mid)))
+					low = mid + 1;
+				else
+					high = mid;
+			}
+			return low;
+		}
+
+		//moves the values from src into dst and destroys the src values
+		//the two ranges may overlap if dst comes before src
+		template<typename T>
+		inline static void
+		_b_tree_move(T* dst, T* src, usize count)
+		{
+			for(usize i = 0; i < count; ++i)
+			{
+				::new (dst + i) T(std::move(src[i]));
+				src[i].~T();
+			}
+		}
+
+		//same as above but the two ranges may overlap if dst comes after src
+		template<typename T>
+		inline static void
+		_b_tree_move_backward(T* dst, T* src, usize count)
+		{
+			for(usize i = count; i > 0; --i)
+			{
+				::new (dst + i - 1) T(std::move(src[i - 1]));
+				src[i - 1].~T();
+			}
+		}
+
+		//replaces the value by destroying it and constructing the new one in its place
+		//it doesn't depend on the assignment operators of the type so it behaves exactly like the node moves above
+		template<typename T, typename TArg>
+		inline static void
+		_b_tree_replace(T* dst, TArg&& value)
+		{
+			dst->~T();
+			::new (dst) T(std::forward<TArg>(value));
+		}
+	}
+
+	/**
+	 * [[markdown]]
+	 * #B_Tree_Map
+	 * An ordered map with the same interface as the Tree_Map but the pairs are stored in wide nodes
+	 * which are sized to a few cache lines instead of a node per pair.
+	 * It's a B+ Tree, the pairs live in the leaves which are linked in order, and the inner nodes
+	 * hold a packed array of the separator keys so each level is a single search in a node instead of a pointer chase.
+	 * The pairs move inside the leaves on insertion and removal so any insertion or removal invalidates the iterators.
+	 */
+
+	/**
+	 * @brief      A Generic B-Tree Map
+	 *
+	 * @tparam     TKey      Key type of pairs in the map
+	 * @tparam     TValue    Value type of pairs in the map
+	 * @tparam     TCompare  Compare function used on the keys
+	 */
+	template<typename TKey, typename TValue,
+			 typename TCompare = Default_Less_Than<TKey>>
+	struct B_Tree_Map
+	{
+		using Key_Type = TKey;
+		using Value_Type = TValue;
+		using Leaf_Type = internal::B_Tree_Leaf<TKey, TValue>;
+		using Inner_Type = internal::B_Tree_Inner<TKey>;
+		using Pair_Type = typename Leaf_Type::Pair_Type;
+		/**
+		 * Data Type of the map
+		 */
+		using Data_Type = typename Leaf_Type::Data_Type;
+		/**
+		 * Range Type of the map
+		 */
+		using Range_Type = B_Tree_Range<Leaf_Type>;
+		/**
+		 * Const Range Type of the map
+		 */
+		using Const_Range_Type = B_Tree_Range<const Leaf_Type>;
+		/**
+		 * Iterator type of the map
+		 */
+		using iterator = B_Tree_Iterator<Leaf_Type>;
+		/**
+		 * Const iterator type of the map
+		 */
+		using const_iterator = B_Tree_Iterator<const Leaf_Type>;
+
+		constexpr static usize LEAF_MIN = Leaf_Type::CAPACITY / 2;
+		constexpr static usize INNER_MIN = Inner_Type::CAPACITY / 2;
+
+		void* _root;
+		//count of the inner levels above the leaves
+		usize _height;
+		usize _count;
+		Leaf_Type *_first, *_last;
+		Allocator_Trait* _allocator;
+		TCompare _less_than;
+
+		/**
+		 * @brief      Constructs a map
+		 *
+		 * @param[in]  context  The memory context to use for memory allocation and freeing
+		 */
+		B_Tree_Map(Allocator_Trait* context = allocator())
+			:_root(nullptr), _height(0), _count(0),
+			 _first(nullptr), _last(nullptr), _allocator(context)
+		{}
+
+		/**
+		 * @brief      Constructs a map
+		 *
+		 * @param[in]  compare_function  The compare function
+		 * @param[in]  context           The memory context
+		 */
+		B_Tree_Map(const TCompare& compare_function,
+				   Allocator_Trait* context = allocator())
+			:_root(nullptr), _height(0), _count(0),
+			 _first(nullptr), _last(nullptr), _allocator(context),
+			 _less_than(compare_function)
+		{}
+
+		/**
+		 * @brief      Constructs a map with the provided list
+		 *
+		 * @param[in]  list              The initializer list to fill the map with
+		 * @param[in]  compare_function  The compare function
+		 * @param[in]  context           The memory context
+		 */
+		B_Tree_Map(std::initializer_list<Data_Type> list,
+				   const TCompare& compare_function = TCompare(),
+				   Allocator_Trait* context = allocator())
+			:_root(nullptr), _height(0), _count(0),
+			 _first(nullptr), _last(nullptr), _allocator(context),
+			 _less_than(compare_function)
+		{
+			for(const auto& pair: list)
+				_emplace(pair.key, pair.value);
+		}
+
+		/**
+		 * @brief      Copy Constructor
+		 *
+		 * @param[in]  other  The other map to copy from
+		 */
+		B_Tree_Map(const B_Tree_Map& other)
+			:_root(nullptr), _height(0), _count(0),
+			 _first(nullptr), _last(nullptr), _allocator(other._allocator),
+			 _less_than(other._less_than)
+		{
+			_copy_content(other);
+		}
+
+		/**
+		 * @brief      Copy Constructor
+		 *
+		 * @param[in]  other    The other map to copy from
+		 * @param[in]  context  The memory context
+		 */
+		B_Tree_Map(const B_Tree_Map& other,
+				   Allocator_Trait* context)
+			:_root(nullptr), _height(0), _count(0),
+			 _first(nullptr), _last(nullptr), _allocator(context),
+			 _less_than(other._less_than)
+		{
+			_copy_content(other);
+		}
+
+		/**
+		 * @brief      Move Constructor
+		 *
+		 * @param[in]  other  The other map to move from
+		 */
+		B_Tree_Map(B_Tree_Map&& other)
+			:_root(other._root), _height(other._height), _count(other._count),
+			 _first(other._first), _last(other._last),
+			 _allocator(std::move(other._allocator)),
+			 _less_than(std::move(other._less_than))
+		{
+			other._root = nullptr;
+			other._height = 0;
+			other._count = 0;
+			other._first = nullptr;
+			other._last = nullptr;
+		}
+
+		/**
+		 * @brief      Destroys the map
+		 */
+		~B_Tree_Map()
+		{
+			reset();
+		}
+
+		/**
+		 * @brief      Copy Assignment operator
+		 *
+		 * @param[in]  other  The other map to copy from
+		 *
+		 * @return     A Reference to this map
+		 */
+		B_Tree_Map&
+		operator=(const B_Tree_Map& other)
+		{
+			if(this == &other)
+				return *this;
+
+			reset();
+			_allocator = other._allocator;
+			_less_than = other._less_than;
+			_copy_content(other);
+			return *this;
+		}
+
+		/**
+		 * @brief      Move Assignment operator
+		 *
+		 * @param[in]  other  The other map to move from
+		 *
+		 * @return     A Reference to this map
+		 */
+		B_Tree_Map&
+		operator=(B_Tree_Map&& other)
+		{
+			reset();
+			swap(other);
+			return *this;
+		}
+
+		/**
+		 * @brief      Subscript operator
+		 *
+		 * @param[in]  key   The key to search for or insert in the map
+		 *
+		 * @return     A Reference to the associated value of this key
+		 */
+		Value_Type&
+		operator[](const Key_Type& key)
+		{
+			return _emplace(key)->value;
+		}
+
+		/**
+		 * @brief      Subscript operator
+		 *
+		 * @param[in]  key   The key to search for or insert in the map
+		 *
+		 * @return     A Reference to the associated value of this key
+		 */
+		Value_Type&
+		operator[](Key_Type&& key)
+		{
+			return _emplace(std::move(key))->value;
+		}
+
+		/**
+		 * @brief      Inserts a key into the map
+		 *
+		 * @param[in]  key   The key to insert in the map
+		 *
+		 * @return     an iterator to the inserted pair
+		 */
+		iterator
+		insert(const Key_Type& key)
+		{
+			return _emplace(key);
+		}
+
+		/**
+		 * @brief      Inserts a key into the map
+		 *
+		 * @param[in]  key   The key to insert in the map
+		 *
+		 * @return     an iterator to the inserted pair
+		 */
+		iterator
+		insert(Key_Type&& key)
+		{
+			return _emplace(std::move(key));
+		}
+
+		/**
+		 * @brief      Inserts a key value pair into the map
+		 *
+		 * @param[in]  key    The key to insert in the map
+		 * @param[in]  value  The value to insert in the map
+		 *
+		 * @return     an iterator to the inserted pair, if the key exists it's left unchanged
+		 */
+		iterator
+		insert(const Key_Type& key, const Value_Type& value)
+		{
+			return _emplace(key, value);
+		}
+
+		/**
+		 * @brief      Inserts a key value pair into the map
+		 *
+		 * @param[in]  key    The key to insert in the map
+		 * @param[in]  value  The value to insert in the map
+		 *
+		 * @return     an iterator to the inserted pair, if the key exists it's left unchanged
+		 */
+		iterator
+		insert(Key_Type&& key, const Value_Type& value)
+		{
+			return _emplace(std::move(key), value);
+		}
+
+		/**
+		 * @brief      Inserts a key value pair into the map
+		 *
+		 * @param[in]  key    The key to insert in the map
+		 * @param[in]  value  The value to insert in the map
+		 *
+		 * @return     an iterator to the inserted pair, if the key exists it's left unchanged
+		 */
+		iterator
+		insert(const Key_Type& key, Value_Type&& value)
+		{
+			return _emplace(key, std::move(value));
+		}
+
+		/**
+		 * @brief      Inserts a key value pair into the map
+		 *
+		 * @param[in]  key    The key to insert in the map
+		 * @param[in]  value  The value to insert in the map
+		 *
+		 * @return     an iterator to the inserted pair, if the key exists it's left unchanged
+		 */
+		iterator
+		insert(Key_Type&& key, Value_Type&& value)
+		{
+			return _emplace(std::move(key), std::move(value));
+		}
+
+		/**
+		 * @brief      Removes a key from the map
+		 *
+		 * @param[in]  key   The key to be removed
+		 */
+		void
+		remove(const Key_Type& key)
+		{
+			remove(lookup(key));
+		}
+
+		/**
+		 * @brief      Removes a pair from the map
+		 *
+		 * @param[in]  it    An iterator to the pair to be removed
+		 */
+		void
+		remove(iterator it)
+		{
+			remove(const_iterator(it));
+		}
+
+		/**
+		 * @brief      Removes a pair from the map
+		 *
+		 * @param[in]  it    A const iterator to the pair to be removed
+		 */
+		void
+		remove(const_iterator it)
+		{
+			if(it == cend())
+				return;
+
+			Inner_Type* path[internal::B_TREE_MAX_HEIGHT];
+			usize path_index[internal::B_TREE_MAX_HEIGHT];
+			//the keys are unique so descending by the pair key ends up in the iterator leaf
+			Leaf_Type* leaf = _descend(it->key, path, path_index);
+			usize index = it.index;
+
+			Pair_Type* pairs = leaf->pairs();
+			pairs[index].~Pair_Type();
+			internal::_b_tree_move(pairs + index, pairs + index + 1, leaf->count - index - 1);
+			--leaf->count;
+			--_count;
+
+			if(_height == 0)
+			{
+				if(leaf->count == 0)
+				{
+					_free_leaf(leaf);
+					_root = nullptr;
+					_first = nullptr;
+					_last = nullptr;
+				}
+				return;
+			}
+
+			if(leaf->count < LEAF_MIN)
+				_rebalance_leaf(path, path_index, leaf);
+		}
+
+		/**
+		 * @brief      Looks-up a key in the map
+		 *
+		 * @param[in]  key   The key to be looked-up
+		 *
+		 * @return     An iterator the pair if the key exists otherwise it returns iterator to
+		 *             the end of the map
+		 */
+		iterator
+		lookup(const Key_Type& key)
+		{
+			if(_root == nullptr)
+				return end();
+
+			Leaf_Type* leaf = _find_leaf(key);
+			usize index = _leaf_index(leaf, key);
+			if(index < leaf->count && !_less_than(key, leaf->pairs()[index].key))
+				return iterator(leaf, index);
+			return end();
+		}
+
+		/**
+		 * @brief      Looks-up a key in the map
+		 *
+		 * @param[in]  key   The key to be looked-up
+		 *
+		 * @return     A const iterator the pair if the key exists otherwise it returns
+		 *             const iterator to the end of the map
+		 */
+		const_iterator
+		lookup(const Key_Type& key) const
+		{
+			return const_cast<B_Tree_Map*>(this)->lookup(key);
+		}
+
+		/**
+		 * @brief      Clears the values in the map and frees the memory
+		 */
+		void
+		clear()
+		{
+			if(_root != nullptr)
+				_free_subtree(_root, _height);
+			_root = nullptr;
+			_height = 0;
+			_count = 0;
+			_first = nullptr;
+			_last = nullptr;
+		}
+
+		/**
+		 * @brief      Clears the values in the map and frees the memory
+		 */
+		void
+		reset()
+		{
+			clear();
+		}
+
+		/**
+		 * @brief      Swaps two maps
+		 *
+		 * @param      other  The other map to swap with
+		 */
+		void
+		swap(B_Tree_Map& other)
+		{
+			std::swap(_root, other._root);
+			std::swap(_height, other._height);
+			std::swap(_count, other._count);
+			std::swap(_first, other._first);
+			std::swap(_last, other._last);
+			std::swap(_allocator, other._allocator);
+			std::swap(_less_than, other._less_than);
+		}
+
+		/**
+		 * @return     An iterator to the minimum pair of the map
+		 */
+		iterator
+		min()
+		{
+			return iterator(_first, 0);
+		}
+
+		/**
+		 * @return     A const iterator to the minimum pair of the map
+		 */
+		const_iterator
+		min() const
+		{
+			return const_iterator(_first, 0);
+		}
+
+		/**
+		 * @return     An iterator to the maximum pair of the map
+		 */
+		iterator
+		max()
+		{
+			if(_last == nullptr)
+				return end();
+			return iterator(_last, _last->count - 1);
+		}
+
+		/**
+		 * @return     A const iterator to the maximum pair of the map
+		 */
+		const_iterator
+		max() const
+		{
+			if(_last == nullptr)
+				return end();
+			return const_iterator(_last, _last->count - 1);
+		}
+
+		/**
+		 * @return     The count of pairs in the map
+		 */
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		/**
+		 * @return     Whether the map is empty or not
+		 */
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		//Container range interface
+
+		/**
+		 * @return     Range viewing all the pairs in the map
+		 */
+		Range_Type
+		all()
+		{
+			return Range_Type(begin(), end(), _count);
+		}
+
+		/**
+		 * @return     Const Range viewing all the pairs in the map
+		 */
+		Const_Range_Type
+		all() const
+		{
+			return Const_Range_Type(begin(), end(), _count);
+		}
+
+		/**
+		 * @param[in]  start  The start index of the range
+		 * @param[in]  end    The end index of the range
+		 *
+		 * @return     Range viewing the specified pairs in the map
+		 */
+		Range_Type
+		range(usize start, usize end)
+		{
+			return all().range(start, end);
+		}
+
+		/**
+		 * @param[in]  start  The start index of the range
+		 * @param[in]  end    The end index of the range
+		 *
+		 * @return     Const Range viewing the specified pairs in the map
+		 */
+		Const_Range_Type
+		range(usize start, usize end) const
+		{
+			return all().range(start, end);
+		}
+
+		/**
+		 * @return     An Iterator to the beginning of this container
+		 */
+		iterator
+		begin()
+		{
+			return iterator(_first, 0);
+		}
+
+		/**
+		 * @return     A Const iterator to the beginning of this container
+		 */
+		const_iterator
+		begin() const
+		{
+			return const_iterator(_first, 0);
+		}
+
+		/**
+		 * @return     A Const iterator to the beginning of this container
+		 */
+		const_iterator
+		cbegin() const
+		{
+			return const_iterator(_first, 0);
+		}
+
+		/**
+		 * @return     An Iterator to the end of the container
+		 */
+		iterator
+		end()
+		{
+			return iterator(nullptr, 0);
+		}
+
+		/**
+		 * @return     A Const Iterator to the end of the container
+		 */
+		const_iterator
+		end() const
+		{
+			return const_iterator(nullptr, 0);
+		}
+
+		/**
+		 * @return     A Const Iterator to the end of the container
+		 */
+		const_iterator
+		cend() const
+		{
+			return const_iterator(nullptr, 0);
+		}
+
+		bool
+		_is_b_tree() const
+		{
+			if(_root == nullptr)
+				return _count == 0 && _first == nullptr && _last == nullptr;
+
+			const Leaf_Type* prev = nullptr;
+			usize values_count = 0;
+			if(!_check_subtree(_root, _height, nullptr, nullptr, prev, values_count))
+				return false;
+			return prev == _last && _last->next == nullptr && values_count == _count;
+		}
+
+		//Internal functions
+		usize
+		_inner_index(const Inner_Type* node, const Key_Type& key) const
+		{
+			const Key_Type* keys = node->keys();
+			return internal::_b_tree_count_less_equal(node->count, key, _less_than,
+				[keys](usize i) -> const Key_Type& { return keys[i]; });
+		}
+
+		usize
+		_leaf_index(const Leaf_Type* leaf, const Key_Type& key) const
+		{
+			const Pair_Type* pairs = leaf->pairs();
+			return internal::_b_tree_count_less(leaf->count, key, _less_than,
+				[pairs](usize i) -> const Key_Type& { return pairs[i].key; });
+		}
+
+		Leaf_Type*
+		_find_leaf(const Key_Type& key) const
+		{
+			void* node = _root;
+			for(usize level = 0; level < _height; ++level)
+			{
+				Inner_Type* inner = (Inner_Type*)node;
+				node = inner->children[_inner_index(inner, key)];
+			}
+			return (Leaf_Type*)node;
+		}
+
+		//same as above but it records the inner nodes it passes through
+		Leaf_Type*
+		_descend(const Key_Type& key, Inner_Type** path, usize* path_index) const
+		{
+			void* node = _root;
+			for(usize level = 0; level < _height; ++level)
+			{
+				Inner_Type* inner = (Inner_Type*)node;
+				usize index = _inner_index(inner, key);
+				path[level] = inner;
+				path_index[level] = index;
+				node = inner->children[index];
+			}
+			return (Leaf_Type*)node;
+		}
+
+		template<typename TKeyArg, typename ... TArgs>
+		iterator
+		_emplace(TKeyArg&& key, TArgs&& ... args)
+		{
+			if(_root == nullptr)
+			{
+				_first = _create_leaf();
+				_last = _first;
+				_root = _first;
+				_height = 0;
+			}
+
+			Inner_Type* path[internal::B_TREE_MAX_HEIGHT];
+			usize path_index[internal::B_TREE_MAX_HEIGHT];
+			Leaf_Type* leaf = _descend(key, path, path_index);
+
+			usize index = _leaf_index(leaf, key);
+			if(index < leaf->count && !_less_than(key, leaf->pairs()[index].key))
+				return iterator(leaf, index);
+
+			++_count;
+			if(leaf->count < Leaf_Type::CAPACITY)
+			{
+				_leaf_insert(leaf, index, std::forward<TKeyArg>(key), std::forward<TArgs>(args)...);
+				return iterator(leaf, index);
+			}
+
+			//the leaf is full so split it in two halves and insert in the half the key belongs to
+			Leaf_Type* right = _create_leaf();
+			usize split = (Leaf_Type::CAPACITY + 1) / 2;
+			iterator result;
+			if(index < split)
+			{
+				right->count = leaf->count - split + 1;
+				internal::_b_tree_move(right->pairs(), leaf->pairs() + split - 1, right->count);
+				leaf->count = split - 1;
+				_leaf_insert(leaf, index, std::forward<TKeyArg>(key), std::forward<TArgs>(args)...);
+				result = iterator(leaf, index);
+			}
+			else
+			{
+				right->count = leaf->count - split;
+				internal::_b_tree_move(right->pairs(), leaf->pairs() + split, right->count);
+				leaf->count = split;
+				_leaf_insert(right, index - split, std::forward<TKeyArg>(key), std::forward<TArgs>(args)...);
+				result = iterator(right, index - split);
+			}
+
+			right->prev = leaf;
+			right->next = leaf->next;
+			if(leaf->next)
+				leaf->next->prev = right;
+			else
+				_last = right;
+			leaf->next = right;
+
+			_insert_separator(path, path_index, right->pairs()[0].key, right);
+			return result;
+		}
+
+		template<typename ... TArgs>
+		void
+		_leaf_insert(Leaf_Type* leaf, usize index, TArgs&& ... args)
+		{
+			Pair_Type* pairs = leaf->pairs();
+			internal::_b_tree_move_backward(pairs + index + 1, pairs + index, leaf->count - index);
+			::new (pairs + index) Pair_Type(std::forward<TArgs>(args)...);
+			++leaf->count;
+		}
+
+		void
+		_inner_insert(Inner_Type* node, usize index, Key_Type&& key, void* child)
+		{
+			Key_Type* keys = node->keys();
+			internal::_b_tree_move_backward(keys + index + 1, keys + index, node->count - index);
+			::new (keys + index) Key_Type(std::move(key));
+			::memmove(node->children + index + 2, node->children + index + 1, (node->count - index) * sizeof(void*));
+			node->children[index + 1] = child;
+			++node->count;
+		}
+
+		//removes the key at the index and the child right after it
+		void
+		_inner_remove(Inner_Type* node, usize index)
+		{
+			Key_Type* keys = node->keys();
+			keys[index].~Key_Type();
+			internal::_b_tree_move(keys + index, keys + index + 1, node->count - index - 1);
+			::memmove(node->children + index + 1, node->children + index + 2, (node->count - index - 1) * sizeof(void*));
+			--node->count;
+		}
+
+		//puts the separator of a new child in its parent, splitting the full nodes on the way up
+		void
+		_insert_separator(Inner_Type** path, usize* path_index, const Key_Type& separator, void* child)
+		{
+			Key_Type key(separator);
+			for(usize level = _height; level > 0; --level)
+			{
+				Inner_Type* node = path[level - 1];
+				usize index = path_index[level - 1];
+				if(node->count < Inner_Type::CAPACITY)
+				{
+					_inner_insert(node, index, std::move(key), child);
+					return;
+				}
+
+				//the node is full, the left half stays, the right half moves to a new node
+				//and the middle key moves up to the parent
+				Inner_Type* right = _create_inner();
+				Key_Type* keys = node->keys();
+				usize mid = node->count / 2;
+				if(index < mid)
+				{
+					Key_Type up(std::move(keys[mid - 1]));
+					keys[mid - 1].~Key_Type();
+					right->count = node->count - mid;
+					internal::_b_tree_move(right->keys(), keys + mid, right->count);
+					::memcpy(right->children, node->children + mid, (right->count + 1) * sizeof(void*));
+					node->count = mid - 1;
+					_inner_insert(node, index, std::move(key), child);
+					internal::_b_tree_replace(&key, std::move(up));
+				}
+				else if(index == mid)
+				{
+					right->count = node->count - mid;
+					internal::_b_tree_move(right->keys(), keys + mid, right->count);
+					right->children[0] = child;
+					::memcpy(right->children + 1, node->children + mid + 1, right->count * sizeof(void*));
+					node->count = mid;
+				}
+				else
+				{
+					Key_Type up(std::move(keys[mid]));
+					keys[mid].~Key_Type();
+					right->count = node->count - mid - 1;
+					internal::_b_tree_move(right->keys(), keys + mid + 1, right->count);
+					::memcpy(right->children, node->children + mid + 1, (right->count + 1) * sizeof(void*));
+					node->count = mid;
+					_inner_insert(right, index - mid - 1, std::move(key), child);
+					internal::_b_tree_replace(&key, std::move(up));
+				}
+				child = right;
+			}
+
+			//the root got split so grow the tree a level
+			Inner_Type* root = _create_inner();
+			::new (root->keys()) Key_Type(std::move(key));
+			root->children[0] = _root;
+			root->children[1] = child;
+			root->count = 1;
+			_root = root;
+			++_height;
+		}
+
+		void
+		_rebalance_leaf(Inner_Type** path, usize* path_index, Leaf_Type* leaf)
+		{
+			Inner_Type* parent = path[_height - 1];
+			usize index = path_index[_height - 1];
+
+			//borrow a pair from a sibling that can spare one
+			if(index > 0)
+			{
+				Leaf_Type* left = (Leaf_Type*)parent->children[index - 1];
+				if(left->count > LEAF_MIN)
+				{
+					internal::_b_tree_move_backward(leaf->pairs() + 1, leaf->pairs(), leaf->count);
+					internal::_b_tree_move(leaf->pairs(), left->pairs() + left->count - 1, 1);
+					--left->count;
+					++leaf->count;
+					internal::_b_tree_replace(parent->keys() + index - 1, leaf->pairs()[0].key);
+					return;
+				}
+			}
+
+			if(index < parent->count)
+			{
+				Leaf_Type* right = (Leaf_Type*)parent->children[index + 1];
+				if(right->count > LEAF_MIN)
+				{
+					internal::_b_tree_move(leaf->pairs() + leaf->count, right->pairs(), 1);
+					internal::_b_tree_move(right->pairs(), right->pairs() + 1, right->count - 1);
+					--right->count;
+					++leaf->count;
+					internal::_b_tree_replace(parent->keys() + index, right->pairs()[0].key);
+					return;
+				}
+			}
+
+			//otherwise merge it with a sibling
+			usize merge_index = index > 0 ? index - 1 : index;
+			Leaf_Type* left = (Leaf_Type*)parent->children[merge_index];
+			Leaf_Type* right = (Leaf_Type*)parent->children[merge_index + 1];
+			internal::_b_tree_move(left->pairs() + left->count, right->pairs(), right->count);
+			left->count += right->count;
+			right->count = 0;
+
+			left->next = right->next;
+			if(right->next)
+				right->next->prev = left;
+			else
+				_last = left;
+			_free_leaf(right);
+
+			_inner_remove(parent, merge_index);
+			_rebalance_inner(path, path_index, _height - 1);
+		}
+
+		void
+		_rebalance_inner(Inner_Type** path, usize* path_index, usize level)
+		{
+			while(true)
+			{
+				Inner_Type* node = path[level];
+				if(level == 0)
+				{
+					//the root is left with a single child so shrink the tree a level
+					if(node->count == 0)
+					{
+						_root = node->children[0];
+						_free_inner(node);
+						--_height;
+					}
+					return;
+				}
+
+				if(node->count >= INNER_MIN)
+					return;
+
+				Inner_Type* parent = path[level - 1];
+				usize index = path_index[level - 1];
+				Key_Type* parent_keys = parent->keys();
+
+				//rotate a key through the parent from a sibling that can spare one
+				if(index > 0)
+				{
+					Inner_Type* left = (Inner_Type*)parent->children[index - 1];
+					if(left->count > INNER_MIN)
+					{
+						internal::_b_tree_move_backward(node->keys() + 1, node->keys(), node->count);
+						::memmove(node->children + 1, node->children, (node->count + 1) * sizeof(void*));
+						::new (node->keys()) Key_Type(std::move(parent_keys[index - 1]));
+						node->children[0] = left->children[left->count];
+						internal::_b_tree_replace(parent_keys + index - 1, std::move(left->keys()[left->count - 1]));
+						left->keys()[left->count - 1].~Key_Type();
+						--left->count;
+						++node->count;
+						return;
+					}
+				}
+
+				if(index < parent->count)
+				{
+					Inner_Type* right = (Inner_Type*)parent->children[index + 1];
+					if(right->count > INNER_MIN)
+					{
+						::new (node->keys() + node->count) Key_Type(std::move(parent_keys[index]));
+						node->children[node->count + 1] = right->children[0];
+						internal::_b_tree_replace(parent_keys + index, std::move(right->keys()[0]));
+						right->keys()[0].~Key_Type();
+						internal::_b_tree_move(right->keys(), right->keys() + 1, right->count - 1);
+						::memmove(right->children, right->children + 1, right->count * sizeof(void*));
+						--right->count;
+						++node->count;
+						return;
+					}
+				}
+
+				//otherwise merge it with a sibling and the separator between them
+				usize merge_index = index > 0 ? index - 1 : index;
+				Inner_Type* left = (Inner_Type*)parent->children[merge_index];
+				Inner_Type* right = (Inner_Type*)parent->children[merge_index + 1];
+				::new (left->keys() + left->count) Key_Type(std::move(parent_keys[merge_index]));
+				internal::_b_tree_move(left->keys() + left->count + 1, right->keys(), right->count);
+				::memcpy(left->children + left->count + 1, right->children, (right->count + 1) * sizeof(void*));
+				left->count += right->count + 1;
+				right->count = 0;
+				_free_inner(right);
+
+				_inner_remove(parent, merge_index);
+				--level;
+			}
+		}
+
+		Leaf_Type*
+		_create_leaf()
+		{
+			Leaf_Type* result = _allocator->template alloc<Leaf_Type>().ptr;
+			result->prev = nullptr;
+			result->next = nullptr;
+			result->count = 0;
+			return result;
+		}
+
+		Inner_Type*
+		_create_inner()
+		{
+			Inner_Type* result = _allocator->template alloc<Inner_Type>().ptr;
+			result->count = 0;
+			return result;
+		}
+
+		void
+		_free_leaf(Leaf_Type* leaf)
+		{
+			Pair_Type* pairs = leaf->pairs();
+			for(usize i = 0; i < leaf->count; ++i)
+				pairs[i].~Pair_Type();
+			_allocator->template free<Leaf_Type>(own(leaf));
+		}
+
+		void
+		_free_inner(Inner_Type* node)
+		{
+			Key_Type* keys = node->keys();
+			for(usize i = 0; i < node->count; ++i)
+				keys[i].~Key_Type();
+			_allocator->template free<Inner_Type>(own(node));
+		}
+
+		void
+		_free_subtree(void* node, usize depth)
+		{
+			if(depth == 0)
+			{
+				_free_leaf((Leaf_Type*)node);
+				return;
+			}
+
+			Inner_Type* inner = (Inner_Type*)node;
+			for(usize i = 0; i <= inner->count; ++i)
+				_free_subtree(inner->children[i], depth - 1);
+			_free_inner(inner);
+		}
+
+		void
+		_copy_content(const B_Tree_Map& other)
+		{
+			if(other._root == nullptr)
+				return;
+
+			Leaf_Type* prev = nullptr;
+			_root = _copy_subtree(other._root, other._height, prev);
+			_height = other._height;
+			_count = other._count;
+			_last = prev;
+		}
+
+		//copies the node as is so the copy keeps the same fill of the nodes
+		void*
+		_copy_subtree(const void* node, usize depth, Leaf_Type*& prev)
+		{
+			if(depth == 0)
+			{
+				const Leaf_Type* leaf = (const Leaf_Type*)node;
+				Leaf_Type* result = _create_leaf();
+				for(usize i = 0; i < leaf->count; ++i)
+					::new (result->pairs() + i) Pair_Type(leaf->pairs()[i]);
+				result->count = leaf->count;
+
+				result->prev = prev;
+				if(prev)
+					prev->next = result;
+				else
+					_first = result;
+				prev = result;
+				return result;
+			}
+
+			const Inner_Type* inner = (const Inner_Type*)node;
+			Inner_Type* result = _create_inner();
+			for(usize i = 0; i < inner->count; ++i)
+				::new (result->keys() + i) Key_Type(inner->keys()[i]);
+			for(usize i = 0; i <= inner->count; ++i)
+				result->children[i] = _copy_subtree(inner->children[i], depth - 1, prev);
+			result->count = inner->count;
+			return result;
+		}
+
+		//checks the node fill, the key order against the separators bounds and the leaves links
+		bool
+		_check_subtree(const void* node, usize depth,
+					   const Key_Type* low, const Key_Type* high,
+					   const Leaf_Type*& prev, usize& values_count) const
+		{
+			bool is_root = node == _root;
+			if(depth == 0)
+			{
+				const Leaf_Type* leaf = (const Leaf_Type*)node;
+				if(leaf->count > Leaf_Type::CAPACITY || leaf->count < (is_root ? 1 : LEAF_MIN))
+					return false;
+				if(leaf->prev != prev || (prev ? prev->next : _first) != leaf)
+					return false;
+
+				const Pair_Type* pairs = leaf->pairs();
+				for(usize i = 1; i < leaf->count; ++i)
+					if(!_less_than(pairs[i - 1].key, pairs[i].key))
+						return false;
+				if(low && _less_than(pairs[0].key, *low))
+					return false;
+				if(high && !_less_than(pairs[leaf->count - 1].key, *high))
+					return false;
+
+				prev = leaf;
+				values_count += leaf->count;
+				return true;
+			}
+
+			const Inner_Type* inner = (const Inner_Type*)node;
+			if(inner->count > Inner_Type::CAPACITY || inner->count < (is_root ? 1 : INNER_MIN))
+				return false;
+
+			const Key_Type* keys = inner->keys();
+			for(usize i = 1; i < inner->count; ++i)
+				if(!_less_than(keys[i - 1], keys[i]))
+					return false;
+			if(low && _less_than(keys[0], *low))
+				return false;
+			if(high && !_less_than(keys[inner->count - 1], *high))
+				return false;
+
+			for(usize i = 0; i <= inner->count; ++i)
+			{
+				const Key_Type* child_low = i > 0 ? keys + i - 1 : low;
+				const Key_Type* child_high = i < inner->count ? keys + i : high;
+				if(!_check_subtree(inner->children[i], depth - 1, child_low, child_high, prev, values_count))
+					return false;
+			}
+			return true;
+		}
+	};
+}
@@ -0,0 +1,412 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/Hash_Map.h"
+#include <atomic>
+#include <thread>
+#include <cstring>
+
+namespace cppr
+{
+	namespace internal
+	{
+		/**
+		 * @brief      Reader writer spin lock of a hash map shard
+		 * The highest bit of the state is held by the writer and the rest of the bits count the readers,
+		 * the writer claims its bit first so no new readers get in then waits for the current readers to leave
+		 */
+		struct Hash_Shard_Lock
+		{
+			constexpr static u32 WRITER_BIT = 0x80000000;
+
+			std::atomic<u32> _state;
+
+			Hash_Shard_Lock()
+				:_state(0)
+			{}
+
+			void
+			read_lock()
+			{
+				while(true)
+				{
+					u32 state = _state.load(std::memory_order_relaxed);
+					if((state & WRITER_BIT) == 0 &&
+					   _state.compare_exchange_weak(state, state + 1, std::memory_order_acquire))
+						return;
+					std::this_thread::yield();
+				}
+			}
+
+			void
+			read_unlock()
+			{
+				_state.fetch_sub(1, std::memory_order_release);
+			}
+
+			void
+			write_lock()
+			{
+				while(true)
+				{
+					u32 state = _state.load(std::memory_order_relaxed);
+					if((state & WRITER_BIT) == 0 &&
+					   _state.compare_exchange_weak(state, state | WRITER_BIT, std::memory_order_acquire))
+						break;
+					std::this_thread::yield();
+				}
+
+				while(_state.load(std::memory_order_acquire) != WRITER_BIT)
+					std::this_thread::yield();
+			}
+
+			void
+			write_unlock()
+			{
+				_state.store(0, std::memory_order_release);
+			}
+		};
+
+		//each shard lives in its own cache lines so the locks of different shards don't false share
+		template<typename TMap>
+		struct alignas(64) Concurrent_Hash_Shard
+		{
+			mutable Hash_Shard_Lock lock;
+			TMap map;
+
+			Concurrent_Hash_Shard(Allocator_Trait* context)
+				:map(context)
+			{}
+		};
+	}
+
+	/**
+	 * @brief      A Hash map which can be used from multiple threads at the same time
+	 * The keys are distributed over independently locked shards, each shard is a Hash_Map guarded by a
+	 * reader writer lock, so readers don't block each other and writers only block the shard they write to.
+	 * The values are copied in and out of the map since references can't outlive the shard lock.
+	 * The memory context must be safe to use from multiple threads.
+	 *
+	 * @tparam     TKey    Type of the keys
+	 * @tparam     TValue  Type of the values
+	 * @tparam     THash   Type of the hash functor
+	 */
+	template<typename TKey, typename TValue,
+			 typename THash = internal::Pair_Hash_Functor<TKey, TValue>>
+	struct Concurrent_Hash_Map
+	{
+		/**
+		 * Type of the hash map of each shard
+		 */
+		using Map_Type = Hash_Map<TKey, TValue, THash>;
+
+		using Shard_Type = internal::Concurrent_Hash_Shard<Map_Type>;
+
+		/**
+		 * The count of shards per worker, more shards than workers make it less likely that two workers
+		 * write to the same shard at the same time
+		 */
+		constexpr static usize SHARDS_PER_WORKER = 4;
+
+		/**
+		 * Memory contex used by the container
+		 */
+		Allocator_Trait* _allocator;
+		Owner<Shard_Type> _shards;
+		THash _hasher;
+		usize _shard_shift;
+
+		/**
+		 * @brief      Constructs a concurrent hash map with shards sized from the count of the workers which will use it
+		 *
+		 * @param[in]  workers_count  The count of the workers (threads) which will use the map
+		 * @param      context        The memory context to use for allocation and freeing
+		 */
+		Concurrent_Hash_Map(usize workers_count = std::thread::hardware_concurrency(),
+							Allocator_Trait* context = allocator())
+			:_allocator(context),
+			 _hasher(THash())
+		{
+			//power of two count of shards which is selected by the highest bits of the mixed hash
+			usize shards_count = 2;
+			_shard_shift = sizeof(usize) * 8 - 1;
+			while(shards_count < workers_count * SHARDS_PER_WORKER)
+			{
+				shards_count <<= 1;
+				--_shard_shift;
+			}
+
+			_shards = _allocator->template alloc<Shard_Type>(shards_count);
+			for(usize i = 0; i < shards_count; ++i)
+				::new (_shards.ptr + i) Shard_Type(_allocator);
+		}
+
+		Concurrent_Hash_Map(const Concurrent_Hash_Map&) = delete;
+
+		Concurrent_Hash_Map&
+		operator=(const Concurrent_Hash_Map&) = delete;
+
+		/**
+		 * @brief      Destroys the concurrent hash map
+		 */
+		~Concurrent_Hash_Map()
+		{
+			for(usize i = 0; i < _shards.count(); ++i)
+				_shards[i].~Shard_Type();
+			_allocator->template free<Shard_Type>(_shards);
+		}
+
+		/**
+		 * @return     The count of shards of this map
+		 */
+		usize
+		shards_count() const
+		{
+			return _shards.count();
+		}
+
+		/**
+		 * @return     The count of values in this map, other threads may change it while it's being counted
+		 */
+		usize
+		count() const
+		{
+			usize result = 0;
+			for(usize i = 0; i < _shards.count(); ++i)
+			{
+				_shards[i].lock.read_lock();
+				result += _shards[i].map.count();
+				_shards[i].lock.read_unlock();
+			}
+			return result;
+		}
+
+		/**
+		 * @return     Whether the map is empty
+		 */
+		bool
+		empty() const
+		{
+			return count() == 0;
+		}
+
+		/**
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted
+		 *
+		 * @return     True if inserted, false if the key already exists
+		 */
+		bool
+		insert(const TKey& key, const TValue& value)
+		{
+			usize hash_value = _hasher(key);
+			Shard_Type& shard = _shards[_shard_index(hash_value)];
+
+			shard.lock.write_lock();
+			usize count = shard.map.count();
+			shard.map._emplace_index_hashed(hash_value, key, value);
+			bool inserted = count != shard.map.count();
+			shard.lock.write_unlock();
+			return inserted;
+		}
+
+		/**
+		 * @brief      Inserts the key-value pair if the key doesn't exist, otherwise assigns the value to the existing key
+		 *
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted or assigned
+		 */
+		void
+		insert_or_assign(const TKey& key, const TValue& value)
+		{
+			usize hash_value = _hasher(key);
+			Shard_Type& shard = _shards[_shard_index(hash_value)];
+
+			shard.lock.write_lock();
+			usize count = shard.map.count();
+			usize index = shard.map._emplace_index_hashed(hash_value, key, value);
+			if(count == shard.map.count())
+				shard.map._values[index].value = value;
+			shard.lock.write_unlock();
+		}
+
+		/**
+		 * @param[in]  key    The key to search for
+		 * @param[out] value  The found value is copied into it
+		 *
+		 * @return     True if the key is found, false otherwise
+		 */
+		bool
+		lookup(const TKey& key, TValue& value) const
+		{
+			usize hash_value = _hasher(key);
+			const Shard_Type& shard = _shards[_shard_index(hash_value)];
+
+			shard.lock.read_lock();
+			usize index = shard.map._lookup_index(key, hash_value);
+			bool found = index != shard.map._capacity;
+			if(found)
+				value = shard.map._values[index].value;
+			shard.lock.read_unlock();
+			return found;
+		}
+
+		/**
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     Whether the key exists in the map
+		 */
+		bool
+		contains(const TKey& key) const
+		{
+			usize hash_value = _hasher(key);
+			const Shard_Type& shard = _shards[_shard_index(hash_value)];
+
+			shard.lock.read_lock();
+			bool found = shard.map._lookup_index(key, hash_value) != shard.map._capacity;
+			shard.lock.read_unlock();
+			return found;
+		}
+
+		/**
+		 * @param[in]  key   The key to be removed
+		 *
+		 * @return     True if removed the value, false if the key doesn't exist
+		 */
+		bool
+		remove(const TKey& key)
+		{
+			usize hash_value = _hasher(key);
+			Shard_Type& shard = _shards[_shard_index(hash_value)];
+
+			shard.lock.write_lock();
+			usize index = shard.map._lookup_index(key, hash_value);
+			bool found = index != shard.map._capacity;
+			if(found)
+				shard.map._remove_index(index);
+			shard.lock.write_unlock();
+			return found;
+		}
+
+		/**
+		 * @brief      Looks up a batch of keys, the keys are grouped by their shards so each shard is locked once
+		 *
+		 * @param[in]  keys    The keys to search for
+		 * @param[out] values  The found values are copied into the same index of their keys, it should be as long as the keys
+		 * @param[out] found   Whether each key is found, it should be as long as the keys
+		 *
+		 * @return     The count of found keys
+		 */
+		usize
+		lookup_batch(const Slice<const TKey>& keys, Slice<TValue> values, Slice<bool> found) const
+		{
+			usize found_count = 0;
+			_batch(keys, [&](const Shard_Type& shard, const usize* hashes, const usize* it, const usize* end) {
+				shard.lock.read_lock();
+				for(; it != end; ++it)
+				{
+					usize i = *it;
+					usize index = shard.map._lookup_index(keys[i], hashes[i]);
+					found[i] = index != shard.map._capacity;
+					if(found[i])
+					{
+						values[i] = shard.map._values[index].value;
+						++found_count;
+					}
+				}
+				shard.lock.read_unlock();
+			});
+			return found_count;
+		}
+
+		/**
+		 * @brief      Inserts a batch of key-value pairs, the keys are grouped by their shards so each shard is locked once
+		 *
+		 * @param[in]  keys    The keys to be inserted
+		 * @param[in]  values  The values to be inserted, it should be as long as the keys
+		 *
+		 * @return     The count of inserted pairs, the keys which already exist are not inserted
+		 */
+		usize
+		insert_batch(const Slice<const TKey>& keys, const Slice<const TValue>& values)
+		{
+			usize inserted_count = 0;
+			_batch(keys, [&](Shard_Type& shard, const usize* hashes, const usize* it, const usize* end) {
+				shard.lock.write_lock();
+				usize count = shard.map.count();
+				for(; it != end; ++it)
+					shard.map._emplace_index_hashed(hashes[*it], keys[*it], values[*it]);
+				inserted_count += shard.map.count() - count;
+				shard.lock.write_unlock();
+			});
+			return inserted_count;
+		}
+
+		/**
+		 * @brief      Removes all the values of the map
+		 */
+		void
+		clear()
+		{
+			for(usize i = 0; i < _shards.count(); ++i)
+			{
+				_shards[i].lock.write_lock();
+				_shards[i].map.clear();
+				_shards[i].lock.write_unlock();
+			}
+		}
+
+		usize
+		_shard_index(usize hash_value) const
+		{
+			//the shard map uses the low bits of the same mixed hash so we use the high bits
+			return internal::_hash_mix(hash_value) >> _shard_shift;
+		}
+
+		//groups the keys by their shards using a counting sort and calls the function once per shard with the
+		//hashes of the keys and the range of the indices of its keys
+		template<typename TFunc>
+		void
+		_batch(const Slice<const TKey>& keys, TFunc&& func) const
+		{
+			usize keys_count = keys.count();
+			usize shards_count = _shards.count();
+			if(keys_count == 0)
+				return;
+
+			auto buffer = _allocator->template alloc<usize>(keys_count * 2 + shards_count);
+			usize* hashes = buffer.ptr;
+			usize* order = hashes + keys_count;
+			usize* offsets = order + keys_count;
+			std::memset(offsets, 0, shards_count * sizeof(usize));
+
+			for(usize i = 0; i < keys_count; ++i)
+			{
+				hashes[i] = _hasher(keys[i]);
+				++offsets[_shard_index(hashes[i])];
+			}
+
+			usize start = 0;
+			for(usize i = 0; i < shards_count; ++i)
+			{
+				usize shard_count = offsets[i];
+				offsets[i] = start;
+				start += shard_count;
+			}
+
+			//after placing the keys each offset points to the end of its shard keys
+			for(usize i = 0; i < keys_count; ++i)
+				order[offsets[_shard_index(hashes[i])]++] = i;
+
+			start = 0;
+			for(usize i = 0; i < shards_count; ++i)
+			{
+				if(start != offsets[i])
+					func(_shards.ptr[i], hashes, order + start, order + offsets[i]);
+				start = offsets[i];
+			}
+
+			_allocator->template free<usize>(buffer);
+		}
+	};
+}
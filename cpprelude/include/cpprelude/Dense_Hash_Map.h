@@ -0,0 +1,833 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/Dynamic_Array.h"
+#include "cpprelude/Hash_Map.h"
+#include <cstring>
+
+namespace cppr
+{
+	/**
+	 * @brief      An insertion ordered hash map with a dense layout
+	 * The key-value pairs are stored contiguously in a dynamic array in their insertion order, and a separate
+	 * open addressing index table of u32 offsets maps the keys to their pairs, so iterating is a linear scan
+	 * over the pairs and the memory of the empty slots is 4 bytes instead of a whole pair.
+	 * The full hash of each pair is kept next to it so growing the index table never calls the hasher.
+	 * It can hold up to 2^32 - 2 pairs.
+	 *
+	 * @tparam     TKey    Type of the keys
+	 * @tparam     TValue  Type of the values
+	 * @tparam     THash   Type of the hash functor
+	 */
+	template<typename TKey, typename TValue,
+			 typename THash = internal::Pair_Hash_Functor<TKey, TValue>>
+	struct Dense_Hash_Map
+	{
+		/**
+		 * Data type of the dense hash map
+		 */
+		using Data_Type = internal::Hash_Pair<const TKey, TValue>;
+
+		/**
+		 * Pair type stored in the entries, its key is only const when it's viewed as a Data_Type
+		 * so growing and shifting the entries moves the keys instead of copying them
+		 */
+		using Pair_Type = internal::Hash_Pair<TKey, TValue>;
+
+		/**
+		 * Range Type of the dense hash map
+		 */
+		using Range_Type = Slice<Data_Type>;
+
+		/**
+		 * Const Range Type of the dense hash map
+		 */
+		using Const_Range_Type = Slice<const Data_Type>;
+
+		/**
+		 * Iterator type of this container
+		 */
+		using iterator = typename Range_Type::iterator;
+
+		/**
+		 * Const Iterator type of this container
+		 */
+		using const_iterator = typename Range_Type::const_iterator;
+
+		/**
+		 * The offset of the empty slots in the index table
+		 */
+		constexpr static u32 EMPTY_OFFSET = 0xFFFFFFFF;
+
+		/**
+		 * Memory contex used by the container
+		 */
+		Allocator_Trait* _allocator;
+		Dynamic_Array<Pair_Type> _entries;
+		Dynamic_Array<usize> _hashes;
+		Owner<u32> _index;
+		THash _hasher;
+
+		/**
+		 * @brief      Constructs a dense hash map that uses the provided memory context for allocation
+		 *
+		 * @param      context  The memory context to use for allocation and freeing
+		 */
+		Dense_Hash_Map(Allocator_Trait* context = allocator())
+			:_allocator(context),
+			 _entries(context),
+			 _hashes(context),
+			 _hasher(THash())
+		{}
+
+		/**
+		 * @brief      Constructs a dense hash map that uses the provided memory context for allocation
+		 *
+		 * @param[in]  hasher   The hasher functor to use
+		 * @param      context  The memory context to use for allocation and freeing
+		 */
+		Dense_Hash_Map(const THash& hasher, Allocator_Trait* context = allocator())
+			:_allocator(context),
+			 _entries(context),
+			 _hashes(context),
+			 _hasher(hasher)
+		{}
+
+		/**
+		 * @brief      Copy constructor
+		 *
+		 * @param[in]  other  The other dense hash map to copy from
+		 */
+		Dense_Hash_Map(const Dense_Hash_Map& other)
+			:_allocator(other._allocator),
+			 _entries(other._entries),
+			 _hashes(other._hashes),
+			 _hasher(other._hasher)
+		{
+			_index = _allocator->template alloc<u32>(other._index.count());
+			move(_index, other._index);
+		}
+
+		/**
+		 * @brief      Copy constructor with another memory context
+		 *
+		 * @param[in]  other    The other dense hash map to copy from
+		 * @param      context  The context to use for memory allocation and freeing
+		 */
+		Dense_Hash_Map(const Dense_Hash_Map& other, Allocator_Trait* context)
+			:_allocator(context),
+			 _entries(other._entries, context),
+			 _hashes(other._hashes, context),
+			 _hasher(other._hasher)
+		{
+			_index = _allocator->template alloc<u32>(other._index.count());
+			move(_index, other._index);
+		}
+
+		/**
+		 * @brief      Move constructor
+		 *
+		 * @param[in]  other  The other dense hash map to move from
+		 */
+		Dense_Hash_Map(Dense_Hash_Map&& other)
+			:_allocator(std::move(other._allocator)),
+			 _entries(std::move(other._entries)),
+			 _hashes(std::move(other._hashes)),
+			 _index(std::move(other._index)),
+			 _hasher(std::move(other._hasher))
+		{}
+
+		/**
+		 * @brief      Copy assignment operator
+		 *
+		 * @param[in]  other  The other dense hash map to copy values from
+		 *
+		 * @return     A Reference to this dense hash map
+		 */
+		Dense_Hash_Map&
+		operator=(const Dense_Hash_Map& other)
+		{
+			reset();
+			_allocator = other._allocator;
+			_entries = other._entries;
+			_hashes = other._hashes;
+			_hasher = other._hasher;
+			_index = _allocator->template alloc<u32>(other._index.count());
+			move(_index, other._index);
+			return *this;
+		}
+
+		/**
+		 * @brief      Move assignment operator
+		 *
+		 * @param[in]  other  The other dense hash map to move values from
+		 *
+		 * @return     A Reference to this dense hash map
+		 */
+		Dense_Hash_Map&
+		operator=(Dense_Hash_Map&& other)
+		{
+			reset();
+			_allocator = std::move(other._allocator);
+			_entries = std::move(other._entries);
+			_hashes = std::move(other._hashes);
+			_index = std::move(other._index);
+			_hasher = std::move(other._hasher);
+			return *this;
+		}
+
+		/**
+		 * @brief      Destroys the dense hash map
+		 */
+		~Dense_Hash_Map()
+		{
+			reset();
+		}
+
+		/**
+		 * @return     The capacity of the index table of this dense hash map
+		 */
+		usize
+		capacity() const
+		{
+			return _index.count();
+		}
+
+		/**
+		 * @return     The count of values in this dense hash map
+		 */
+		usize
+		count() const
+		{
+			return _entries.count();
+		}
+
+		/**
+		 * @return     Whether the dense hash map is empty
+		 */
+		bool
+		empty() const
+		{
+			return _entries.empty();
+		}
+
+		/**
+		 * @brief      Ensures that the dense hash map has the capacity for the expected count
+		 *
+		 * @param[in]  expected_count  The expected count to reserve
+		 */
+		void
+		reserve(usize expected_count)
+		{
+			_entries.reserve(expected_count);
+			_hashes.reserve(expected_count);
+
+			usize fit = count() + expected_count;
+			if(fit <= _max_count())
+				return;
+
+			_rehash(internal::_hash_capacity_for(fit, internal::HASH_DEFAULT_MAX_LOAD_FACTOR));
+		}
+
+		/**
+		 * @brief      Shrinks the memory of the dense hash map to the smallest capacity which fits its values
+		 */
+		void
+		shrink_to_fit()
+		{
+			if(empty())
+			{
+				reset();
+				return;
+			}
+
+			_entries.shrink_to_fit();
+			_hashes.shrink_to_fit();
+
+			usize new_cap = internal::_hash_capacity_for(count(), internal::HASH_DEFAULT_MAX_LOAD_FACTOR);
+			if(new_cap != capacity())
+				_rehash(new_cap);
+		}
+
+		/**
+		 * @param[in]  key  The key to be inserted, and value of this key will be default initialized
+		 *
+		 * @return     An Iterator to the inserted key-value pair
+		 */
+		iterator
+		insert(const TKey& key)
+		{
+			return begin() + _emplace_entry(key);
+		}
+
+		/**
+		 * @param[in]  key  The key to be inserted, and value of this key will be default initialized
+		 *
+		 * @return     An Iterator to the inserted key-value pair
+		 */
+		iterator
+		insert(TKey&& key)
+		{
+			return begin() + _emplace_entry(std::move(key));
+		}
+
+		/**
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted
+		 *
+		 * @return     An Iterator to the inserted key-value pair, or to the existing pair if the key exists
+		 */
+		iterator
+		insert(const TKey& key, const TValue& value)
+		{
+			return begin() + _emplace_entry(key, value);
+		}
+
+		/**
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted
+		 *
+		 * @return     An Iterator to the inserted key-value pair, or to the existing pair if the key exists
+		 */
+		iterator
+		insert(const TKey& key, TValue&& value)
+		{
+			return begin() + _emplace_entry(key, std::move(value));
+		}
+
+		/**
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted
+		 *
+		 * @return     An Iterator to the inserted key-value pair, or to the existing pair if the key exists
+		 */
+		iterator
+		insert(TKey&& key, const TValue& value)
+		{
+			return begin() + _emplace_entry(std::move(key), value);
+		}
+
+		/**
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted
+		 *
+		 * @return     An Iterator to the inserted key-value pair, or to the existing pair if the key exists
+		 */
+		iterator
+		insert(TKey&& key, TValue&& value)
+		{
+			return begin() + _emplace_entry(std::move(key), std::move(value));
+		}
+
+		/**
+		 * @brief      Inserts a value constructed in place from the given args if the key doesn't exist,
+		 * if it exists nothing is constructed and the dense hash map is left unchanged
+		 *
+		 * @param[in]  key   The key to be inserted
+		 * @param[in]  args  values that will be passed to the value type constructor
+		 *
+		 * @tparam     TArgs      Variadic template type
+		 *
+		 * @return     An Iterator to the inserted or the existing key-value pair
+		 */
+		template<typename ... TArgs>
+		iterator
+		try_emplace(const TKey& key, TArgs&& ... args)
+		{
+			return begin() + _emplace_entry(key, std::forward<TArgs>(args)...);
+		}
+
+		/**
+		 * @brief      Inserts a value constructed in place from the given args if the key doesn't exist,
+		 * if it exists nothing is constructed and the dense hash map is left unchanged
+		 *
+		 * @param[in]  key   The key to be inserted
+		 * @param[in]  args  values that will be passed to the value type constructor
+		 *
+		 * @tparam     TArgs      Variadic template type
+		 *
+		 * @return     An Iterator to the inserted or the existing key-value pair
+		 */
+		template<typename ... TArgs>
+		iterator
+		try_emplace(TKey&& key, TArgs&& ... args)
+		{
+			return begin() + _emplace_entry(std::move(key), std::forward<TArgs>(args)...);
+		}
+
+		/**
+		 * @brief      Inserts the key-value pair if the key doesn't exist, otherwise assigns the value to the existing key
+		 * which keeps its position in the insertion order
+		 *
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted or assigned
+		 *
+		 * @return     An Iterator to the inserted or the assigned key-value pair
+		 */
+		template<typename TArg>
+		iterator
+		insert_or_assign(const TKey& key, TArg&& value)
+		{
+			usize old_count = count();
+			usize entry = _emplace_entry(key, std::forward<TArg>(value));
+			if(old_count == count())
+				_entries[entry].value = std::forward<TArg>(value);
+			return begin() + entry;
+		}
+
+		/**
+		 * @brief      Inserts the key-value pair if the key doesn't exist, otherwise assigns the value to the existing key
+		 * which keeps its position in the insertion order
+		 *
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted or assigned
+		 *
+		 * @return     An Iterator to the inserted or the assigned key-value pair
+		 */
+		template<typename TArg>
+		iterator
+		insert_or_assign(TKey&& key, TArg&& value)
+		{
+			usize old_count = count();
+			usize entry = _emplace_entry(std::move(key), std::forward<TArg>(value));
+			if(old_count == count())
+				_entries[entry].value = std::forward<TArg>(value);
+			return begin() + entry;
+		}
+
+		/**
+		 * @brief      Access a value of the dense hash map with the given key. if the value doesn't exist it will be added with a default initialized value
+		 *
+		 * @param[in]  key   The key to be accessed
+		 *
+		 * @return     The corresponding value by reference
+		 */
+		TValue&
+		operator[](const TKey& key)
+		{
+			return _entries[_emplace_entry(key)].value;
+		}
+
+		/**
+		 * @brief      Access a value of the dense hash map with the given key. if the value doesn't exist it will be added with a default initialized value
+		 *
+		 * @param[in]  key   The key to be accessed
+		 *
+		 * @return     The corresponding value by reference
+		 */
+		TValue&
+		operator[](TKey&& key)
+		{
+			return _entries[_emplace_entry(std::move(key))].value;
+		}
+
+		/**
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     An Iterator to the found key-value pair, or an iterator to the end if not found
+		 */
+		iterator
+		lookup(const TKey& key)
+		{
+			usize slot = _lookup_slot(key, _hasher(key));
+			if(slot == capacity())
+				return end();
+			return begin() + _index[slot];
+		}
+
+		/**
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     A Const iterator to the found key-value pair, or an iterator to the end if not found
+		 */
+		const_iterator
+		lookup(const TKey& key) const
+		{
+			usize slot = _lookup_slot(key, _hasher(key));
+			if(slot == capacity())
+				return end();
+			return begin() + _index[slot];
+		}
+
+		/**
+		 * @brief      Heterogeneous lookup, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 *
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     An Iterator to the found key-value pair, or an iterator to the end if not found
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		iterator
+		lookup(const TLookup& key)
+		{
+			usize slot = _lookup_slot(key, _hasher(key));
+			if(slot == capacity())
+				return end();
+			return begin() + _index[slot];
+		}
+
+		/**
+		 * @brief      Heterogeneous lookup, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 *
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     A Const iterator to the found key-value pair, or an iterator to the end if not found
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		const_iterator
+		lookup(const TLookup& key) const
+		{
+			usize slot = _lookup_slot(key, _hasher(key));
+			if(slot == capacity())
+				return end();
+			return begin() + _index[slot];
+		}
+
+		/**
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     Whether the key exists in the dense hash map
+		 */
+		bool
+		contains(const TKey& key) const
+		{
+			return _lookup_slot(key, _hasher(key)) != capacity();
+		}
+
+		/**
+		 * @brief      Removes the key and shifts the pairs after it back so the insertion order is kept,
+		 * it's O(count) so prefer `remove_unordered` when the order doesn't matter
+		 *
+		 * @param[in]  key   The key to be removed
+		 *
+		 * @return     True if removed the key, false if the key doesn't exist
+		 */
+		bool
+		remove(const TKey& key)
+		{
+			usize slot = _lookup_slot(key, _hasher(key));
+			if(slot == capacity())
+				return false;
+
+			_remove_entry(slot, true);
+			return true;
+		}
+
+		/**
+		 * @brief      Removes the pair which the iterator points to and shifts the pairs after it back so the insertion
+		 * order is kept, it's O(count)
+		 *
+		 * @param[in]  it    The iterator to the pair to be removed
+		 *
+		 * @return     True if removed the pair, false if the iterator points to the end
+		 */
+		bool
+		remove(const_iterator it)
+		{
+			if(it == end())
+				return false;
+
+			_remove_entry(_entry_slot(it - begin()), true);
+			return true;
+		}
+
+		/**
+		 * @brief      Removes the key in O(1) by moving the last pair into its place, so it changes the order of the last pair
+		 *
+		 * @param[in]  key   The key to be removed
+		 *
+		 * @return     True if removed the key, false if the key doesn't exist
+		 */
+		bool
+		remove_unordered(const TKey& key)
+		{
+			usize slot = _lookup_slot(key, _hasher(key));
+			if(slot == capacity())
+				return false;
+
+			_remove_entry(slot, false);
+			return true;
+		}
+
+		/**
+		 * @brief      Removes all the values of the dense hash map
+		 */
+		void
+		clear()
+		{
+			_entries.clear();
+			_hashes.clear();
+			if(_index)
+				std::memset(_index.ptr, 0xFF, _index.size);
+		}
+
+		/**
+		 * @brief      Removes all the values of the dense hash map and frees the memory
+		 */
+		void
+		reset()
+		{
+			_entries.reset();
+			_hashes.reset();
+			_allocator->template free<u32>(_index);
+		}
+
+		/**
+		 * @return     Range viewing all the key-value pairs in their insertion order
+		 */
+		Range_Type
+		all()
+		{
+			return make_slice(_data(), _entries.count());
+		}
+
+		/**
+		 * @return     Const range viewing all the key-value pairs in their insertion order
+		 */
+		Const_Range_Type
+		all() const
+		{
+			return make_slice(_data(), _entries.count());
+		}
+
+		/**
+		 * @return     A Reference to the first inserted key-value pair
+		 */
+		Data_Type&
+		front()
+		{
+			return _data()[0];
+		}
+
+		/**
+		 * @return     A Const reference to the first inserted key-value pair
+		 */
+		const Data_Type&
+		front() const
+		{
+			return _data()[0];
+		}
+
+		/**
+		 * @return     A Reference to the last inserted key-value pair
+		 */
+		Data_Type&
+		back()
+		{
+			return _data()[_entries.count() - 1];
+		}
+
+		/**
+		 * @return     A Const reference to the last inserted key-value pair
+		 */
+		const Data_Type&
+		back() const
+		{
+			return _data()[_entries.count() - 1];
+		}
+
+		/**
+		 * @return     An Iterator to the beginning of this container
+		 */
+		iterator
+		begin()
+		{
+			return _data();
+		}
+
+		/**
+		 * @return     A Const iterator to the beginning of this container
+		 */
+		const_iterator
+		begin() const
+		{
+			return _data();
+		}
+
+		/**
+		 * @return     A Const iterator to the beginning of this container
+		 */
+		const_iterator
+		cbegin() const
+		{
+			return _data();
+		}
+
+		/**
+		 * @return     An Iterator to the end of the container
+		 */
+		iterator
+		end()
+		{
+			return _data() + _entries.count();
+		}
+
+		/**
+		 * @return     A Const Iterator to the end of the container
+		 */
+		const_iterator
+		end() const
+		{
+			return _data() + _entries.count();
+		}
+
+		/**
+		 * @return     A Const Iterator to the end of the container
+		 */
+		const_iterator
+		cend() const
+		{
+			return _data() + _entries.count();
+		}
+
+		Data_Type*
+		_data()
+		{
+			return reinterpret_cast<Data_Type*>(_entries.data());
+		}
+
+		const Data_Type*
+		_data() const
+		{
+			return reinterpret_cast<const Data_Type*>(_entries.data());
+		}
+
+		usize
+		_max_count() const
+		{
+			return static_cast<usize>(capacity() * internal::HASH_DEFAULT_MAX_LOAD_FACTOR);
+		}
+
+		//rebuilds the index table with the given capacity from the cached hashes
+		void
+		_rehash(usize new_cap)
+		{
+			_allocator->template free<u32>(_index);
+			_index = _allocator->template alloc<u32>(new_cap);
+			std::memset(_index.ptr, 0xFF, _index.size);
+
+			for(usize i = 0; i < _entries.count(); ++i)
+				_index[_free_slot(_hashes[i])] = static_cast<u32>(i);
+		}
+
+		usize
+		_free_slot(usize hash_value) const
+		{
+			usize mask = capacity() - 1;
+			usize slot = internal::_hash_h1(hash_value) & mask;
+			while(_index[slot] != EMPTY_OFFSET)
+				slot = (slot + 1) & mask;
+			return slot;
+		}
+
+		//linear probing over the index table, the keys are only compared when their full hashes are equal
+		template<typename TLookup>
+		usize
+		_lookup_slot(const TLookup& key, usize hash_value) const
+		{
+			usize cap = capacity();
+			if(cap == 0)
+				return cap;
+
+			usize mask = cap - 1;
+			usize slot = internal::_hash_h1(hash_value) & mask;
+			while(_index[slot] != EMPTY_OFFSET)
+			{
+				u32 entry = _index[slot];
+				if(_hashes[entry] == hash_value && _entries[entry].key == key)
+					return slot;
+				slot = (slot + 1) & mask;
+			}
+			return cap;
+		}
+
+		//the slot of the index table which holds the given entry offset
+		usize
+		_entry_slot(usize entry) const
+		{
+			usize mask = capacity() - 1;
+			usize slot = internal::_hash_h1(_hashes[entry]) & mask;
+			while(_index[slot] != entry)
+				slot = (slot + 1) & mask;
+			return slot;
+		}
+
+		//probes once for the key and appends a pair constructed in place only if the key doesn't exist
+		template<typename TKeyArg, typename ... TArgs>
+		usize
+		_emplace_entry(TKeyArg&& key, TArgs&& ... args)
+		{
+			usize hash_value = _hasher(key);
+			usize slot = _lookup_slot(key, hash_value);
+			if(slot != capacity())
+				return _index[slot];
+
+			if(count() + 1 > _max_count())
+			{
+				_rehash(capacity() == 0 ? internal::HASH_GROUP_WIDTH : capacity() * 2);
+			}
+
+			usize entry = count();
+			_entries.emplace_back(internal::Hash_Emplace_Tag(), std::forward<TKeyArg>(key), std::forward<TArgs>(args)...);
+			_hashes.insert_back(hash_value);
+			_index[_free_slot(hash_value)] = static_cast<u32>(entry);
+			return entry;
+		}
+
+		//removes the pair of the given index slot, the pairs after it are either shifted back or the last pair is moved into its place
+		void
+		_remove_entry(usize slot, bool keep_order)
+		{
+			usize entry = _index[slot];
+			usize last = count() - 1;
+			_erase_slot(slot);
+
+			if(entry != last)
+			{
+				if(keep_order)
+				{
+					for(usize i = entry; i < last; ++i)
+					{
+						_entries[i].~Pair_Type();
+						::new (_entries.data() + i) Pair_Type(std::move(_entries[i + 1]));
+						_hashes[i] = _hashes[i + 1];
+					}
+
+					for(usize i = 0; i < capacity(); ++i)
+						if(_index[i] != EMPTY_OFFSET && _index[i] > entry)
+							--_index[i];
+				}
+				else
+				{
+					_index[_entry_slot(last)] = static_cast<u32>(entry);
+					_entries[entry].~Pair_Type();
+					::new (_entries.data() + entry) Pair_Type(std::move(_entries[last]));
+					_hashes[entry] = _hashes[last];
+				}
+			}
+
+			_entries.remove_back();
+			_hashes.remove_back();
+		}
+
+		//backward shift deletion, the slots after the erased one are moved back if that brings them closer
+		//to their home slot, so no deleted markers are left in the index table
+		void
+		_erase_slot(usize slot)
+		{
+			usize mask = capacity() - 1;
+			usize next = (slot + 1) & mask;
+			while(_index[next] != EMPTY_OFFSET)
+			{
+				usize home = internal::_hash_h1(_hashes[_index[next]]) & mask;
+				if(((next - home) & mask) >= ((next - slot) & mask))
+				{
+					_index[slot] = _index[next];
+					slot = next;
+				}
+				next = (next + 1) & mask;
+			}
+			_index[slot] = EMPTY_OFFSET;
+		}
+	};
+}
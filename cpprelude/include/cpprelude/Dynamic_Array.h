@@ -285,7 +285,10 @@ namespace cppr
 			new_capacity += _count;
 			Owner<Data_Type> new_data = _allocator->template alloc<Data_Type>(new_capacity);
 			for(usize i = 0; i < _count; ++i)
+			{
 				::new (new_data.ptr + i) Data_Type(std::move(_data[i]));
+				_data[i].~Data_Type();
+			}
 
 			if(_data)
 				_allocator->template free<Data_Type>(_data);
@@ -566,7 +569,10 @@ namespace cppr
 
 			Owner<Data_Type> new_data = _allocator->template alloc<Data_Type>(_count);
 			for(usize i = 0; i < _count; ++i)
+			{
 				::new (new_data.ptr + i) Data_Type(std::move(_data[i]));
+				_data[i].~Data_Type();
+			}
 			_allocator->template free<Data_Type>(_data);
 			_data = std::move(new_data);
 		}
@@ -0,0 +1,646 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/Dynamic_Array.h"
+#include "cpprelude/Hash_Map.h"
+#include "cpprelude/File.h"
+#include "cpprelude/Panic.h"
+#include <cstring>
+#include <type_traits>
+
+namespace cppr
+{
+	namespace internal
+	{
+		/**
+		 * The magic number of the frozen hash map images, it's "FRZH" in little endian
+		 */
+		constexpr u32 FROZEN_HASH_MAGIC = 0x485A5246;
+		constexpr u32 FROZEN_HASH_VERSION = 1;
+
+		/**
+		 * The average count of keys per bucket, each bucket has a 4 bytes pilot
+		 */
+		constexpr usize FROZEN_HASH_BUCKET_SIZE = 4;
+
+		/**
+		 * The header of a frozen hash map image, it's followed by the pilots then the key-value pairs
+		 */
+		struct Frozen_Hash_Header
+		{
+			u32 magic;
+			u32 version;
+			u64 count;
+			u64 buckets_count;
+			u64 pair_size;
+		};
+
+		//maps a uniform hash into [0, n) using the high half of the 128 bit product, it needs no division
+		inline static u64
+		_frozen_reduce(u64 hash_value, u64 n)
+		{
+			_wyhash_mum(&hash_value, &n);
+			return n;
+		}
+
+		//the hashers of the trivial types are the identity so the hash is mixed before it's used, the bucket and the
+		//position of a key come from two independent mixes, otherwise the keys of a bucket share their high bits and
+		//move together when the pilot changes.
+		//the bucket is mixed twice since one multiply spreads sequential keys too evenly, the placement relies on the
+		//random bucket sizes to leave enough single key buckets to fill the last free slots
+		inline static usize
+		_frozen_bucket(usize hash_value, usize buckets_count)
+		{
+			u64 bucket_hash = _wyhash_mix(hash_value ^ WYHASH_SECRET[0], WYHASH_SECRET[1]);
+			return _frozen_reduce(_wyhash_mix(bucket_hash ^ WYHASH_SECRET[2], WYHASH_SECRET[0]), buckets_count);
+		}
+
+		inline static u64
+		_frozen_position_hash(usize hash_value)
+		{
+			return _wyhash_mix(hash_value ^ WYHASH_SECRET[2], WYHASH_SECRET[3]);
+		}
+
+		inline static usize
+		_frozen_position(u64 position_hash, u32 pilot, usize count)
+		{
+			u64 pilot_hash = _wyhash_mix(pilot ^ WYHASH_SECRET[1], WYHASH_SECRET[2]);
+			return _frozen_reduce(_wyhash_mix(position_hash ^ pilot_hash, WYHASH_SECRET[3]), count);
+		}
+
+		//reserves the count of the range in the array if the range has a count
+		template<typename TArray, typename TRange>
+		inline static auto
+		_frozen_reserve(TArray& array, const TRange& range, int) -> decltype(range.count(), void())
+		{
+			array.reserve(range.count());
+		}
+
+		template<typename TArray, typename TRange>
+		inline static void
+		_frozen_reserve(TArray&, const TRange&, long)
+		{}
+
+		inline static bool
+		_frozen_write(File& file, const void* ptr, usize size)
+		{
+			byte* it = (byte*)ptr;
+			while(size > 0)
+			{
+				usize written = file.write(make_slice(it, size));
+				if(written == 0 || written > size)
+					return false;
+				it += written;
+				size -= written;
+			}
+			return true;
+		}
+
+		inline static bool
+		_frozen_read(File& file, void* ptr, usize size)
+		{
+			byte* it = (byte*)ptr;
+			while(size > 0)
+			{
+				usize read_size = file.read(make_slice(it, size));
+				if(read_size == 0 || read_size > size)
+					return false;
+				it += read_size;
+				size -= read_size;
+			}
+			return true;
+		}
+	}
+
+	/**
+	 * @brief      An immutable hash map which is built once from a known set of keys using a minimal perfect hash
+	 * The keys are distributed into small buckets, and each bucket gets a pilot value that places all of its keys in
+	 * distinct slots (hash and displace), so the table has exactly one slot per key with no empty slots and a lookup
+	 * is a single probe and a single key compare.
+	 * Building costs about half a microsecond per key so it's meant for the maps which are built at startup and only read.
+	 * The pairs aren't in any specific order.
+	 *
+	 * @tparam     TKey    Type of the keys
+	 * @tparam     TValue  Type of the values
+	 * @tparam     THash   Type of the hash functor
+	 */
+	template<typename TKey, typename TValue,
+			 typename THash = internal::Pair_Hash_Functor<TKey, TValue>>
+	struct Frozen_Hash_Map
+	{
+		/**
+		 * Data type of the frozen hash map
+		 */
+		using Data_Type = internal::Hash_Pair<const TKey, TValue>;
+
+		/**
+		 * Pair type of the pairs waiting to be placed by a build, its key isn't const so it's moved into its slot
+		 */
+		using Pending_Type = internal::Hash_Pair<TKey, TValue>;
+
+		/**
+		 * Const Range Type of the frozen hash map
+		 */
+		using Const_Range_Type = Slice<const Data_Type>;
+
+		/**
+		 * Const Iterator type of this container
+		 */
+		using const_iterator = typename Const_Range_Type::const_iterator;
+
+		/**
+		 * Iterator type of this container, the pairs are immutable
+		 */
+		using iterator = const_iterator;
+
+		/**
+		 * Memory contex used by the container
+		 */
+		Allocator_Trait* _allocator;
+		Owner<u32> _pilots;
+		Owner<Data_Type> _values;
+		THash _hasher;
+
+		/**
+		 * @brief      Constructs an empty frozen hash map that uses the provided memory context for allocation
+		 *
+		 * @param      context  The memory context to use for allocation and freeing
+		 */
+		Frozen_Hash_Map(Allocator_Trait* context = allocator())
+			:_allocator(context),
+			 _hasher(THash())
+		{}
+
+		/**
+		 * @brief      Constructs an empty frozen hash map that uses the provided memory context for allocation
+		 *
+		 * @param[in]  hasher   The hasher functor to use
+		 * @param      context  The memory context to use for allocation and freeing
+		 */
+		Frozen_Hash_Map(const THash& hasher, Allocator_Trait* context = allocator())
+			:_allocator(context),
+			 _hasher(hasher)
+		{}
+
+		/**
+		 * @brief      Copy constructor
+		 *
+		 * @param[in]  other  The other frozen hash map to copy from
+		 */
+		Frozen_Hash_Map(const Frozen_Hash_Map& other)
+			:_allocator(other._allocator),
+			 _hasher(other._hasher)
+		{
+			_copy_tables(other);
+		}
+
+		/**
+		 * @brief      Copy constructor with another memory context
+		 *
+		 * @param[in]  other    The other frozen hash map to copy from
+		 * @param      context  The context to use for memory allocation and freeing
+		 */
+		Frozen_Hash_Map(const Frozen_Hash_Map& other, Allocator_Trait* context)
+			:_allocator(context),
+			 _hasher(other._hasher)
+		{
+			_copy_tables(other);
+		}
+
+		/**
+		 * @brief      Move constructor
+		 *
+		 * @param[in]  other  The other frozen hash map to move from
+		 */
+		Frozen_Hash_Map(Frozen_Hash_Map&& other)
+			:_allocator(std::move(other._allocator)),
+			 _pilots(std::move(other._pilots)),
+			 _values(std::move(other._values)),
+			 _hasher(std::move(other._hasher))
+		{}
+
+		/**
+		 * @brief      Copy assignment operator
+		 *
+		 * @param[in]  other  The other frozen hash map to copy values from
+		 *
+		 * @return     A Reference to this frozen hash map
+		 */
+		Frozen_Hash_Map&
+		operator=(const Frozen_Hash_Map& other)
+		{
+			reset();
+			_allocator = other._allocator;
+			_hasher = other._hasher;
+			_copy_tables(other);
+			return *this;
+		}
+
+		/**
+		 * @brief      Move assignment operator
+		 *
+		 * @param[in]  other  The other frozen hash map to move values from
+		 *
+		 * @return     A Reference to this frozen hash map
+		 */
+		Frozen_Hash_Map&
+		operator=(Frozen_Hash_Map&& other)
+		{
+			reset();
+			_allocator = std::move(other._allocator);
+			_pilots = std::move(other._pilots);
+			_values = std::move(other._values);
+			_hasher = std::move(other._hasher);
+			return *this;
+		}
+
+		/**
+		 * @brief      Destroys the frozen hash map
+		 */
+		~Frozen_Hash_Map()
+		{
+			reset();
+		}
+
+		/**
+		 * @brief      Builds the frozen hash map from a range of key-value pairs, any range of values with `key` and `value`
+		 * members works like a Hash_Map, a Dense_Hash_Map or a slice of pairs. if a key is repeated the first pair is kept.
+		 * it panics if two different keys have the same hash value since no pilot can place them apart
+		 *
+		 * @param[in]  pairs   The range of key-value pairs
+		 *
+		 * @tparam     TRange  Type of the range
+		 */
+		template<typename TRange>
+		void
+		build(const TRange& pairs)
+		{
+			Dynamic_Array<Pending_Type> pending(_allocator);
+			internal::_frozen_reserve(pending, pairs, 0);
+			for(const auto& pair: pairs)
+				pending.emplace_back(pair.key, pair.value);
+			_build(pending);
+		}
+
+		/**
+		 * @brief      Builds the frozen hash map from two parallel ranges of keys and values. if a key is repeated
+		 * the first pair is kept. it panics if two different keys have the same hash value
+		 *
+		 * @param[in]  keys    The keys of the map
+		 * @param[in]  values  The values of the keys, it should have the same count as the keys
+		 */
+		void
+		build(const Slice<const TKey>& keys, const Slice<const TValue>& values)
+		{
+			Dynamic_Array<Pending_Type> pending(_allocator);
+			pending.reserve(keys.count());
+			for(usize i = 0; i < keys.count(); ++i)
+				pending.emplace_back(keys[i], values[i]);
+			_build(pending);
+		}
+
+		/**
+		 * @return     The count of values in this frozen hash map, it's also the count of its slots
+		 */
+		usize
+		count() const
+		{
+			return _values.count();
+		}
+
+		/**
+		 * @return     The count of the buckets which have a pilot each
+		 */
+		usize
+		buckets_count() const
+		{
+			return _pilots.count();
+		}
+
+		/**
+		 * @return     Whether the frozen hash map is empty
+		 */
+		bool
+		empty() const
+		{
+			return count() == 0;
+		}
+
+		/**
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     A Const iterator to the found key-value pair, or an iterator to the end if not found
+		 */
+		const_iterator
+		lookup(const TKey& key) const
+		{
+			return begin() + _lookup_index(key);
+		}
+
+		/**
+		 * @brief      Heterogeneous lookup, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 *
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     A Const iterator to the found key-value pair, or an iterator to the end if not found
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		const_iterator
+		lookup(const TLookup& key) const
+		{
+			return begin() + _lookup_index(key);
+		}
+
+		/**
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     Whether the key exists in the frozen hash map
+		 */
+		bool
+		contains(const TKey& key) const
+		{
+			return _lookup_index(key) != count();
+		}
+
+		/**
+		 * @brief      Writes the frozen hash map as a flat byte image, a header followed by the pilots and the pairs as they're
+		 * in memory, so it's only available for trivially copyable keys and values. the image can only be loaded by a map
+		 * of the same types and hasher on a machine with the same endianness
+		 *
+		 * @param      file  The file to write the image into
+		 *
+		 * @return     True if the whole image is written, false otherwise
+		 */
+		bool
+		save(File& file) const
+		{
+			static_assert(std::is_trivially_copyable<TKey>::value && std::is_trivially_copyable<TValue>::value,
+				"Frozen_Hash_Map images can only hold trivially copyable keys and values");
+
+			internal::Frozen_Hash_Header header{};
+			header.magic = internal::FROZEN_HASH_MAGIC;
+			header.version = internal::FROZEN_HASH_VERSION;
+			header.count = count();
+			header.buckets_count = buckets_count();
+			header.pair_size = sizeof(Data_Type);
+
+			return internal::_frozen_write(file, &header, sizeof(header)) &&
+				   internal::_frozen_write(file, _pilots.ptr, _pilots.size) &&
+				   internal::_frozen_write(file, _values.ptr, _values.size);
+		}
+
+		/**
+		 * @brief      Replaces the content of the frozen hash map with an image written by `save`, no hashing is done
+		 *
+		 * @param      file  The file to read the image from, starting at its cursor
+		 *
+		 * @return     True if a valid image is loaded, false otherwise and the frozen hash map is left empty
+		 */
+		bool
+		load(File& file)
+		{
+			static_assert(std::is_trivially_copyable<TKey>::value && std::is_trivially_copyable<TValue>::value,
+				"Frozen_Hash_Map images can only hold trivially copyable keys and values");
+
+			reset();
+
+			internal::Frozen_Hash_Header header{};
+			if(internal::_frozen_read(file, &header, sizeof(header)) == false ||
+			   header.magic != internal::FROZEN_HASH_MAGIC ||
+			   header.version != internal::FROZEN_HASH_VERSION ||
+			   header.pair_size != sizeof(Data_Type) ||
+			   (header.count == 0) != (header.buckets_count == 0))
+				return false;
+
+			if(header.count == 0)
+				return true;
+
+			_pilots = _allocator->template alloc<u32>(header.buckets_count);
+			_values = _allocator->template alloc<Data_Type>(header.count);
+			if(internal::_frozen_read(file, _pilots.ptr, _pilots.size) == false ||
+			   internal::_frozen_read(file, _values.ptr, _values.size) == false)
+			{
+				reset();
+				return false;
+			}
+			return true;
+		}
+
+		/**
+		 * @brief      Removes all the values of the frozen hash map and frees the memory
+		 */
+		void
+		reset()
+		{
+			if(_values)
+				_allocator->destruct(_values);
+			_allocator->template free<u32>(_pilots);
+		}
+
+		/**
+		 * @return     Const range viewing all the key-value pairs
+		 */
+		Const_Range_Type
+		all() const
+		{
+			return _values.all();
+		}
+
+		/**
+		 * @return     A Const iterator to the beginning of this container
+		 */
+		const_iterator
+		begin() const
+		{
+			return _values.ptr;
+		}
+
+		/**
+		 * @return     A Const iterator to the beginning of this container
+		 */
+		const_iterator
+		cbegin() const
+		{
+			return _values.ptr;
+		}
+
+		/**
+		 * @return     A Const Iterator to the end of the container
+		 */
+		const_iterator
+		end() const
+		{
+			return _values.ptr + count();
+		}
+
+		/**
+		 * @return     A Const Iterator to the end of the container
+		 */
+		const_iterator
+		cend() const
+		{
+			return _values.ptr + count();
+		}
+
+		void
+		_copy_tables(const Frozen_Hash_Map& other)
+		{
+			if(other.empty())
+				return;
+
+			_pilots = _allocator->template alloc<u32>(other._pilots.count());
+			copy(_pilots, other._pilots);
+			_values = _allocator->template alloc<Data_Type>(other.count());
+			for(usize i = 0; i < other.count(); ++i)
+				::new (_values.ptr + i) Data_Type(other._values[i]);
+		}
+
+		//one probe, the pilot of the key's bucket gives its slot directly
+		template<typename TLookup>
+		usize
+		_lookup_index(const TLookup& key) const
+		{
+			usize n = count();
+			if(n == 0)
+				return n;
+
+			usize hash_value = _hasher(key);
+			u32 pilot = _pilots[internal::_frozen_bucket(hash_value, _pilots.count())];
+			usize index = internal::_frozen_position(internal::_frozen_position_hash(hash_value), pilot, n);
+			if(_values[index].key == key)
+				return index;
+			return n;
+		}
+
+		//hash and displace, the buckets are grouped then placed from the largest to the smallest one since the large
+		//buckets are the hardest to place, each bucket tries the pilots from 0 until all of its keys land in free slots
+		void
+		_build(Dynamic_Array<Pending_Type>& pending)
+		{
+			reset();
+			usize pending_count = pending.count();
+			if(pending_count == 0)
+				return;
+
+			usize buckets = pending_count / internal::FROZEN_HASH_BUCKET_SIZE + 1;
+			Owner<u64> hashes = _allocator->template alloc<u64>(pending_count);
+			Owner<usize> bucket_starts = _allocator->template alloc<usize>(buckets + 1);
+			Owner<usize> bucket_sizes = _allocator->template alloc<usize>(buckets);
+			Owner<usize> order = _allocator->template alloc<usize>(pending_count);
+			std::memset(bucket_starts.ptr, 0, bucket_starts.size);
+			std::memset(bucket_sizes.ptr, 0, bucket_sizes.size);
+
+			//counting sort of the keys by their buckets
+			for(usize i = 0; i < pending_count; ++i)
+			{
+				usize hash_value = _hasher(pending[i].key);
+				hashes[i] = internal::_frozen_position_hash(hash_value);
+				order[i] = internal::_frozen_bucket(hash_value, buckets);
+				++bucket_starts[order[i] + 1];
+			}
+			for(usize i = 0; i < buckets; ++i)
+				bucket_starts[i + 1] += bucket_starts[i];
+
+			Owner<usize> key_buckets = std::move(order);
+			order = _allocator->template alloc<usize>(pending_count);
+			for(usize i = 0; i < pending_count; ++i)
+			{
+				usize bucket = key_buckets[i];
+				order[bucket_starts[bucket] + bucket_sizes[bucket]++] = i;
+			}
+			_allocator->template free<usize>(key_buckets);
+
+			//the repeated keys end up in the same bucket with the same hash, only the first one is kept
+			usize n = 0, max_bucket_size = 0;
+			for(usize bucket = 0; bucket < buckets; ++bucket)
+			{
+				usize start = bucket_starts[bucket], size = 0;
+				for(usize i = start; i < bucket_starts[bucket + 1]; ++i)
+				{
+					bool repeated = false;
+					for(usize j = start; j < start + size && repeated == false; ++j)
+					{
+						if(hashes[order[j]] != hashes[order[i]])
+							continue;
+						if((pending[order[j]].key == pending[order[i]].key) == false)
+							panic("Frozen_Hash_Map: two different keys have the same hash value");
+						repeated = true;
+					}
+					if(repeated == false)
+						order[start + size++] = order[i];
+				}
+				bucket_sizes[bucket] = size;
+				n += size;
+				if(size > max_bucket_size)
+					max_bucket_size = size;
+			}
+
+			//counting sort of the buckets by their sizes in descending order
+			Owner<usize> size_starts = _allocator->template alloc<usize>(max_bucket_size + 2);
+			Owner<usize> bucket_order = _allocator->template alloc<usize>(buckets);
+			std::memset(size_starts.ptr, 0, size_starts.size);
+			for(usize bucket = 0; bucket < buckets; ++bucket)
+				++size_starts[max_bucket_size - bucket_sizes[bucket] + 1];
+			for(usize i = 0; i <= max_bucket_size; ++i)
+				size_starts[i + 1] += size_starts[i];
+			for(usize bucket = 0; bucket < buckets; ++bucket)
+				bucket_order[size_starts[max_bucket_size - bucket_sizes[bucket]]++] = bucket;
+
+			_pilots = _allocator->template alloc<u32>(buckets);
+			_values = _allocator->template alloc<Data_Type>(n);
+			std::memset(_pilots.ptr, 0, _pilots.size);
+
+			Owner<u64> taken = _allocator->template alloc<u64>((n + 63) / 64);
+			Owner<usize> positions = _allocator->template alloc<usize>(max_bucket_size);
+			std::memset(taken.ptr, 0, taken.size);
+
+			for(usize b = 0; b < buckets; ++b)
+			{
+				usize bucket = bucket_order[b];
+				usize start = bucket_starts[bucket], size = bucket_sizes[bucket];
+				if(size == 0)
+					break;
+
+				for(u64 pilot = 0; ; ++pilot)
+				{
+					if(pilot > 0xFFFFFFFF)
+						panic("Frozen_Hash_Map: couldn't find a pilot for a bucket");
+
+					usize placed = 0;
+					for(; placed < size; ++placed)
+					{
+						usize position = internal::_frozen_position(hashes[order[start + placed]], static_cast<u32>(pilot), n);
+						if(taken[position / 64] & (1ULL << (position % 64)))
+							break;
+						taken[position / 64] |= 1ULL << (position % 64);
+						positions[placed] = position;
+					}
+
+					if(placed == size)
+					{
+						_pilots[bucket] = static_cast<u32>(pilot);
+						break;
+					}
+
+					for(usize i = 0; i < placed; ++i)
+						taken[positions[i] / 64] &= ~(1ULL << (positions[i] % 64));
+				}
+
+				for(usize i = 0; i < size; ++i)
+				{
+					auto& pair = pending[order[start + i]];
+					::new (_values.ptr + positions[i]) Data_Type(internal::Hash_Emplace_Tag(), std::move(pair.key), std::move(pair.value));
+				}
+			}
+
+			_allocator->template free<u64>(hashes);
+			_allocator->template free<usize>(bucket_starts);
+			_allocator->template free<usize>(bucket_sizes);
+			_allocator->template free<usize>(order);
+			_allocator->template free<usize>(size_starts);
+			_allocator->template free<usize>(bucket_order);
+			_allocator->template free<u64>(taken);
+			_allocator->template free<usize>(positions);
+		}
+	};
+}
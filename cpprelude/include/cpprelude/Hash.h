@@ -2,6 +2,11 @@
 
 #include "cpprelude/defines.h"
 #include "cpprelude/Ranges.h"
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
 
 namespace cppr
 {
@@ -121,6 +126,64 @@ namespace cppr
 				return hash;
 			}
 		};
+
+		//wyhash final version 4 by Wang Yi, it's released into the public domain
+		constexpr u64 WYHASH_SECRET[4] = {
+			0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+		};
+
+		//64x64 bit multiply, the low half of the 128 bit result is stored in a and the high half in b
+		inline static void
+		_wyhash_mum(u64* a, u64* b)
+		{
+			#if defined(__SIZEOF_INT128__)
+				__uint128_t r = *a;
+				r *= *b;
+				*a = static_cast<u64>(r);
+				*b = static_cast<u64>(r >> 64);
+			#elif defined(_MSC_VER) && defined(_M_X64)
+				*a = _umul128(*a, *b, b);
+			#else
+				u64 ha = *a >> 32, hb = *b >> 32, la = static_cast<u32>(*a), lb = static_cast<u32>(*b);
+				u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+				u64 lo = t + (rm1 << 32);
+				c += lo < t;
+				u64 hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+				*a = lo;
+				*b = hi;
+			#endif
+		}
+
+		inline static u64
+		_wyhash_mix(u64 a, u64 b)
+		{
+			_wyhash_mum(&a, &b);
+			return a ^ b;
+		}
+
+		inline static u64
+		_wyhash_read8(const byte* p)
+		{
+			u64 v;
+			std::memcpy(&v, p, sizeof(v));
+			return v;
+		}
+
+		inline static u64
+		_wyhash_read4(const byte* p)
+		{
+			u32 v;
+			std::memcpy(&v, p, sizeof(v));
+			return v;
+		}
+
+		inline static u64
+		_wyhash_read3(const byte* p, usize k)
+		{
+			return (static_cast<u64>(static_cast<ubyte>(p[0])) << 16) |
+				   (static_cast<u64>(static_cast<ubyte>(p[k >> 1])) << 8) |
+				   static_cast<u64>(static_cast<ubyte>(p[k - 1]));
+		}
 	}
 
 	/**
@@ -196,43 +259,182 @@ namespace cppr
 		return hasher(ptr, len, seed);
 	}
 
+	/**
+	 * @brief      wyhash function implementation, it mixes 16 bytes per 64x64->128 bit multiply and hashes
+	 * long inputs in three independent lanes of 48 bytes which is much faster than murmur hash for long keys
+	 *
+	 * @param[in]  ptr   The pointer to data that will be hashed
+	 * @param[in]  len   The length of the data
+	 * @param[in]  seed  The seed which has default value of `0xc70f6907UL`
+	 *
+	 * @return   The hashed value which is of type `usize`
+	 */
+	inline static usize
+	wyhash(const void* ptr, usize len, u64 seed = 0xc70f6907UL)
+	{
+		using namespace internal;
+
+		const byte* p = static_cast<const byte*>(ptr);
+		seed ^= _wyhash_mix(seed ^ WYHASH_SECRET[0], WYHASH_SECRET[1]);
+
+		u64 a, b;
+		if(len <= 16)
+		{
+			if(len >= 4)
+			{
+				a = (_wyhash_read4(p) << 32) | _wyhash_read4(p + ((len >> 3) << 2));
+				b = (_wyhash_read4(p + len - 4) << 32) | _wyhash_read4(p + len - 4 - ((len >> 3) << 2));
+			}
+			else if(len > 0)
+			{
+				a = _wyhash_read3(p, len);
+				b = 0;
+			}
+			else
+			{
+				a = b = 0;
+			}
+		}
+		else
+		{
+			usize i = len;
+			if(i > 48)
+			{
+				u64 see1 = seed, see2 = seed;
+				do
+				{
+					seed = _wyhash_mix(_wyhash_read8(p) ^ WYHASH_SECRET[1], _wyhash_read8(p + 8) ^ seed);
+					see1 = _wyhash_mix(_wyhash_read8(p + 16) ^ WYHASH_SECRET[2], _wyhash_read8(p + 24) ^ see1);
+					see2 = _wyhash_mix(_wyhash_read8(p + 32) ^ WYHASH_SECRET[3], _wyhash_read8(p + 40) ^ see2);
+					p += 48;
+					i -= 48;
+				}while(i > 48);
+				seed ^= see1 ^ see2;
+			}
+
+			while(i > 16)
+			{
+				seed = _wyhash_mix(_wyhash_read8(p) ^ WYHASH_SECRET[1], _wyhash_read8(p + 8) ^ seed);
+				i -= 16;
+				p += 16;
+			}
+
+			a = _wyhash_read8(p + i - 16);
+			b = _wyhash_read8(p + i - 8);
+		}
+
+		a ^= WYHASH_SECRET[1];
+		b ^= seed;
+		_wyhash_mum(&a, &b);
+		return static_cast<usize>(_wyhash_mix(a ^ WYHASH_SECRET[0] ^ len, b ^ WYHASH_SECRET[1]));
+	}
+
+	/**
+	 * @brief      HASH_ALGORITHM enum, the algorithm used to hash bytes
+	 *
+	 * - **MURMUR**: MurmurHash2 variant
+	 * - **WYHASH**: wyhash
+	 */
+	enum class HASH_ALGORITHM
+	{
+		MURMUR,
+		WYHASH
+	};
+
+	/**
+	 * The algorithm used by the byte hash functors by default
+	 */
+	constexpr HASH_ALGORITHM DEFAULT_HASH_ALGORITHM = HASH_ALGORITHM::WYHASH;
+
+	/**
+	 * @brief      Hashes the given bytes with the given algorithm
+	 *
+	 * @param[in]  ptr        The pointer to data that will be hashed
+	 * @param[in]  len        The length of the data
+	 * @param[in]  algorithm  The hash algorithm to use
+	 *
+	 * @return   The hashed value which is of type `usize`
+	 */
+	inline static usize
+	hash_bytes(const void* ptr, usize len, HASH_ALGORITHM algorithm = DEFAULT_HASH_ALGORITHM)
+	{
+		switch(algorithm)
+		{
+			case HASH_ALGORITHM::MURMUR:
+				return murmur_hash(ptr, len);
+			case HASH_ALGORITHM::WYHASH:
+			default:
+				return wyhash(ptr, len);
+		}
+	}
+
+	/**
+	 * @brief      Slice hash functor, it hashes the underlying bytes with the selected algorithm
+	 */
 	template<typename T>
 	struct Hash<Slice<T>>
 	{
+		HASH_ALGORITHM algorithm;
+
+		Hash(HASH_ALGORITHM hash_algorithm = DEFAULT_HASH_ALGORITHM)
+			:algorithm(hash_algorithm)
+		{}
+
 		inline usize
 		operator()(const Slice<T>& data) const
 		{
-			return murmur_hash(data.ptr, data.size);
+			return hash_bytes(data.ptr, data.size, algorithm);
 		}
 	};
 
+	/**
+	 * @brief      String range hash functor, it hashes the underlying bytes with the selected algorithm
+	 */
 	template<>
 	struct Hash<String_Range>
 	{
+		HASH_ALGORITHM algorithm;
+
+		Hash(HASH_ALGORITHM hash_algorithm = DEFAULT_HASH_ALGORITHM)
+			:algorithm(hash_algorithm)
+		{}
+
 		inline usize
 		operator()(const String_Range& data) const
 		{
-			return murmur_hash(data.data(), data.size());
+			return hash_bytes(data.data(), data.size(), algorithm);
 		}
 	};
 
 	template<>
 	struct Hash<r32>
 	{
+		HASH_ALGORITHM algorithm;
+
+		Hash(HASH_ALGORITHM hash_algorithm = DEFAULT_HASH_ALGORITHM)
+			:algorithm(hash_algorithm)
+		{}
+
 		inline usize
 		operator()(r32 value) const
 		{
-			return value != 0.0f ? murmur_hash(&value, sizeof(r32)) : 0;
+			return value != 0.0f ? hash_bytes(&value, sizeof(r32), algorithm) : 0;
 		}
 	};
 
 	template<>
 	struct Hash<r64>
 	{
+		HASH_ALGORITHM algorithm;
+
+		Hash(HASH_ALGORITHM hash_algorithm = DEFAULT_HASH_ALGORITHM)
+			:algorithm(hash_algorithm)
+		{}
+
 		inline usize
 		operator()(r64 value) const
 		{
-			return value != 0.0f ? murmur_hash(&value, sizeof(r64)) : 0;
+			return value != 0.0f ? hash_bytes(&value, sizeof(r64), algorithm) : 0;
 		}
 	};
 
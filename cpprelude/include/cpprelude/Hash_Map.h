@@ -5,18 +5,412 @@
 #include "cpprelude/Owner.h"
 #include "cpprelude/Hash.h"
 #include <cstring>
+#include <type_traits>
+
+#if defined(CPPR_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(OS_WINDOWS)
+#include <intrin.h>
+#endif
 
 namespace cppr
 {
 	namespace internal
 	{
+		/**
+		 * Control byte of a hash table slot, a used slot holds the lowest 7 bits of the value hash
+		 * so its sign bit is clear, while the empty and deleted slots have it set
+		 */
 		enum HASH_FLAGS : u8
 		{
-			EMPTY = 0,
-			USED = 1,
-			DELETED = 2
+			EMPTY = 0x80,
+			DELETED = 0xFE
+		};
+
+		inline static bool
+		_hash_flag_used(HASH_FLAGS flag)
+		{
+			return (flag & 0x80) == 0;
+		}
+
+		/**
+		 * The count of control bytes that are probed at once
+		 */
+		constexpr usize HASH_GROUP_WIDTH = 16;
+
+		/**
+		 * The count of control bytes cloned past the end of the table so that a group can be loaded
+		 * from any slot without wrapping around
+		 */
+		constexpr usize HASH_CLONED_FLAGS = HASH_GROUP_WIDTH - 1;
+
+		inline static usize
+		_hash_bit_index(u32 mask)
+		{
+			#if defined(OS_WINDOWS)
+				unsigned long index;
+				_BitScanForward(&index, mask);
+				return index;
+			#elif defined(OS_LINUX)
+				return __builtin_ctz(mask);
+			#endif
+		}
+
+		inline static usize
+		_hash_leading_zeros(u32 mask)
+		{
+			#if defined(OS_WINDOWS)
+				unsigned long index;
+				_BitScanReverse(&index, mask);
+				return HASH_GROUP_WIDTH - 1 - index;
+			#elif defined(OS_LINUX)
+				return __builtin_clz(mask) - (32 - HASH_GROUP_WIDTH);
+			#endif
+		}
+
+		/**
+		 * A group of consecutive control bytes which are matched at once, bit `i` of a match
+		 * mask refers to the `i`th control byte of the group
+		 */
+		struct Hash_Group
+		{
+			#if defined(CPPR_SSE2)
+			__m128i ctrl;
+
+			explicit Hash_Group(const HASH_FLAGS* flags)
+				:ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(flags)))
+			{}
+
+			inline u32
+			match(u8 h2) const
+			{
+				return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(h2)), ctrl));
+			}
+
+			inline u32
+			match_empty_or_deleted() const
+			{
+				return _mm_movemask_epi8(ctrl);
+			}
+			#else
+			const HASH_FLAGS* ctrl;
+
+			explicit Hash_Group(const HASH_FLAGS* flags)
+				:ctrl(flags)
+			{}
+
+			inline u32
+			match(u8 h2) const
+			{
+				u32 result = 0;
+				for(usize i = 0; i < HASH_GROUP_WIDTH; ++i)
+					if(ctrl[i] == h2)
+						result |= 1 << i;
+				return result;
+			}
+
+			inline u32
+			match_empty_or_deleted() const
+			{
+				u32 result = 0;
+				for(usize i = 0; i < HASH_GROUP_WIDTH; ++i)
+					if(!_hash_flag_used(ctrl[i]))
+						result |= 1 << i;
+				return result;
+			}
+			#endif
+
+			inline u32
+			match_empty() const
+			{
+				return match(HASH_FLAGS::EMPTY);
+			}
 		};
 
+		/**
+		 * @brief      Fibonacci hashing mixer, the multiplication moves the entropy of the hash into
+		 * the high bits which are then folded back into the low bits, so weak hashes (like the identity
+		 * hash of integers) still spread over the table when it's indexed with a mask
+		 */
+		inline static usize
+		_hash_mix(usize hash_value)
+		{
+			u64 mixed = static_cast<u64>(hash_value) * 0x9E3779B97F4A7C15ULL;
+			return static_cast<usize>(mixed ^ (mixed >> 32));
+		}
+
+		//the mixed hash selects the starting slot and its lowest 7 bits are kept in the control byte
+		inline static usize
+		_hash_h1(usize hash_value)
+		{
+			return _hash_mix(hash_value) >> 7;
+		}
+
+		inline static u8
+		_hash_h2(usize hash_value)
+		{
+			return static_cast<u8>(_hash_mix(hash_value) & 0x7F);
+		}
+
+		/**
+		 * Load factor limits of the tables, at least one slot must stay empty so the probing stops
+		 */
+		constexpr r32 HASH_DEFAULT_MAX_LOAD_FACTOR = 0.5f;
+		constexpr r32 HASH_MIN_LOAD_FACTOR = 0.125f;
+		constexpr r32 HASH_MAX_LOAD_FACTOR = 0.9375f;
+
+		/**
+		 * @return     The smallest power of two capacity which fits the given count under the given load factor
+		 */
+		inline static usize
+		_hash_capacity_for(usize count, r32 load_factor)
+		{
+			usize result = HASH_GROUP_WIDTH;
+			while(static_cast<usize>(result * load_factor) < count)
+				result <<= 1;
+			return result;
+		}
+
+		inline static void
+		_hash_set_flag(HASH_FLAGS* flags, usize cap, usize index, HASH_FLAGS value)
+		{
+			flags[index] = value;
+			if(index < HASH_CLONED_FLAGS)
+				flags[cap + index] = value;
+		}
+
+		/**
+		 * @brief      Searches the probe sequence of the given hash for a slot which satisfies the predicate
+		 *
+		 * @param[in]  flags      The control bytes of the table
+		 * @param[in]  cap        The capacity of the table
+		 * @param[in]  hash_value The hash of the value to search for
+		 * @param[in]  equal      Predicate which is called with the index of the slots with a matching control byte
+		 *
+		 * @return     The index of the found slot, or `cap` if not found
+		 */
+		template<typename TEqual>
+		inline usize
+		_hash_find(const HASH_FLAGS* flags, usize cap, usize hash_value, TEqual&& equal)
+		{
+			if(cap == 0) return cap;
+
+			//the capacity is a power of two so the probe wraps around with a mask
+			usize mask = cap - 1;
+			u8 h2 = _hash_h2(hash_value);
+			usize pos = _hash_h1(hash_value) & mask;
+
+			//group probing, we stop at the first group which has an empty slot
+			for(usize probed = 0; probed < cap; probed += HASH_GROUP_WIDTH)
+			{
+				Hash_Group group(flags + pos);
+				for(u32 match = group.match(h2); match != 0; match &= match - 1)
+				{
+					usize index = (pos + _hash_bit_index(match)) & mask;
+					if(equal(index))
+						return index;
+				}
+
+				if(group.match_empty() != 0)
+					return cap;
+
+				pos = (pos + HASH_GROUP_WIDTH) & mask;
+			}
+			return cap;
+		}
+
+		/**
+		 * @return     The index of the first empty or deleted slot in the probe sequence of the given hash
+		 */
+		inline static usize
+		_hash_find_free(const HASH_FLAGS* flags, usize cap, usize hash_value)
+		{
+			if(cap == 0) return cap;
+
+			usize mask = cap - 1;
+			usize pos = _hash_h1(hash_value) & mask;
+			for(usize probed = 0; probed < cap; probed += HASH_GROUP_WIDTH)
+			{
+				u32 match = Hash_Group(flags + pos).match_empty_or_deleted();
+				if(match != 0)
+				{
+					return (pos + _hash_bit_index(match)) & mask;
+				}
+
+				pos = (pos + HASH_GROUP_WIDTH) & mask;
+			}
+			return cap;
+		}
+
+		/**
+		 * @brief      Marks the given slot as removed
+		 * If every group that contains the slot has an empty slot then no probe sequence could have
+		 * passed over it, so it's marked as empty instead of leaving a deleted marker behind
+		 */
+		inline static bool
+		_hash_erase_flag(HASH_FLAGS* flags, usize cap, usize index)
+		{
+			usize index_before = (index - HASH_GROUP_WIDTH) & (cap - 1);
+			u32 empty_before = Hash_Group(flags + index_before).match_empty();
+			u32 empty_after = Hash_Group(flags + index).match_empty();
+
+			bool was_never_full = empty_before != 0 && empty_after != 0 &&
+				(_hash_bit_index(empty_after) + _hash_leading_zeros(empty_before)) < HASH_GROUP_WIDTH;
+
+			_hash_set_flag(flags, cap, index, was_never_full ? HASH_FLAGS::EMPTY : HASH_FLAGS::DELETED);
+			return !was_never_full;
+		}
+
+		/**
+		 * @brief      Prepares the control bytes for an in place rehash
+		 * The deleted slots become empty and the used slots become deleted which marks them as not yet rehashed
+		 */
+		inline static void
+		_hash_prepare_rehash_in_place(HASH_FLAGS* flags, usize cap)
+		{
+			for(usize i = 0; i < cap; ++i)
+				flags[i] = _hash_flag_used(flags[i]) ? HASH_FLAGS::DELETED : HASH_FLAGS::EMPTY;
+			std::memcpy(flags + cap, flags, HASH_CLONED_FLAGS);
+		}
+
+		/**
+		 * @return     Whether the two slots are in the same probe group of the given hash
+		 */
+		inline static bool
+		_hash_same_group(usize cap, usize hash_value, usize a, usize b)
+		{
+			usize mask = cap - 1;
+			usize probe_start = _hash_h1(hash_value) & mask;
+			return ((a - probe_start) & mask) / HASH_GROUP_WIDTH ==
+				   ((b - probe_start) & mask) / HASH_GROUP_WIDTH;
+		}
+
+		/**
+		 * The maximum probe distance stored in a control byte in robin hood mode, bigger distances
+		 * saturate to it and are recomputed from the hash when needed
+		 */
+		constexpr u8 HASH_MAX_DISTANCE = 0x7F;
+
+		inline static u8
+		_robin_hood_distance(usize distance)
+		{
+			return distance < HASH_MAX_DISTANCE ? static_cast<u8>(distance) : HASH_MAX_DISTANCE;
+		}
+
+		/**
+		 * @brief      Searches the robin hood probe sequence of the given hash for a slot which satisfies the predicate
+		 * In robin hood mode the control byte of a used slot holds its distance from its home slot,
+		 * so the search stops at the first slot which is closer to its home than we are to ours
+		 *
+		 * @return     The index of the found slot, or `cap` if not found
+		 */
+		template<typename TEqual>
+		inline usize
+		_robin_hood_find(const HASH_FLAGS* flags, usize cap, usize hash_value, TEqual&& equal)
+		{
+			if(cap == 0) return cap;
+
+			usize mask = cap - 1;
+			usize index = _hash_h1(hash_value) & mask;
+			for(usize distance = 0; distance <= cap; ++distance)
+			{
+				u8 flag = flags[index];
+				u8 expected = _robin_hood_distance(distance);
+				if(flag == HASH_FLAGS::EMPTY || flag < expected)
+					return cap;
+
+				//only the slots with the same distance share our home slot
+				if(flag == expected && equal(index))
+					return index;
+
+				index = (index + 1) & mask;
+			}
+			return cap;
+		}
+
+		/**
+		 * @brief      Makes room for a new value with the given hash and returns its index
+		 * The values after the insertion slot are shifted forward one slot until the first empty slot,
+		 * which is equivalent to the robin hood swapping but moves each value only once
+		 *
+		 * @param      hashes  The cached hashes of the values which are shifted with them, or nullptr if not cached
+		 */
+		template<typename T>
+		inline usize
+		_robin_hood_insert_index(HASH_FLAGS* flags, T* values, usize* hashes, usize cap, usize hash_value)
+		{
+			usize mask = cap - 1;
+			usize index = _hash_h1(hash_value) & mask;
+			usize distance = 0;
+			while(flags[index] != HASH_FLAGS::EMPTY &&
+				  flags[index] >= _robin_hood_distance(distance))
+			{
+				index = (index + 1) & mask;
+				++distance;
+			}
+
+			if(flags[index] != HASH_FLAGS::EMPTY)
+			{
+				usize last = index;
+				while(flags[last] != HASH_FLAGS::EMPTY)
+					last = (last + 1) & mask;
+
+				while(last != index)
+				{
+					usize prev = (last - 1) & mask;
+					::new (values + last) T(std::move(values[prev]));
+					values[prev].~T();
+					if(hashes)
+						hashes[last] = hashes[prev];
+					flags[last] = HASH_FLAGS(_robin_hood_distance(flags[prev] + 1));
+					last = prev;
+				}
+			}
+
+			flags[index] = HASH_FLAGS(_robin_hood_distance(distance));
+			return index;
+		}
+
+		/**
+		 * @brief      Removes the value at the given index using backward shift deletion
+		 * The values after it are shifted back one slot until an empty slot or a value in its home slot,
+		 * so no deleted markers are left behind
+		 *
+		 * @param      hashes       The cached hashes of the values which are shifted with them, or nullptr if not cached
+		 * @param[in]  distance_of  Function which returns the actual distance of the value at the given index
+		 *                          from its home slot, it's only called for the values with a saturated distance
+		 */
+		template<typename T, typename TDistance>
+		inline void
+		_robin_hood_erase(HASH_FLAGS* flags, T* values, usize* hashes, usize cap, usize index, TDistance&& distance_of)
+		{
+			values[index].~T();
+
+			usize mask = cap - 1;
+			usize next = (index + 1) & mask;
+			while(flags[next] != HASH_FLAGS::EMPTY && flags[next] != 0)
+			{
+				::new (values + index) T(std::move(values[next]));
+				values[next].~T();
+				if(hashes)
+					hashes[index] = hashes[next];
+
+				if(flags[next] == HASH_MAX_DISTANCE)
+					flags[index] = HASH_FLAGS(_robin_hood_distance(distance_of(index)));
+				else
+					flags[index] = HASH_FLAGS(flags[next] - 1);
+
+				index = next;
+				next = (next + 1) & mask;
+			}
+			flags[index] = HASH_FLAGS::EMPTY;
+		}
+
+		//tag which selects the Hash_Pair constructor that constructs the value in place from the given args
+		struct Hash_Emplace_Tag {};
+
 		template<typename TKey, typename TValue>
 		struct Hash_Pair
 		{
@@ -24,15 +418,20 @@ namespace cppr
 			TValue value;
 
 			Hash_Pair()
-				:key(TKey()), value(TValue())
+				:key(), value()
 			{}
 
 			Hash_Pair(const TKey& k)
-				:key(k), value(TValue())
+				:key(k), value()
 			{}
 
 			Hash_Pair(TKey&& k)
-				:key(std::move(k)), value(TValue())
+				:key(std::move(k)), value()
+			{}
+
+			template<typename TKeyArg, typename ... TArgs>
+			Hash_Pair(Hash_Emplace_Tag, TKeyArg&& k, TArgs&& ... args)
+				:key(std::forward<TKeyArg>(k)), value(std::forward<TArgs>(args)...)
 			{}
 
 			Hash_Pair(const TKey& k, const TValue& v)
@@ -65,24 +464,62 @@ namespace cppr
 		};
 
 		template<typename TKey, typename TValue>
-		struct Pair_Hash_Functor
+		struct Pair_Hash_Functor: Hash<TKey>
 		{
+			//inherits the key overloads (and transparency) and the constructors of the key hash
+			using Hash<TKey>::Hash;
+			using Hash<TKey>::operator();
+
+			Pair_Hash_Functor() = default;
+
 			inline usize
 			operator()(const internal::Hash_Pair<const TKey, TValue>& pair) const
 			{
-				Hash<TKey> hasher;
-				return hasher(pair.key);
+				return Hash<TKey>::operator()(pair.key);
 			}
 		};
 	}
 
+	/**
+	 * @brief      Whether the hash containers cache the full hash of each value by default
+	 * It's enabled for the types which aren't trivially copyable (like String) since they are usually
+	 * expensive to hash and compare, specialize it to change the default of a type
+	 *
+	 * @tparam     T     Type of the values (or the keys of a hash map)
+	 */
+	template<typename T>
+	struct Hash_Cache_Default
+	{
+		constexpr static bool value = !std::is_trivially_copyable<T>::value;
+	};
+
+	/**
+	 * @brief      HASH_PROBING enum
+	 *
+	 * - **SWISS**: control bytes hold 7 bits of the hash and are probed in groups of 16, removal may leave deleted markers
+	 * - **ROBIN_HOOD**: control bytes hold the probe distances and removal shifts the values back, so there are no deleted markers
+	 *   and the probe sequences stay short under heavy insert/remove churn
+	 */
+	enum class HASH_PROBING
+	{
+		SWISS,
+		ROBIN_HOOD
+	};
+
 	/**
 	 * @brief      A Hash set container
+	 * It's an open addressing table with a control byte per slot which holds 7 bits of the value hash,
+	 * the control bytes are probed in groups of 16 (using SSE2 when available) so the values are only
+	 * compared when their control bytes match
 	 *
-	 * @tparam     T      Values type in the hash set
-	 * @tparam     THash  Type of the hash functor
+	 * @tparam     T           Values type in the hash set
+	 * @tparam     THash       Type of the hash functor
+	 * @tparam     PROBING     The probing scheme of the hash set
+	 * @tparam     CACHE_HASH  Whether the full hash of each value is stored next to it, so growing never calls
+	 *                         the hasher and the values are only compared when their hashes are equal
 	 */
-	template<typename T, typename THash = Hash<T>>
+	template<typename T, typename THash = Hash<T>, HASH_PROBING PROBING = HASH_PROBING::SWISS,
+			 bool CACHE_HASH = Hash_Cache_Default<T>::value>
 	struct Hash_Set
 	{
 		/**
@@ -116,8 +553,12 @@ namespace cppr
 		Allocator_Trait* _allocator;
 		Owner<Data_Type> _values;
 		Owner<internal::HASH_FLAGS> _flags;
+		Owner<usize> _hashes;
 		THash _hasher;
 		usize _count;
+		usize _capacity;
+		usize _deleted_count;
+		r32 _max_load_factor;
 
 		/**
 		 * @brief      Constructs a hash set that uses the provided memory context for allocation
@@ -127,7 +568,10 @@ namespace cppr
 		Hash_Set(Allocator_Trait* context = allocator())
 			:_allocator(context),
 			 _hasher(THash()),
-			 _count(0)
+			 _count(0),
+			 _capacity(0),
+			 _deleted_count(0),
+			 _max_load_factor(internal::HASH_DEFAULT_MAX_LOAD_FACTOR)
 		{}
 
 		/**
@@ -139,7 +583,10 @@ namespace cppr
 		Hash_Set(const THash& hasher, Allocator_Trait* context = allocator())
 			:_allocator(context),
 			 _hasher(hasher),
-			 _count(0)
+			 _count(0),
+			 _capacity(0),
+			 _deleted_count(0),
+			 _max_load_factor(internal::HASH_DEFAULT_MAX_LOAD_FACTOR)
 		{}
 
 		/**
@@ -150,14 +597,23 @@ namespace cppr
 		Hash_Set(const Hash_Set& other)
 			:_allocator(other._allocator),
 			 _hasher(other._hasher),
-			 _count(other._count)
+			 _count(other._count),
+			 _capacity(other._capacity),
+			 _deleted_count(other._deleted_count),
+			 _max_load_factor(other._max_load_factor)
 		{
 			_flags = _allocator->template alloc<internal::HASH_FLAGS>(other._flags.count());
 			move(_flags, other._flags);
 
+			if(CACHE_HASH)
+			{
+				_hashes = _allocator->template alloc<usize>(other._hashes.count());
+				move(_hashes, other._hashes);
+			}
+
 			_values = _allocator->template alloc<Data_Type>(other._values.count());
-			for(usize i = 0; i < _flags.count(); ++i)
-				if(_flags[i] == internal::HASH_FLAGS::USED)
+			for(usize i = 0; i < _capacity; ++i)
+				if(internal::_hash_flag_used(_flags[i]))
 					::new (_values.ptr + i) Data_Type(other._values[i]);
 		}
 
@@ -170,14 +626,23 @@ namespace cppr
 		Hash_Set(const Hash_Set& other, Allocator_Trait* context)
 			:_allocator(context),
 			 _hasher(other._hasher),
-			 _count(other._count)
+			 _count(other._count),
+			 _capacity(other._capacity),
+			 _deleted_count(other._deleted_count),
+			 _max_load_factor(other._max_load_factor)
 		{
 			_flags = _allocator->template alloc<internal::HASH_FLAGS>(other._flags.count());
 			move(_flags, other._flags);
 
+			if(CACHE_HASH)
+			{
+				_hashes = _allocator->template alloc<usize>(other._hashes.count());
+				move(_hashes, other._hashes);
+			}
+
 			_values = _allocator->template alloc<Data_Type>(other._values.count());
-			for(usize i = 0; i < other._flags.count(); ++i)
-				if(other._flags[i] == internal::HASH_FLAGS::USED)
+			for(usize i = 0; i < _capacity; ++i)
+				if(internal::_hash_flag_used(other._flags[i]))
 					::new (_values.ptr + i) Data_Type(other._values[i]);
 		}
 
@@ -190,10 +655,16 @@ namespace cppr
 			:_allocator(std::move(other._allocator)),
 			 _values(std::move(other._values)),
 			 _flags(std::move(other._flags)),
+			 _hashes(std::move(other._hashes)),
 			 _hasher(std::move(other._hasher)),
-			 _count(other._count)
+			 _count(other._count),
+			 _capacity(other._capacity),
+			 _deleted_count(other._deleted_count),
+			 _max_load_factor(other._max_load_factor)
 		{
 			other._count = 0;
+			other._capacity = 0;
+			other._deleted_count = 0;
 		}
 
 		/**
@@ -206,41 +677,44 @@ namespace cppr
 		Hash_Set&
 		operator=(const Hash_Set& other)
 		{
-			if(_flags.count() < other._flags.count())
+			//the slot of each value depends on the capacity so we copy the same layout
+			if(_capacity != other._capacity)
 			{
 				reset();
 				_flags = _allocator->template alloc<internal::HASH_FLAGS>(other._flags.count());
 				_values = _allocator->template alloc<Data_Type>(other._values.count());
+				if(CACHE_HASH)
+					_hashes = _allocator->template alloc<usize>(other._hashes.count());
+				_capacity = other._capacity;
 			}
 			else
 			{
-				for(usize i = 0; i < _flags.count(); ++i)
-				{
-					if(_flags[i] == internal::HASH_FLAGS::USED)
-					{
+				for(usize i = 0; i < _capacity; ++i)
+					if(internal::_hash_flag_used(_flags[i]))
 						_values[i].~Data_Type();
-						_flags[i] = internal::HASH_FLAGS::EMPTY;
-					}
-				}
 			}
 
 			_hasher = other._hasher;
 			_allocator = other._allocator;
 
 			move(_flags, other._flags);
-			for(usize i = 0; i < _flags.count(); ++i)
+			if(CACHE_HASH)
+				move(_hashes, other._hashes);
+			for(usize i = 0; i < _capacity; ++i)
 			{
-				if(_flags[i] == internal::HASH_FLAGS::USED)
+				if(internal::_hash_flag_used(_flags[i]))
 					::new (_values.ptr + i) Data_Type(other._values[i]);
 			}
 
 			_count = other._count;
+			_deleted_count = other._deleted_count;
+			_max_load_factor = other._max_load_factor;
 			return *this;
 		}
 
 		/**
 		 * @brief      Move assignment operator
-		 *             
+		 *
 		 * @param[in]  other  The other hash set to move values from
 		 *
 		 * @return     A Reference to this hash set
@@ -252,10 +726,16 @@ namespace cppr
 			_allocator = std::move(other._allocator);
 			_values = std::move(other._values);
 			_flags = std::move(other._flags);
+			_hashes = std::move(other._hashes);
 			_hasher = std::move(other._hasher);
 			_count = other._count;
+			_capacity = other._capacity;
+			_deleted_count = other._deleted_count;
+			_max_load_factor = other._max_load_factor;
 
 			other._count = 0;
+			other._capacity = 0;
+			other._deleted_count = 0;
 			return *this;
 		}
 
@@ -273,7 +753,7 @@ namespace cppr
 		usize
 		capacity() const
 		{
-			return _flags.count();
+			return _capacity;
 		}
 
 		/**
@@ -294,6 +774,34 @@ namespace cppr
 			return _count == 0;
 		}
 
+		/**
+		 * @return     The max load factor of this hash set
+		 */
+		r32
+		max_load_factor() const
+		{
+			return _max_load_factor;
+		}
+
+		/**
+		 * @brief      Sets the max load factor of the hash set, the hash set grows when its values (and deleted markers)
+		 * exceed this ratio of the capacity, so higher load factors use less memory and lower ones give shorter probes
+		 *
+		 * @param[in]  value  The max load factor, it's clamped to [0.125, 0.9375]
+		 */
+		void
+		max_load_factor(r32 value)
+		{
+			if(value < internal::HASH_MIN_LOAD_FACTOR)
+				value = internal::HASH_MIN_LOAD_FACTOR;
+			else if(value > internal::HASH_MAX_LOAD_FACTOR)
+				value = internal::HASH_MAX_LOAD_FACTOR;
+
+			_max_load_factor = value;
+			if(_count + _deleted_count > _max_count())
+				rehash(_count);
+		}
+
 		/**
 		 * @brief      Ensures that the hash set has the capacity for the expected count
 		 *
@@ -302,36 +810,135 @@ namespace cppr
 		void
 		reserve(usize expected_count)
 		{
-			if(_flags.count() - _count >= expected_count)
+			usize fit = _count + expected_count;
+			if(fit <= _max_count())
 				return;
 
-			usize double_cap = (_flags.count() * 2);
-			usize fit = _count + expected_count;
-			usize new_cap = double_cap > fit ? double_cap : fit;
+			_rehash(internal::_hash_capacity_for(fit, _max_load_factor));
+		}
 
-			auto new_flags = _allocator->template alloc<internal::HASH_FLAGS>(new_cap);
+		/**
+		 * @brief      Rehashes the values into the smallest capacity which fits the expected count under the max load factor
+		 * If the capacity stays the same the values are rehashed in place without allocation, which removes the deleted markers
+		 *
+		 * @param[in]  expected_count  The expected count to fit, it can't be less than the count of values
+		 */
+		void
+		rehash(usize expected_count)
+		{
+			if(expected_count < _count)
+				expected_count = _count;
+
+			usize new_cap = internal::_hash_capacity_for(expected_count, _max_load_factor);
+			if(new_cap == _capacity)
+				_rehash_in_place();
+			else
+				_rehash(new_cap);
+		}
+
+		/**
+		 * @brief      Shrinks the memory of the hash set to the smallest capacity which fits its values
+		 */
+		void
+		shrink_to_fit()
+		{
+			if(_count == 0)
+				reset();
+			else
+				rehash(_count);
+		}
+
+		void
+		_rehash(usize new_cap)
+		{
+			auto new_flags = _allocator->template alloc<internal::HASH_FLAGS>(new_cap + internal::HASH_CLONED_FLAGS);
 			auto new_values = _allocator->template alloc<Data_Type>(new_cap);
+			Owner<usize> new_hashes;
+			if(CACHE_HASH)
+				new_hashes = _allocator->template alloc<usize>(new_cap);
 
-			std::memset(new_flags.ptr, 0, new_flags.size);
+			std::memset(new_flags.ptr, internal::HASH_FLAGS::EMPTY, new_flags.size);
 
 			if (_count != 0)
 			{
-				for (usize i = 0; i < _flags.count(); ++i)
+				for (usize i = 0; i < _capacity; ++i)
 				{
-					if (_flags[i] == internal::HASH_FLAGS::USED)
+					if (internal::_hash_flag_used(_flags[i]))
 					{
-						usize new_index = _find_insertion_index(new_flags, new_values, _values[i]);
-						new_flags[new_index] = internal::HASH_FLAGS::USED;
+						usize hash_value = _hash_of(i);
+						usize new_index = _claim_index(new_flags, new_values, new_hashes, new_cap, hash_value);
 						::new (new_values.ptr + new_index) Data_Type(std::move(_values[i]));
+						_values[i].~Data_Type();
 					}
 				}
 			}
 
 			_allocator->template free<internal::HASH_FLAGS>(_flags);
 			_allocator->template free<Data_Type>(_values);
+			_allocator->template free<usize>(_hashes);
 
 			_flags = std::move(new_flags);
 			_values = std::move(new_values);
+			_hashes = std::move(new_hashes);
+			_capacity = new_cap;
+			_deleted_count = 0;
+		}
+
+		void
+		_rehash_in_place()
+		{
+			//robin hood tables don't have deleted markers
+			if(PROBING == HASH_PROBING::ROBIN_HOOD || _deleted_count == 0)
+				return;
+
+			internal::_hash_prepare_rehash_in_place(_flags.ptr, _capacity);
+			for(usize i = 0; i < _capacity; ++i)
+			{
+				if(_flags[i] != internal::HASH_FLAGS::DELETED)
+					continue;
+
+				usize hash_value = _hash_of(i);
+				usize new_index = internal::_hash_find_free(_flags.ptr, _capacity, hash_value);
+				auto h2 = internal::HASH_FLAGS(internal::_hash_h2(hash_value));
+
+				if(internal::_hash_same_group(_capacity, hash_value, i, new_index))
+				{
+					//the value is already in the first group it can be found in
+					internal::_hash_set_flag(_flags.ptr, _capacity, i, h2);
+				}
+				else if(_flags[new_index] == internal::HASH_FLAGS::EMPTY)
+				{
+					internal::_hash_set_flag(_flags.ptr, _capacity, new_index, h2);
+					::new (_values.ptr + new_index) Data_Type(std::move(_values[i]));
+					_values[i].~Data_Type();
+					if(CACHE_HASH)
+						_hashes[new_index] = hash_value;
+					internal::_hash_set_flag(_flags.ptr, _capacity, i, internal::HASH_FLAGS::EMPTY);
+				}
+				else
+				{
+					//the slot holds a value which wasn't rehashed yet, so we swap them and process this slot again
+					internal::_hash_set_flag(_flags.ptr, _capacity, new_index, h2);
+					Data_Type tmp(std::move(_values[new_index]));
+					_values[new_index].~Data_Type();
+					::new (_values.ptr + new_index) Data_Type(std::move(_values[i]));
+					_values[i].~Data_Type();
+					::new (_values.ptr + i) Data_Type(std::move(tmp));
+					if(CACHE_HASH)
+					{
+						_hashes[i] = _hashes[new_index];
+						_hashes[new_index] = hash_value;
+					}
+					--i;
+				}
+			}
+			_deleted_count = 0;
+		}
+
+		usize
+		_max_count() const
+		{
+			return static_cast<usize>(_capacity * _max_load_factor);
 		}
 
 		/**
@@ -344,16 +951,16 @@ namespace cppr
 		{
 			_maintain_space_complexity();
 
-			usize index = _find_insertion_index(value);
+			usize hash_value = _hasher(value);
+			usize index = _lookup_index(value, hash_value);
 
-			if(_flags[index] == internal::HASH_FLAGS::EMPTY)
+			if(index == _capacity)
 			{
-				_flags[index] = internal::HASH_FLAGS::USED;
+				index = _insert_index(hash_value);
 				::new (_values.ptr + index) Data_Type(value);
-				++_count;
 			}
 
-			return iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
 		}
 
 		/**
@@ -366,16 +973,16 @@ namespace cppr
 		{
 			_maintain_space_complexity();
 
-			usize index = _find_insertion_index(value);
+			usize hash_value = _hasher(value);
+			usize index = _lookup_index(value, hash_value);
 
-			if(_flags[index] == internal::HASH_FLAGS::EMPTY)
+			if(index == _capacity)
 			{
-				_flags[index] = internal::HASH_FLAGS::USED;
+				index = _insert_index(hash_value);
 				::new (_values.ptr + index) Data_Type(std::move(value));
-				++_count;
 			}
 
-			return iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
 		}
 
 		/**
@@ -388,10 +995,10 @@ namespace cppr
 		{
 			auto index = _lookup_index(value);
 
-			if(index == _flags.count())
+			if(index == _capacity)
 				return end();
 
-			return iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
 		}
 
 		/**
@@ -404,10 +1011,74 @@ namespace cppr
 		{
 			auto index = _lookup_index(value);
 
-			if(index == _flags.count())
+			if(index == _capacity)
+				return end();
+
+			return const_iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
+		}
+
+		/**
+		 * @brief      Heterogeneous lookup, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 * like Hash<String> which accepts String_Range, the searched value must have the same hash as the equal values in the set
+		 *
+		 * @param[in]  value  The value to search for
+		 *
+		 * @return     An Iterator to the found value, or an iterator to the end if not found
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		iterator
+		lookup(const TLookup& value)
+		{
+			auto index = _lookup_index(value);
+
+			if(index == _capacity)
+				return end();
+
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
+		}
+
+		/**
+		 * @brief      Heterogeneous lookup, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 *
+		 * @param[in]  value  The value to search for
+		 *
+		 * @return     An Iterator to the found value, or an iterator to the end if not found
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		const_iterator
+		lookup(const TLookup& value) const
+		{
+			auto index = _lookup_index(value);
+
+			if(index == _capacity)
 				return end();
 
-			return const_iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return const_iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
+		}
+
+		/**
+		 * @param[in]  value  The value to search for
+		 *
+		 * @return     Whether the value exists in the hash set
+		 */
+		bool
+		contains(const Data_Type& value) const
+		{
+			return _lookup_index(value) != _capacity;
+		}
+
+		/**
+		 * @brief      Heterogeneous contains, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 *
+		 * @param[in]  value  The value to search for
+		 *
+		 * @return     Whether the value exists in the hash set
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		bool
+		contains(const TLookup& value) const
+		{
+			return _lookup_index(value) != _capacity;
 		}
 
 		/**
@@ -420,12 +1091,30 @@ namespace cppr
 		{
 			auto index = _lookup_index(value);
 
-			if(index == _flags.count())
+			if(index == _capacity)
 				return false;
 
-			_flags[index] = internal::HASH_FLAGS::DELETED;
-			_values[index].~Data_Type();
-			--_count;
+			_remove_index(index);
+			return true;
+		}
+
+		/**
+		 * @brief      Heterogeneous remove, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 *
+		 * @param[in]  value  The value to be removed
+		 *
+		 * @return     True if removed the value, false if the value doesn't exist
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		bool
+		remove(const TLookup& value)
+		{
+			auto index = _lookup_index(value);
+
+			if(index == _capacity)
+				return false;
+
+			_remove_index(index);
 			return true;
 		}
 
@@ -439,12 +1128,10 @@ namespace cppr
 		{
 			usize index = it._flag - _flags.ptr;
 
-			if(index == _flags.count())
+			if(index == _capacity)
 				return false;
 
-			_flags[index] = internal::HASH_FLAGS::DELETED;
-			_values[index].~Data_Type();
-			--_count;
+			_remove_index(index);
 			return true;
 		}
 
@@ -454,17 +1141,16 @@ namespace cppr
 		void
 		clear()
 		{
-			if(_count == 0)
+			if(_capacity == 0)
 				return;
-			for(usize i = 0; i < _flags.count(); ++i)
+			for(usize i = 0; i < _capacity; ++i)
 			{
-				if(_flags[i] == internal::HASH_FLAGS::USED)
-				{
-					_flags[i] = internal::HASH_FLAGS::EMPTY;
+				if(internal::_hash_flag_used(_flags[i]))
 					_values[i].~Data_Type();
-				}
 			}
+			std::memset(_flags.ptr, internal::HASH_FLAGS::EMPTY, _flags.size);
 			_count = 0;
+			_deleted_count = 0;
 		}
 
 		/**
@@ -476,6 +1162,8 @@ namespace cppr
 			clear();
 			_allocator->template free<internal::HASH_FLAGS>(_flags);
 			_allocator->template free<Data_Type>(_values);
+			_allocator->template free<usize>(_hashes);
+			_capacity = 0;
 		}
 
 		/**
@@ -568,10 +1256,10 @@ namespace cppr
 				return end();
 
 			usize ix = 0;
-			for(ix = 0; ix < _flags.count(); ++ix)
-				if(_flags[ix] == internal::HASH_FLAGS::USED)
+			for(ix = 0; ix < _capacity; ++ix)
+				if(internal::_hash_flag_used(_flags[ix]))
 					break;
-			return iterator(_values.ptr + ix, _flags.ptr + ix, _flags.count() - ix);
+			return iterator(_values.ptr + ix, _flags.ptr + ix, _capacity - ix);
 		}
 
 		/**
@@ -584,10 +1272,10 @@ namespace cppr
 				return end();
 
 			usize ix = 0;
-			for(ix = 0; ix < _flags.count(); ++ix)
-				if(_flags[ix] == internal::HASH_FLAGS::USED)
+			for(ix = 0; ix < _capacity; ++ix)
+				if(internal::_hash_flag_used(_flags[ix]))
 					break;
-			return const_iterator(_values.ptr + ix, _flags.ptr + ix, _flags.count() - ix);
+			return const_iterator(_values.ptr + ix, _flags.ptr + ix, _capacity - ix);
 		}
 
 		/**
@@ -600,10 +1288,10 @@ namespace cppr
 				return end();
 
 			usize ix = 0;
-			for(ix = 0; ix < _flags.count(); ++ix)
-				if(_flags[ix] == internal::HASH_FLAGS::USED)
+			for(ix = 0; ix < _capacity; ++ix)
+				if(internal::_hash_flag_used(_flags[ix]))
 					break;
-			return const_iterator(_values.ptr + ix, _flags.ptr + ix, _flags.count() - ix);
+			return const_iterator(_values.ptr + ix, _flags.ptr + ix, _capacity - ix);
 		}
 
 		/**
@@ -612,7 +1300,7 @@ namespace cppr
 		iterator
 		end()
 		{
-			usize ix = _flags.count();
+			usize ix = _capacity;
 			return iterator(_values.ptr + ix, _flags.ptr + ix, 0);
 		}
 
@@ -622,7 +1310,7 @@ namespace cppr
 		const_iterator
 		end() const
 		{
-			usize ix = _flags.count();
+			usize ix = _capacity;
 			return const_iterator(_values.ptr + ix, _flags.ptr + ix, 0);
 		}
 
@@ -632,116 +1320,129 @@ namespace cppr
 		const_iterator
 		cend() const
 		{
-			usize ix = _flags.count();
+			usize ix = _capacity;
 			return const_iterator(_values.ptr + ix, _flags.ptr + ix, 0);
 		}
 
+		//the hash of the value in the given slot, it's read from the cache when the hashes are cached
 		usize
-		_lookup_index(const Owner<internal::HASH_FLAGS>& flags, const Owner<Data_Type>& values,
-					  const Data_Type& value) const
+		_hash_of(usize index) const
 		{
-			usize cap = flags.count();
-			if(cap == 0) return cap;
-
-			usize hash_value = _hasher(value);
-			usize index = hash_value % cap;
-			usize ix = index;
-
-			//linear probing goes here
-			while(true)
-			{
-				//if the cell is empty then we didn't find the value
-				if(flags[ix] == internal::HASH_FLAGS::EMPTY)
-					return cap;
-
-				//if the cell is used and it's the same value then we found it
-				if (flags[ix] == internal::HASH_FLAGS::USED &&
-					values[ix] == value)
-					return ix;
-
-				//increment the index
-				++ix;
-				ix %= cap;
+			if(CACHE_HASH)
+				return _hashes[index];
+			return _hasher(_values[index]);
+		}
 
-				//check if we went full circle
-				if(ix == index)
-					return cap;
-			}
+		template<typename TLookup>
+		usize
+		_lookup_index(const TLookup& value, usize hash_value) const
+		{
+			//with cached hashes the values are only compared when their full hashes are equal
+			auto equal = [&](usize index) {
+				return (!CACHE_HASH || _hashes[index] == hash_value) && _values[index] == value;
+			};
 
-			return cap;
+			if(PROBING == HASH_PROBING::ROBIN_HOOD)
+				return internal::_robin_hood_find(_flags.ptr, _capacity, hash_value, equal);
+			else
+				return internal::_hash_find(_flags.ptr, _capacity, hash_value, equal);
 		}
 
+		template<typename TLookup>
 		usize
-		_lookup_index(const Data_Type& value) const
+		_lookup_index(const TLookup& value) const
 		{
-			return _lookup_index(_flags, _values, value);
+			return _lookup_index(value, _hasher(value));
 		}
 
+		//claims a free slot for a new value with the given hash in the given table, the caller constructs the value
 		usize
-		_find_insertion_index(const Owner<internal::HASH_FLAGS>& flags, const Owner<Data_Type>& values,
-							  const Data_Type& value) const
+		_claim_index(const Owner<internal::HASH_FLAGS>& flags, const Owner<Data_Type>& values,
+					 const Owner<usize>& hashes, usize cap, usize hash_value)
 		{
-			usize cap = flags.count();
-			if(cap == 0) return cap;
-
-			usize hash_value = _hasher(value);
-			usize index = hash_value % cap;
-			usize ix = index;
-
-			//linear probing goes here
-			while(true)
+			usize index;
+			if(PROBING == HASH_PROBING::ROBIN_HOOD)
 			{
-				//this is an empty spot or deleted spot then we can use it
-				if (flags[ix] == internal::HASH_FLAGS::EMPTY ||
-					flags[ix] == internal::HASH_FLAGS::DELETED)
-					return ix;
-
-				//the position is not empty but if it's the same value then we return it
-				if(values[ix] == value)
-					return ix;
-
-				//the position is not empty and the value is not the same
-				++ix;
-				ix %= cap;
-
-				//if we went a full circle then we just return the cap to signal no index found
-				if(ix == index)
-					return cap;
+				index = internal::_robin_hood_insert_index(flags.ptr, values.ptr, CACHE_HASH ? hashes.ptr : nullptr,
+														   cap, hash_value);
 			}
-			return cap;
+			else
+			{
+				index = internal::_hash_find_free(flags.ptr, cap, hash_value);
+				if(flags[index] == internal::HASH_FLAGS::DELETED)
+					--_deleted_count;
+				internal::_hash_set_flag(flags.ptr, cap, index, internal::HASH_FLAGS(internal::_hash_h2(hash_value)));
+			}
+
+			if(CACHE_HASH)
+				hashes.ptr[index] = hash_value;
+			return index;
 		}
 
 		usize
-		_find_insertion_index(const Data_Type& value) const
+		_insert_index(usize hash_value)
+		{
+			usize index = _claim_index(_flags, _values, _hashes, _capacity, hash_value);
+			++_count;
+			return index;
+		}
+
+		void
+		_remove_index(usize index)
 		{
-			return _find_insertion_index(_flags, _values, value);
+			if(PROBING == HASH_PROBING::ROBIN_HOOD)
+			{
+				internal::_robin_hood_erase(_flags.ptr, _values.ptr, CACHE_HASH ? _hashes.ptr : nullptr, _capacity, index,
+											[&](usize new_index) {
+					usize home = internal::_hash_h1(_hash_of(new_index));
+					return (new_index - home) & (_capacity - 1);
+				});
+			}
+			else
+			{
+				if(internal::_hash_erase_flag(_flags.ptr, _capacity, index))
+					++_deleted_count;
+				_values[index].~Data_Type();
+			}
+			--_count;
 		}
 
 		void
 		_maintain_space_complexity()
 		{
 			constexpr usize STARTING_COUNT = 8;
-			if (_flags.count() == 0)
+			if (_capacity == 0)
 			{
 				reserve(STARTING_COUNT);
 			}
-			else if (_count > (_flags.count() / 2))
+			else if (_count + _deleted_count >= _max_count())
 			{
-				//reserve another capacity to double it
-				reserve(_flags.count());
+				//if most of the load is deleted markers then purging them is enough, otherwise double the capacity
+				if(_count < _max_count() / 2)
+					_rehash_in_place();
+				else
+					_rehash(_capacity * 2);
 			}
 		}
 	};
 
 	/**
 	 * @brief      A Hash map container
+	 * It's an open addressing table with a control byte per slot which holds 7 bits of the key hash,
+	 * the control bytes are probed in groups of 16 (using SSE2 when available) so the keys are only
+	 * compared when their control bytes match
 	 *
-	 * @tparam     TKey    Type of the keys
-	 * @tparam     TValue  Type of the values
-	 * @tparam     THash   Type of the hash functor
+	 * @tparam     TKey        Type of the keys
+	 * @tparam     TValue      Type of the values
+	 * @tparam     THash       Type of the hash functor
+	 * @tparam     PROBING     The probing scheme of the hash map
+	 * @tparam     CACHE_HASH  Whether the full hash of each key is stored next to it, so growing never calls
+	 *                         the hasher and the keys are only compared when their hashes are equal
 	 */
 	template<typename TKey, typename TValue,
-			 typename THash = internal::Pair_Hash_Functor<TKey, TValue>>
+			 typename THash = internal::Pair_Hash_Functor<TKey, TValue>,
+			 HASH_PROBING PROBING = HASH_PROBING::SWISS,
+			 bool CACHE_HASH = Hash_Cache_Default<TKey>::value>
 	struct Hash_Map
 	{
 		/**
@@ -749,6 +1450,12 @@ namespace cppr
 		 */
 		using Data_Type = internal::Hash_Pair<const TKey, TValue>;
 
+		/**
+		 * Pair type the slots are moved as, its key is only const when it's viewed as a Data_Type
+		 * so shifting and rehashing the slots moves the keys instead of copying them
+		 */
+		using Pair_Type = internal::Hash_Pair<TKey, TValue>;
+
 		/**
 		 * Range Type of hash map
 		 */
@@ -775,8 +1482,12 @@ namespace cppr
 		Allocator_Trait* _allocator;
 		Owner<Data_Type> _values;
 		Owner<internal::HASH_FLAGS> _flags;
+		Owner<usize> _hashes;
 		THash _hasher;
 		usize _count;
+		usize _capacity;
+		usize _deleted_count;
+		r32 _max_load_factor;
 
 		/**
 		 * @brief      Constructs a hash map that uses the provided memory context for allocation
@@ -786,7 +1497,10 @@ namespace cppr
 		Hash_Map(Allocator_Trait* context = allocator())
 			:_allocator(context),
 			 _hasher(THash()),
-			 _count(0)
+			 _count(0),
+			 _capacity(0),
+			 _deleted_count(0),
+			 _max_load_factor(internal::HASH_DEFAULT_MAX_LOAD_FACTOR)
 		{}
 
 		/**
@@ -798,7 +1512,10 @@ namespace cppr
 		Hash_Map(const THash& hasher, Allocator_Trait* context = allocator())
 			:_allocator(context),
 			 _hasher(hasher),
-			 _count(0)
+			 _count(0),
+			 _capacity(0),
+			 _deleted_count(0),
+			 _max_load_factor(internal::HASH_DEFAULT_MAX_LOAD_FACTOR)
 		{}
 
 		/**
@@ -809,14 +1526,23 @@ namespace cppr
 		Hash_Map(const Hash_Map& other)
 			:_allocator(other._allocator),
 			 _hasher(other._hasher),
-			 _count(other._count)
+			 _count(other._count),
+			 _capacity(other._capacity),
+			 _deleted_count(other._deleted_count),
+			 _max_load_factor(other._max_load_factor)
 		{
 			_flags = _allocator->template alloc<internal::HASH_FLAGS>(other._flags.count());
 			move(_flags, other._flags);
 
+			if(CACHE_HASH)
+			{
+				_hashes = _allocator->template alloc<usize>(other._hashes.count());
+				move(_hashes, other._hashes);
+			}
+
 			_values = _allocator->template alloc<Data_Type>(other._values.count());
-			for(usize i = 0; i < _flags.count(); ++i)
-				if(_flags[i] == internal::HASH_FLAGS::USED)
+			for(usize i = 0; i < _capacity; ++i)
+				if(internal::_hash_flag_used(_flags[i]))
 					::new (_values.ptr + i) Data_Type(other._values[i]);
 		}
 
@@ -829,14 +1555,23 @@ namespace cppr
 		Hash_Map(const Hash_Map& other, Allocator_Trait* context)
 			:_allocator(context),
 			 _hasher(other._hasher),
-			 _count(other._count)
+			 _count(other._count),
+			 _capacity(other._capacity),
+			 _deleted_count(other._deleted_count),
+			 _max_load_factor(other._max_load_factor)
 		{
 			_flags = _allocator->template alloc<internal::HASH_FLAGS>(other._flags.count());
 			move(_flags, other._flags);
 
+			if(CACHE_HASH)
+			{
+				_hashes = _allocator->template alloc<usize>(other._hashes.count());
+				move(_hashes, other._hashes);
+			}
+
 			_values = _allocator->template alloc<Data_Type>(other._values.count());
-			for(usize i = 0; i < other._flags.count(); ++i)
-				if(other._flags[i] == internal::HASH_FLAGS::USED)
+			for(usize i = 0; i < _capacity; ++i)
+				if(internal::_hash_flag_used(other._flags[i]))
 					::new (_values.ptr + i) Data_Type(other._values[i]);
 		}
 
@@ -849,10 +1584,16 @@ namespace cppr
 			:_allocator(std::move(other._allocator)),
 			 _values(std::move(other._values)),
 			 _flags(std::move(other._flags)),
+			 _hashes(std::move(other._hashes)),
 			 _hasher(std::move(other._hasher)),
-			 _count(other._count)
+			 _count(other._count),
+			 _capacity(other._capacity),
+			 _deleted_count(other._deleted_count),
+			 _max_load_factor(other._max_load_factor)
 		{
 			other._count = 0;
+			other._capacity = 0;
+			other._deleted_count = 0;
 		}
 
 		/**
@@ -865,41 +1606,44 @@ namespace cppr
 		Hash_Map&
 		operator=(const Hash_Map& other)
 		{
-			if(_flags.count() < other._flags.count())
+			//the slot of each value depends on the capacity so we copy the same layout
+			if(_capacity != other._capacity)
 			{
 				reset();
 				_flags = _allocator->template alloc<internal::HASH_FLAGS>(other._flags.count());
 				_values = _allocator->template alloc<Data_Type>(other._values.count());
+				if(CACHE_HASH)
+					_hashes = _allocator->template alloc<usize>(other._hashes.count());
+				_capacity = other._capacity;
 			}
 			else
 			{
-				for(usize i = 0; i < _flags.count(); ++i)
-				{
-					if(_flags[i] == internal::HASH_FLAGS::USED)
-					{
+				for(usize i = 0; i < _capacity; ++i)
+					if(internal::_hash_flag_used(_flags[i]))
 						_values[i].~Data_Type();
-						_flags[i] = internal::HASH_FLAGS::EMPTY;
-					}
-				}
 			}
 
 			_hasher = other._hasher;
 			_allocator = other._allocator;
 
 			move(_flags, other._flags);
-			for(usize i = 0; i < _flags.count(); ++i)
+			if(CACHE_HASH)
+				move(_hashes, other._hashes);
+			for(usize i = 0; i < _capacity; ++i)
 			{
-				if(_flags[i] == internal::HASH_FLAGS::USED)
+				if(internal::_hash_flag_used(_flags[i]))
 					::new (_values.ptr + i) Data_Type(other._values[i]);
 			}
 
 			_count = other._count;
+			_deleted_count = other._deleted_count;
+			_max_load_factor = other._max_load_factor;
 			return *this;
 		}
 
 		/**
 		 * @brief      Move assignment operator
-		 *             
+		 *
 		 * @param[in]  other  The other hash map to move values from
 		 *
 		 * @return     A Reference to this hash map
@@ -911,10 +1655,16 @@ namespace cppr
 			_allocator = std::move(other._allocator);
 			_values = std::move(other._values);
 			_flags = std::move(other._flags);
+			_hashes = std::move(other._hashes);
 			_hasher = std::move(other._hasher);
 			_count = other._count;
+			_capacity = other._capacity;
+			_deleted_count = other._deleted_count;
+			_max_load_factor = other._max_load_factor;
 
 			other._count = 0;
+			other._capacity = 0;
+			other._deleted_count = 0;
 			return *this;
 		}
 
@@ -932,7 +1682,7 @@ namespace cppr
 		usize
 		capacity() const
 		{
-			return _flags.count();
+			return _capacity;
 		}
 
 		/**
@@ -953,6 +1703,34 @@ namespace cppr
 			return _count == 0;
 		}
 
+		/**
+		 * @return     The max load factor of this hash map
+		 */
+		r32
+		max_load_factor() const
+		{
+			return _max_load_factor;
+		}
+
+		/**
+		 * @brief      Sets the max load factor of the hash map, the hash map grows when its values (and deleted markers)
+		 * exceed this ratio of the capacity, so higher load factors use less memory and lower ones give shorter probes
+		 *
+		 * @param[in]  value  The max load factor, it's clamped to [0.125, 0.9375]
+		 */
+		void
+		max_load_factor(r32 value)
+		{
+			if(value < internal::HASH_MIN_LOAD_FACTOR)
+				value = internal::HASH_MIN_LOAD_FACTOR;
+			else if(value > internal::HASH_MAX_LOAD_FACTOR)
+				value = internal::HASH_MAX_LOAD_FACTOR;
+
+			_max_load_factor = value;
+			if(_count + _deleted_count > _max_count())
+				rehash(_count);
+		}
+
 		/**
 		 * @brief      Ensures that the hash map has the capacity for the expected count
 		 *
@@ -961,36 +1739,135 @@ namespace cppr
 		void
 		reserve(usize expected_count)
 		{
-			if(_flags.count() - _count >= expected_count)
+			usize fit = _count + expected_count;
+			if(fit <= _max_count())
 				return;
 
-			usize double_cap = (_flags.count() * 2);
-			usize fit = _count + expected_count;
-			usize new_cap = double_cap > fit ? double_cap : fit;
+			_rehash(internal::_hash_capacity_for(fit, _max_load_factor));
+		}
+
+		/**
+		 * @brief      Rehashes the values into the smallest capacity which fits the expected count under the max load factor
+		 * If the capacity stays the same the values are rehashed in place without allocation, which removes the deleted markers
+		 *
+		 * @param[in]  expected_count  The expected count to fit, it can't be less than the count of values
+		 */
+		void
+		rehash(usize expected_count)
+		{
+			if(expected_count < _count)
+				expected_count = _count;
 
-			auto new_flags = _allocator->template alloc<internal::HASH_FLAGS>(new_cap);
+			usize new_cap = internal::_hash_capacity_for(expected_count, _max_load_factor);
+			if(new_cap == _capacity)
+				_rehash_in_place();
+			else
+				_rehash(new_cap);
+		}
+
+		/**
+		 * @brief      Shrinks the memory of the hash map to the smallest capacity which fits its values
+		 */
+		void
+		shrink_to_fit()
+		{
+			if(_count == 0)
+				reset();
+			else
+				rehash(_count);
+		}
+
+		void
+		_rehash(usize new_cap)
+		{
+			auto new_flags = _allocator->template alloc<internal::HASH_FLAGS>(new_cap + internal::HASH_CLONED_FLAGS);
 			auto new_values = _allocator->template alloc<Data_Type>(new_cap);
+			Owner<usize> new_hashes;
+			if(CACHE_HASH)
+				new_hashes = _allocator->template alloc<usize>(new_cap);
 
-			std::memset(new_flags.ptr, 0, new_flags.size);
+			std::memset(new_flags.ptr, internal::HASH_FLAGS::EMPTY, new_flags.size);
 
 			if (_count != 0)
 			{
-				for (usize i = 0; i < _flags.count(); ++i)
+				for (usize i = 0; i < _capacity; ++i)
 				{
-					if (_flags[i] == internal::HASH_FLAGS::USED)
+					if (internal::_hash_flag_used(_flags[i]))
 					{
-						usize new_index = _find_insertion_index(new_flags, new_values, _values[i].key);
-						new_flags[new_index] = internal::HASH_FLAGS::USED;
-						::new (new_values.ptr + new_index) Data_Type(std::move(_values[i]));
+						usize hash_value = _hash_of(i);
+						usize new_index = _claim_index(new_flags, new_values, new_hashes, new_cap, hash_value);
+						::new (new_values.ptr + new_index) Pair_Type(std::move(_pairs(_values)[i]));
+						_pairs(_values)[i].~Pair_Type();
 					}
 				}
 			}
 
 			_allocator->template free<internal::HASH_FLAGS>(_flags);
 			_allocator->template free<Data_Type>(_values);
+			_allocator->template free<usize>(_hashes);
 
 			_flags = std::move(new_flags);
 			_values = std::move(new_values);
+			_hashes = std::move(new_hashes);
+			_capacity = new_cap;
+			_deleted_count = 0;
+		}
+
+		void
+		_rehash_in_place()
+		{
+			//robin hood tables don't have deleted markers
+			if(PROBING == HASH_PROBING::ROBIN_HOOD || _deleted_count == 0)
+				return;
+
+			internal::_hash_prepare_rehash_in_place(_flags.ptr, _capacity);
+			for(usize i = 0; i < _capacity; ++i)
+			{
+				if(_flags[i] != internal::HASH_FLAGS::DELETED)
+					continue;
+
+				usize hash_value = _hash_of(i);
+				usize new_index = internal::_hash_find_free(_flags.ptr, _capacity, hash_value);
+				auto h2 = internal::HASH_FLAGS(internal::_hash_h2(hash_value));
+
+				if(internal::_hash_same_group(_capacity, hash_value, i, new_index))
+				{
+					//the value is already in the first group it can be found in
+					internal::_hash_set_flag(_flags.ptr, _capacity, i, h2);
+				}
+				else if(_flags[new_index] == internal::HASH_FLAGS::EMPTY)
+				{
+					internal::_hash_set_flag(_flags.ptr, _capacity, new_index, h2);
+					::new (_values.ptr + new_index) Pair_Type(std::move(_pairs(_values)[i]));
+					_pairs(_values)[i].~Pair_Type();
+					if(CACHE_HASH)
+						_hashes[new_index] = hash_value;
+					internal::_hash_set_flag(_flags.ptr, _capacity, i, internal::HASH_FLAGS::EMPTY);
+				}
+				else
+				{
+					//the slot holds a value which wasn't rehashed yet, so we swap them and process this slot again
+					internal::_hash_set_flag(_flags.ptr, _capacity, new_index, h2);
+					Pair_Type tmp(std::move(_pairs(_values)[new_index]));
+					_pairs(_values)[new_index].~Pair_Type();
+					::new (_values.ptr + new_index) Pair_Type(std::move(_pairs(_values)[i]));
+					_pairs(_values)[i].~Pair_Type();
+					::new (_values.ptr + i) Pair_Type(std::move(tmp));
+					if(CACHE_HASH)
+					{
+						_hashes[i] = _hashes[new_index];
+						_hashes[new_index] = hash_value;
+					}
+					--i;
+				}
+			}
+			_deleted_count = 0;
+		}
+
+		usize
+		_max_count() const
+		{
+			return static_cast<usize>(_capacity * _max_load_factor);
 		}
 
 		/**
@@ -1003,16 +1880,16 @@ namespace cppr
 		{
 			_maintain_space_complexity();
 
-			usize index = _find_insertion_index(value.key);
+			usize hash_value = _hasher(value.key);
+			usize index = _lookup_index(value.key, hash_value);
 
-			if(_flags[index] == internal::HASH_FLAGS::EMPTY)
+			if(index == _capacity)
 			{
-				_flags[index] = internal::HASH_FLAGS::USED;
+				index = _insert_index(hash_value);
 				::new (_values.ptr + index) Data_Type(value);
-				++_count;
 			}
 
-			return iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
 		}
 
 		/**
@@ -1025,16 +1902,16 @@ namespace cppr
 		{
 			_maintain_space_complexity();
 
-			usize index = _find_insertion_index(value.key);
+			usize hash_value = _hasher(value.key);
+			usize index = _lookup_index(value.key, hash_value);
 
-			if(_flags[index] == internal::HASH_FLAGS::EMPTY)
+			if(index == _capacity)
 			{
-				_flags[index] = internal::HASH_FLAGS::USED;
+				index = _insert_index(hash_value);
 				::new (_values.ptr + index) Data_Type(std::move(value));
-				++_count;
 			}
 
-			return iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
 		}
 
 		/**
@@ -1047,16 +1924,16 @@ namespace cppr
 		{
 			_maintain_space_complexity();
 
-			usize index = _find_insertion_index(key);
+			usize hash_value = _hasher(key);
+			usize index = _lookup_index(key, hash_value);
 
-			if(_flags[index] == internal::HASH_FLAGS::EMPTY)
+			if(index == _capacity)
 			{
-				_flags[index] = internal::HASH_FLAGS::USED;
+				index = _insert_index(hash_value);
 				::new (_values.ptr + index) Data_Type(key);
-				++_count;
 			}
 
-			return iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
 		}
 
 		/**
@@ -1069,16 +1946,16 @@ namespace cppr
 		{
 			_maintain_space_complexity();
 
-			usize index = _find_insertion_index(key);
+			usize hash_value = _hasher(key);
+			usize index = _lookup_index(key, hash_value);
 
-			if(_flags[index] == internal::HASH_FLAGS::EMPTY)
+			if(index == _capacity)
 			{
-				_flags[index] = internal::HASH_FLAGS::USED;
+				index = _insert_index(hash_value);
 				::new (_values.ptr + index) Data_Type(std::move(key));
-				++_count;
 			}
 
-			return iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
 		}
 
 		/**
@@ -1092,16 +1969,16 @@ namespace cppr
 		{
 			_maintain_space_complexity();
 
-			usize index = _find_insertion_index(key);
+			usize hash_value = _hasher(key);
+			usize index = _lookup_index(key, hash_value);
 
-			if(_flags[index] == internal::HASH_FLAGS::EMPTY)
+			if(index == _capacity)
 			{
-				_flags[index] = internal::HASH_FLAGS::USED;
+				index = _insert_index(hash_value);
 				::new (_values.ptr + index) Data_Type(key, value);
-				++_count;
 			}
 
-			return iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
 		}
 
 		/**
@@ -1115,16 +1992,16 @@ namespace cppr
 		{
 			_maintain_space_complexity();
 
-			usize index = _find_insertion_index(key);
+			usize hash_value = _hasher(key);
+			usize index = _lookup_index(key, hash_value);
 
-			if(_flags[index] == internal::HASH_FLAGS::EMPTY)
+			if(index == _capacity)
 			{
-				_flags[index] = internal::HASH_FLAGS::USED;
+				index = _insert_index(hash_value);
 				::new (_values.ptr + index) Data_Type(key, std::move(value));
-				++_count;
 			}
 
-			return iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
 		}
 
 		/**
@@ -1138,16 +2015,16 @@ namespace cppr
 		{
 			_maintain_space_complexity();
 
-			usize index = _find_insertion_index(key);
+			usize hash_value = _hasher(key);
+			usize index = _lookup_index(key, hash_value);
 
-			if(_flags[index] == internal::HASH_FLAGS::EMPTY)
+			if(index == _capacity)
 			{
-				_flags[index] = internal::HASH_FLAGS::USED;
+				index = _insert_index(hash_value);
 				::new (_values.ptr + index) Data_Type(std::move(key), value);
-				++_count;
 			}
 
-			return iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
 		}
 
 		/**
@@ -1161,16 +2038,128 @@ namespace cppr
 		{
 			_maintain_space_complexity();
 
-			usize index = _find_insertion_index(key);
+			usize hash_value = _hasher(key);
+			usize index = _lookup_index(key, hash_value);
 
-			if(_flags[index] == internal::HASH_FLAGS::EMPTY)
+			if(index == _capacity)
 			{
-				_flags[index] = internal::HASH_FLAGS::USED;
+				index = _insert_index(hash_value);
 				::new (_values.ptr + index) Data_Type(std::move(key), std::move(value));
-				++_count;
 			}
 
-			return iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
+		}
+
+		/**
+		 * @brief      Inserts a value constructed in place from the given args if the key doesn't exist,
+		 * if it exists nothing is constructed and the hash map is left unchanged
+		 *
+		 * @param[in]  key   The key to be inserted
+		 * @param[in]  args  values that will be passed to the value type constructor
+		 *
+		 * @tparam     TArgs      Variadic template type
+		 *
+		 * @return     An Iterator to the inserted or the existing key-value pair
+		 */
+		template<typename ... TArgs>
+		iterator
+		try_emplace(const TKey& key, TArgs&& ... args)
+		{
+			usize index = _emplace_index(key, std::forward<TArgs>(args)...);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
+		}
+
+		/**
+		 * @brief      Inserts a value constructed in place from the given args if the key doesn't exist,
+		 * if it exists nothing is constructed and the hash map is left unchanged
+		 *
+		 * @param[in]  key   The key to be inserted
+		 * @param[in]  args  values that will be passed to the value type constructor
+		 *
+		 * @tparam     TArgs      Variadic template type
+		 *
+		 * @return     An Iterator to the inserted or the existing key-value pair
+		 */
+		template<typename ... TArgs>
+		iterator
+		try_emplace(TKey&& key, TArgs&& ... args)
+		{
+			usize index = _emplace_index(std::move(key), std::forward<TArgs>(args)...);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
+		}
+
+		/**
+		 * @brief      Inserts the key-value pair if the key doesn't exist, otherwise assigns the value to the existing key
+		 *
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted or assigned
+		 *
+		 * @return     An Iterator to the inserted or the assigned key-value pair
+		 */
+		template<typename TArg>
+		iterator
+		insert_or_assign(const TKey& key, TArg&& value)
+		{
+			usize count = _count;
+			usize index = _emplace_index(key, std::forward<TArg>(value));
+			if(count == _count)
+				_values[index].value = std::forward<TArg>(value);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
+		}
+
+		/**
+		 * @brief      Inserts the key-value pair if the key doesn't exist, otherwise assigns the value to the existing key
+		 *
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted or assigned
+		 *
+		 * @return     An Iterator to the inserted or the assigned key-value pair
+		 */
+		template<typename TArg>
+		iterator
+		insert_or_assign(TKey&& key, TArg&& value)
+		{
+			usize count = _count;
+			usize index = _emplace_index(std::move(key), std::forward<TArg>(value));
+			if(count == _count)
+				_values[index].value = std::forward<TArg>(value);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
+		}
+
+		/**
+		 * @brief      Looks up the value of the given key, if it doesn't exist it will be added with a value
+		 * constructed in place from the given args
+		 *
+		 * @param[in]  key   The key to be accessed
+		 * @param[in]  args  values that will be passed to the value type constructor
+		 *
+		 * @tparam     TArgs      Variadic template type
+		 *
+		 * @return     The corresponding value by reference
+		 */
+		template<typename ... TArgs>
+		TValue&
+		lookup_or_insert(const TKey& key, TArgs&& ... args)
+		{
+			return _values[_emplace_index(key, std::forward<TArgs>(args)...)].value;
+		}
+
+		/**
+		 * @brief      Looks up the value of the given key, if it doesn't exist it will be added with a value
+		 * constructed in place from the given args
+		 *
+		 * @param[in]  key   The key to be accessed
+		 * @param[in]  args  values that will be passed to the value type constructor
+		 *
+		 * @tparam     TArgs      Variadic template type
+		 *
+		 * @return     The corresponding value by reference
+		 */
+		template<typename ... TArgs>
+		TValue&
+		lookup_or_insert(TKey&& key, TArgs&& ... args)
+		{
+			return _values[_emplace_index(std::move(key), std::forward<TArgs>(args)...)].value;
 		}
 
 		/**
@@ -1185,14 +2174,13 @@ namespace cppr
 		{
 			_maintain_space_complexity();
 
-			usize index = _lookup_index(key);
-			if(index != _flags.count())
+			usize hash_value = _hasher(key);
+			usize index = _lookup_index(key, hash_value);
+			if(index != _capacity)
 				return _values[index].value;
 
-			index = _find_insertion_index(key);
-			_flags[index] = internal::HASH_FLAGS::USED;
+			index = _insert_index(hash_value);
 			::new (_values.ptr + index) Data_Type(key);
-			++_count;
 
 			return _values[index].value;
 		}
@@ -1209,14 +2197,13 @@ namespace cppr
 		{
 			_maintain_space_complexity();
 
-			usize index = _lookup_index(key);
-			if(index != _flags.count())
+			usize hash_value = _hasher(key);
+			usize index = _lookup_index(key, hash_value);
+			if(index != _capacity)
 				return _values[index].value;
 
-			index = _find_insertion_index(key);
-			_flags[index] = internal::HASH_FLAGS::USED;
+			index = _insert_index(hash_value);
 			::new (_values.ptr + index) Data_Type(std::move(key));
-			++_count;
 
 			return _values[index].value;
 		}
@@ -1231,10 +2218,10 @@ namespace cppr
 		{
 			auto index = _lookup_index(value.key);
 
-			if(index == _flags.count())
+			if(index == _capacity)
 				return end();
 
-			return iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
 		}
 
 		/**
@@ -1247,10 +2234,10 @@ namespace cppr
 		{
 			auto index = _lookup_index(value.key);
 
-			if(index == _flags.count())
+			if(index == _capacity)
 				return end();
 
-			return const_iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return const_iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
 		}
 
 		/**
@@ -1263,10 +2250,10 @@ namespace cppr
 		{
 			auto index = _lookup_index(key);
 
-			if(index == _flags.count())
+			if(index == _capacity)
 				return end();
 
-			return iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
 		}
 
 		/**
@@ -1279,10 +2266,74 @@ namespace cppr
 		{
 			auto index = _lookup_index(key);
 
-			if(index == _flags.count())
+			if(index == _capacity)
+				return end();
+
+			return const_iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
+		}
+
+		/**
+		 * @brief      Heterogeneous lookup, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 * like Hash<String> which accepts String_Range, the searched key must have the same hash as the equal keys in the map
+		 *
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     An Iterator to the found value, or an iterator to the end if not found
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		iterator
+		lookup(const TLookup& key)
+		{
+			auto index = _lookup_index(key);
+
+			if(index == _capacity)
+				return end();
+
+			return iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
+		}
+
+		/**
+		 * @brief      Heterogeneous lookup, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 *
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     A Const Iterator to the found value, or an iterator to the end if not found
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		const_iterator
+		lookup(const TLookup& key) const
+		{
+			auto index = _lookup_index(key);
+
+			if(index == _capacity)
 				return end();
 
-			return const_iterator(_values.ptr + index, _flags.ptr + index, _flags.count() - index);
+			return const_iterator(_values.ptr + index, _flags.ptr + index, _capacity - index);
+		}
+
+		/**
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     Whether the key exists in the hash map
+		 */
+		bool
+		contains(const TKey& key) const
+		{
+			return _lookup_index(key) != _capacity;
+		}
+
+		/**
+		 * @brief      Heterogeneous contains, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 *
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     Whether the key exists in the hash map
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		bool
+		contains(const TLookup& key) const
+		{
+			return _lookup_index(key) != _capacity;
 		}
 
 		/**
@@ -1295,12 +2346,10 @@ namespace cppr
 		{
 			auto index = _lookup_index(value.key);
 
-			if(index == _flags.count())
+			if(index == _capacity)
 				return false;
 
-			_flags[index] = internal::HASH_FLAGS::DELETED;
-			_values[index].~Data_Type();
-			--_count;
+			_remove_index(index);
 			return true;
 		}
 
@@ -1314,12 +2363,30 @@ namespace cppr
 		{
 			auto index = _lookup_index(key);
 
-			if(index == _flags.count())
+			if(index == _capacity)
 				return false;
 
-			_flags[index] = internal::HASH_FLAGS::DELETED;
-			_values[index].~Data_Type();
-			--_count;
+			_remove_index(index);
+			return true;
+		}
+
+		/**
+		 * @brief      Heterogeneous remove, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 *
+		 * @param[in]  key   The key to be removed
+		 *
+		 * @return     True if removed the value, false if the value doesn't exist
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		bool
+		remove(const TLookup& key)
+		{
+			auto index = _lookup_index(key);
+
+			if(index == _capacity)
+				return false;
+
+			_remove_index(index);
 			return true;
 		}
 
@@ -1333,12 +2400,10 @@ namespace cppr
 		{
 			usize index = it._flag - _flags.ptr;
 
-			if(index == _flags.count())
+			if(index == _capacity)
 				return false;
 
-			_flags[index] = internal::HASH_FLAGS::DELETED;
-			_values[index].~Data_Type();
-			--_count;
+			_remove_index(index);
 			return true;
 		}
 
@@ -1352,12 +2417,10 @@ namespace cppr
 		{
 			usize index = it._flag - _flags.ptr;
 
-			if(index == _flags.count())
+			if(index == _capacity)
 				return false;
 
-			_flags[index] = internal::HASH_FLAGS::DELETED;
-			_values[index].~Data_Type();
-			--_count;
+			_remove_index(index);
 			return true;
 		}
 
@@ -1367,17 +2430,16 @@ namespace cppr
 		void
 		clear()
 		{
-			if(_count == 0)
+			if(_capacity == 0)
 				return;
-			for(usize i = 0; i < _flags.count(); ++i)
+			for(usize i = 0; i < _capacity; ++i)
 			{
-				if(_flags[i] == internal::HASH_FLAGS::USED)
-				{
-					_flags[i] = internal::HASH_FLAGS::EMPTY;
+				if(internal::_hash_flag_used(_flags[i]))
 					_values[i].~Data_Type();
-				}
 			}
+			std::memset(_flags.ptr, internal::HASH_FLAGS::EMPTY, _flags.size);
 			_count = 0;
+			_deleted_count = 0;
 		}
 
 		/**
@@ -1389,6 +2451,8 @@ namespace cppr
 			clear();
 			_allocator->template free<internal::HASH_FLAGS>(_flags);
 			_allocator->template free<Data_Type>(_values);
+			_allocator->template free<usize>(_hashes);
+			_capacity = 0;
 		}
 
 		/**
@@ -1481,10 +2545,10 @@ namespace cppr
 				return end();
 
 			usize ix = 0;
-			for(ix = 0; ix < _flags.count(); ++ix)
-				if(_flags[ix] == internal::HASH_FLAGS::USED)
+			for(ix = 0; ix < _capacity; ++ix)
+				if(internal::_hash_flag_used(_flags[ix]))
 					break;
-			return iterator(_values.ptr + ix, _flags.ptr + ix, _flags.count() - ix);
+			return iterator(_values.ptr + ix, _flags.ptr + ix, _capacity - ix);
 		}
 
 		/**
@@ -1497,10 +2561,10 @@ namespace cppr
 				return end();
 
 			usize ix = 0;
-			for(ix = 0; ix < _flags.count(); ++ix)
-				if(_flags[ix] == internal::HASH_FLAGS::USED)
+			for(ix = 0; ix < _capacity; ++ix)
+				if(internal::_hash_flag_used(_flags[ix]))
 					break;
-			return const_iterator(_values.ptr + ix, _flags.ptr + ix, _flags.count() - ix);
+			return const_iterator(_values.ptr + ix, _flags.ptr + ix, _capacity - ix);
 		}
 
 		/**
@@ -1513,10 +2577,10 @@ namespace cppr
 				return end();
 
 			usize ix = 0;
-			for(ix = 0; ix < _flags.count(); ++ix)
-				if(_flags[ix] == internal::HASH_FLAGS::USED)
+			for(ix = 0; ix < _capacity; ++ix)
+				if(internal::_hash_flag_used(_flags[ix]))
 					break;
-			return const_iterator(_values.ptr + ix, _flags.ptr + ix, _flags.count() - ix);
+			return const_iterator(_values.ptr + ix, _flags.ptr + ix, _capacity - ix);
 		}
 
 		/**
@@ -1525,7 +2589,7 @@ namespace cppr
 		iterator
 		end()
 		{
-			usize ix = _flags.count();
+			usize ix = _capacity;
 			return iterator(_values.ptr + ix, _flags.ptr + ix, 0);
 		}
 
@@ -1535,7 +2599,7 @@ namespace cppr
 		const_iterator
 		end() const
 		{
-			usize ix = _flags.count();
+			usize ix = _capacity;
 			return const_iterator(_values.ptr + ix, _flags.ptr + ix, 0);
 		}
 
@@ -1545,104 +2609,141 @@ namespace cppr
 		const_iterator
 		cend() const
 		{
-			usize ix = _flags.count();
+			usize ix = _capacity;
 			return const_iterator(_values.ptr + ix, _flags.ptr + ix, 0);
 		}
 
+		//the hash of the key in the given slot, it's read from the cache when the hashes are cached
 		usize
-		_lookup_index(const Owner<internal::HASH_FLAGS>& flags, const Owner<Data_Type>& values,
-					  const TKey& key) const
+		_hash_of(usize index) const
 		{
-			usize cap = flags.count();
-			if(cap == 0) return cap;
+			if(CACHE_HASH)
+				return _hashes[index];
+			return _hasher(_values[index].key);
+		}
 
-			usize hash_value = _hasher(key);
-			usize index = hash_value % cap;
-			usize ix = index;
+		template<typename TLookup>
+		usize
+		_lookup_index(const TLookup& key, usize hash_value) const
+		{
+			//with cached hashes the keys are only compared when their full hashes are equal
+			auto equal = [&](usize index) {
+				return (!CACHE_HASH || _hashes[index] == hash_value) && _values[index].key == key;
+			};
 
-			//linear probing goes here
-			while(true)
-			{
-				//if the cell is empty then we didn't find the key
-				if(flags[ix] == internal::HASH_FLAGS::EMPTY)
-					return cap;
+			if(PROBING == HASH_PROBING::ROBIN_HOOD)
+				return internal::_robin_hood_find(_flags.ptr, _capacity, hash_value, equal);
+			else
+				return internal::_hash_find(_flags.ptr, _capacity, hash_value, equal);
+		}
 
-				//if the cell is used and it's the same key then we found it
-				if (flags[ix] == internal::HASH_FLAGS::USED &&
-					values[ix] == key)
-					return ix;
+		template<typename TLookup>
+		usize
+		_lookup_index(const TLookup& key) const
+		{
+			return _lookup_index(key, _hasher(key));
+		}
 
-				//increment the index
-				++ix;
-				ix %= cap;
+		//views the slots as non const pairs so they can be moved without copying the keys
+		static Pair_Type*
+		_pairs(const Owner<Data_Type>& values)
+		{
+			return reinterpret_cast<Pair_Type*>(values.ptr);
+		}
 
-				//check if we went full circle
-				if(ix == index)
-					return cap;
+		//claims a free slot for a new value with the given hash in the given table, the caller constructs the value
+		usize
+		_claim_index(const Owner<internal::HASH_FLAGS>& flags, const Owner<Data_Type>& values,
+					 const Owner<usize>& hashes, usize cap, usize hash_value)
+		{
+			usize index;
+			if(PROBING == HASH_PROBING::ROBIN_HOOD)
+			{
+				index = internal::_robin_hood_insert_index(flags.ptr, _pairs(values), CACHE_HASH ? hashes.ptr : nullptr,
+														   cap, hash_value);
+			}
+			else
+			{
+				index = internal::_hash_find_free(flags.ptr, cap, hash_value);
+				if(flags[index] == internal::HASH_FLAGS::DELETED)
+					--_deleted_count;
+				internal::_hash_set_flag(flags.ptr, cap, index, internal::HASH_FLAGS(internal::_hash_h2(hash_value)));
 			}
 
-			return cap;
+			if(CACHE_HASH)
+				hashes.ptr[index] = hash_value;
+			return index;
 		}
 
+		//probes once for the key and constructs the value in place only if the key doesn't exist
+		template<typename TKeyArg, typename ... TArgs>
 		usize
-		_lookup_index(const TKey& key) const
+		_emplace_index(TKeyArg&& key, TArgs&& ... args)
 		{
-			return _lookup_index(_flags, _values, key);
+			usize hash_value = _hasher(key);
+			return _emplace_index_hashed(hash_value, std::forward<TKeyArg>(key), std::forward<TArgs>(args)...);
 		}
 
+		template<typename TKeyArg, typename ... TArgs>
 		usize
-		_find_insertion_index(const Owner<internal::HASH_FLAGS>& flags, const Owner<Data_Type>& values,
-							  const TKey& key) const
+		_emplace_index_hashed(usize hash_value, TKeyArg&& key, TArgs&& ... args)
 		{
-			usize cap = flags.count();
-			if(cap == 0) return cap;
-
-			usize hash_value = _hasher(key);
-			usize index = hash_value % cap;
-			usize ix = index;
-
-			//linear probing goes here
-			while(true)
-			{
-				//this is an empty spot or deleted spot then we can use it
-				if (flags[ix] == internal::HASH_FLAGS::EMPTY ||
-					flags[ix] == internal::HASH_FLAGS::DELETED)
-					return ix;
-
-				//the position is not empty but if it's the same key then we return it
-				if(values[ix] == key)
-					return ix;
+			_maintain_space_complexity();
 
-				//the position is not empty and the key is not the same
-				++ix;
-				ix %= cap;
+			usize index = _lookup_index(key, hash_value);
+			if(index != _capacity)
+				return index;
 
-				//if we went a full circle then we just return the cap to signal no index found
-				if(ix == index)
-					return cap;
-			}
-			return cap;
+			index = _insert_index(hash_value);
+			::new (_values.ptr + index) Data_Type(internal::Hash_Emplace_Tag(),
+												   std::forward<TKeyArg>(key), std::forward<TArgs>(args)...);
+			return index;
 		}
 
 		usize
-		_find_insertion_index(const TKey& key) const
+		_insert_index(usize hash_value)
+		{
+			usize index = _claim_index(_flags, _values, _hashes, _capacity, hash_value);
+			++_count;
+			return index;
+		}
+
+		void
+		_remove_index(usize index)
 		{
-			return _find_insertion_index(_flags, _values, key);
+			if(PROBING == HASH_PROBING::ROBIN_HOOD)
+			{
+				internal::_robin_hood_erase(_flags.ptr, _pairs(_values), CACHE_HASH ? _hashes.ptr : nullptr, _capacity, index,
+											[&](usize new_index) {
+					usize home = internal::_hash_h1(_hash_of(new_index));
+					return (new_index - home) & (_capacity - 1);
+				});
+			}
+			else
+			{
+				if(internal::_hash_erase_flag(_flags.ptr, _capacity, index))
+					++_deleted_count;
+				_values[index].~Data_Type();
+			}
+			--_count;
 		}
 
 		void
 		_maintain_space_complexity()
 		{
 			constexpr usize STARTING_COUNT = 8;
-			if (_flags.count() == 0)
+			if (_capacity == 0)
 			{
 				reserve(STARTING_COUNT);
 			}
-			else if (_count > (_flags.count() / 2))
+			else if (_count + _deleted_count >= _max_count())
 			{
-				//reserve another capacity to double it
-				reserve(_flags.count());
+				//if most of the load is deleted markers then purging them is enough, otherwise double the capacity
+				if(_count < _max_count() / 2)
+					_rehash_in_place();
+				else
+					_rehash(_capacity * 2);
 			}
 		}
 	};
-}
\ No newline at end of file
+}
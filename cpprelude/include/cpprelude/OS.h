@@ -2,6 +2,7 @@
 #include "cpprelude/defines.h"
 #include "cpprelude/api.h"
 #include "cpprelude/Allocator_Trait.h"
+#include "cpprelude/Allocator_Stats.h"
 #include "cpprelude/Result.h"
 #include "cpprelude/Ranges.h"
 #include "cpprelude/File_Handle.h"
@@ -33,6 +34,49 @@ namespace cppr
 		FILE_DOESNOT_EXIST
 	};
 
+	/**
+	 * @brief      Virtual memory allocation flags which can be combined using `|` operator
+	 * 
+	 * - **NONE**: Plain virtual memory
+	 * - **HUGE_PAGES**: Backs the memory with huge pages if possible to reduce the TLB misses
+	 * it tries explicit huge pages first and falls back to transparent huge pages then to normal pages
+	 * - **POPULATE**: Pre-faults the pages at allocation time so the first touch doesn't page fault
+	 */
+	enum class VIRTUAL_FLAGS: u32
+	{
+		NONE = 0,
+		HUGE_PAGES = 1 << 0,
+		POPULATE = 1 << 1
+	};
+
+	inline static VIRTUAL_FLAGS
+	operator|(VIRTUAL_FLAGS a, VIRTUAL_FLAGS b)
+	{
+		return VIRTUAL_FLAGS(u32(a) | u32(b));
+	}
+
+	inline static bool
+	operator&(VIRTUAL_FLAGS a, VIRTUAL_FLAGS b)
+	{
+		return (u32(a) & u32(b)) != 0;
+	}
+
+	/**
+	 * @brief      Virtual memory usage advice
+	 * 
+	 * - **NORMAL**: No special treatment
+	 * - **WILL_NEED**: The memory will be accessed soon so the OS may read it ahead
+	 * - **DONT_NEED**: The memory won't be accessed soon, its pages are released immediately and will be zero filled on next access
+	 * - **FREE**: The memory content is no longer needed, the OS may release its pages lazily, the content is undefined on next access
+	 */
+	enum class VIRTUAL_ADVICE
+	{
+		NORMAL,
+		WILL_NEED,
+		DONT_NEED,
+		FREE
+	};
+
 	/**
 	 * @brief      Represents the underlying operation system
 	 */
@@ -43,9 +87,31 @@ namespace cppr
 		 */
 		Allocator_Trait* global_memory;
 
+		/**
+		 * The allocation statistics of the global memory context, they're only recorded when
+		 * `track_global_memory_stats` is set
+		 */
+		Allocator_Stats* global_memory_stats;
+
+		/**
+		 * Whether the global memory context records its allocations in `global_memory_stats` or not
+		 * It's off by default because all the threads would update the same shared counters on every allocation
+		 * Set it before allocating otherwise the frees of the untracked blocks skew the live size
+		 */
+		std::atomic<bool> track_global_memory_stats{false};
+
 		//used in case you want to check for leaks [it's slow]
 		Allocator_Trait* leak_detector;
 
+		/**
+		 * The leak detector captures the call stack of one in every `leak_sampling_rate` allocations
+		 * - **0**: disables the call stack capture
+		 * - **1**: captures the call stack of every allocation
+		 * - **N**: captures the call stack of every N-th allocation on each thread which reduces the overhead
+		 * Call stacks are only captured in debug mode
+		 */
+		usize leak_sampling_rate = 1;
+
 		/**
 		 * The virtual memory context which uses the underlying OS specfic virtual alloc and free
 		 * It's recommended to use this with Big allocations only i.e. 1GB of memory
@@ -84,16 +150,36 @@ namespace cppr
 		API_CPPR void
 		dump_callstack(IO_Trait* io = nullptr) const;
 
+		/**
+		 * @brief      Resets the leak sampling counter of the calling thread, so the call stack of
+		 * the `leak_sampling_rate`-th allocation from now on is the next one to be captured
+		 */
+		API_CPPR void
+		reset_leak_sampling() const;
+
+		/**
+		 * @brief      Prints the name of the function which contains the given code address
+		 * Symbol names are only available in debug mode on windows, otherwise the address is printed
+		 *
+		 * @param      io       The IO_Trait to print to
+		 * @param      address  The code address i.e. a return address
+		 *
+		 * @return     The size of the printed string in bytes
+		 */
+		API_CPPR usize
+		print_symbol(IO_Trait* io, void* address) const;
+
 		/**
 		 * @brief      Allocates memory from OS virtual memory
 		 *
 		 * @param      address_hint  The address hint
 		 * @param[in]  size          The size of the memory in bytes
+		 * @param[in]  flags         The virtual memory allocation flags
 		 *
-		 * @return     An Owner pointer to the underlying memory block
+		 * @return     An Owner pointer to the underlying memory block, the size may be rounded up to the huge page size
 		 */
 		API_CPPR Owner<byte>
-		virtual_alloc(void* address_hint, usize size);
+		virtual_alloc(void* address_hint, usize size, VIRTUAL_FLAGS flags = VIRTUAL_FLAGS::NONE);
 
 		/**
 		 * @brief      Frees the underlying virtual memory of the given owner pointer
@@ -105,6 +191,73 @@ namespace cppr
 		API_CPPR bool
 		virtual_free(const Owner<byte>& data);
 
+		/**
+		 * @brief      Reserves an address range from OS virtual memory without committing it
+		 * The reserved memory is not accessible until it's committed using `virtual_commit`
+		 * and it's freed using `virtual_free`
+		 *
+		 * @param      address_hint  The address hint
+		 * @param[in]  size          The size of the address range in bytes
+		 * @param[in]  flags         The virtual memory allocation flags, only `HUGE_PAGES` is respected
+		 * which marks the range for transparent huge pages on linux
+		 *
+		 * @return     An Owner pointer to the reserved address range
+		 */
+		API_CPPR Owner<byte>
+		virtual_reserve(void* address_hint, usize size, VIRTUAL_FLAGS flags = VIRTUAL_FLAGS::NONE);
+
+		/**
+		 * @brief      Commits a page aligned part of a reserved address range to make it accessible
+		 *
+		 * @param[in]  data  The memory to commit
+		 *
+		 * @return     True if succeeded, false otherwise
+		 */
+		API_CPPR bool
+		virtual_commit(const Slice<byte>& data);
+
+		/**
+		 * @brief      Decommits a page aligned part of a reserved address range returning
+		 * its physical pages back to the OS while keeping the address range reserved
+		 *
+		 * @param[in]  data  The memory to decommit
+		 *
+		 * @return     True if succeeded, false otherwise
+		 */
+		API_CPPR bool
+		virtual_decommit(const Slice<byte>& data);
+
+		/**
+		 * @brief      Advises the OS about the expected usage of a page aligned virtual memory
+		 *
+		 * @param[in]  data    The memory to advise about
+		 * @param[in]  advice  The usage advice
+		 *
+		 * @return     True if succeeded, false otherwise
+		 */
+		API_CPPR bool
+		virtual_advise(const Slice<byte>& data, VIRTUAL_ADVICE advice);
+
+		/**
+		 * @brief      Touches every page of the given memory so that it's backed by physical memory
+		 *
+		 * @param[in]  data  The memory to populate
+		 */
+		API_CPPR void
+		virtual_populate(const Slice<byte>& data);
+
+		/**
+		 * @return     The virtual memory page size in bytes
+		 */
+		API_CPPR usize
+		virtual_page_size() const;
+
+		/**
+		 * @return     The huge page size in bytes
+		 */
+		API_CPPR usize
+		virtual_huge_page_size() const;
+
 		/**
 		 * @brief      Opens a file
 		 *
@@ -251,9 +404,9 @@ namespace cppr
 
 	template<typename T>
 	Owner<T>
-	alloc(usize count = 1)
+	alloc(usize count = 1, usize alignment = alignof(T))
 	{
-		return allocator()->template alloc<T>(count);
+		return allocator()->template alloc<T>(count, alignment);
 	}
 
 	template<typename T>
@@ -272,9 +425,9 @@ namespace cppr
 
 	template<typename T>
 	Owner<T>
-	alloc_from(Allocator_Trait* trait, usize count = 1)
+	alloc_from(Allocator_Trait* trait, usize count = 1, usize alignment = alignof(T))
 	{
-		return trait->template alloc<T>(count);
+		return trait->template alloc<T>(count, alignment);
 	}
 
 	template<typename T>
@@ -1952,6 +1952,77 @@ namespace cppr
 		return predecessor;
 	}
 
+	//the nodes count in the subtree of this node which is kept in the node itself
+	template<typename TNode>
+	inline static usize
+	_get_subtree_size(TNode* node)
+	{
+		return node == nullptr ? 0 : node->size;
+	}
+
+	//this function gets the node with the given in-order index inside the subtree of the node
+	//it uses the subtree sizes so it goes down a single branch
+	template<typename TNode>
+	inline static TNode*
+	_get_nth(TNode* node, usize index)
+	{
+		while (node != nullptr)
+		{
+			usize left_size = _get_subtree_size(node->left);
+			if (index < left_size)
+			{
+				node = node->left;
+			}
+			else if (index == left_size)
+			{
+				return node;
+			}
+			else
+			{
+				index -= left_size + 1;
+				node = node->right;
+			}
+		}
+		return node;
+	}
+
+	//same as calling _get_successor steps times but it skips the whole subtrees
+	//it goes up until the target is in a right subtree then goes down to it
+	template<typename TNode>
+	inline static TNode*
+	_get_successor_n(TNode* node, usize steps)
+	{
+		while (node != nullptr && steps > 0)
+		{
+			usize right_size = _get_subtree_size(node->right);
+			if (steps <= right_size)
+				return _get_nth(node->right, steps - 1);
+
+			//the whole right subtree is skipped and the next node is the first ancestor we reach from the left
+			steps -= right_size + 1;
+			while (node->parent != nullptr && node == node->parent->right)
+				node = node->parent;
+			node = node->parent;
+		}
+		return node;
+	}
+
+	//the in-order index of the node inside the whole tree, it's the count of the nodes before it
+	//it goes up to the root adding the left subtrees of the ancestors we reach from the right
+	template<typename TNode>
+	inline static usize
+	_get_index(TNode* node)
+	{
+		usize result = _get_subtree_size(node->left);
+		while (node->parent != nullptr)
+		{
+			if (node == node->parent->right)
+				result += _get_subtree_size(node->parent->left) + 1;
+			node = node->parent;
+		}
+		return result;
+	}
+
 	/**
 	 * @brief      A Red Black Tree iterator
 	 *
@@ -2166,13 +2237,15 @@ namespace cppr
 
 		Node_Type *node;
 		usize _count;
+		Node_Type *_end;
 
 		/**
 		 * @brief      Constructs an invalid tree range
 		 */
 		Tree_Range()
 			:node(nullptr),
-			 _count(0)
+			 _count(0),
+			 _end(nullptr)
 		{}
 
 		/**
@@ -2180,10 +2253,12 @@ namespace cppr
 		 *
 		 * @param      node_ptr     The tree node pointer
 		 * @param[in]  nodes_count  The nodes count in the tree
+		 * @param      end_ptr      The node after the last node of the range, nullptr if the range reaches the end of the tree
 		 */
-		Tree_Range(Node_Type *node_ptr, usize nodes_count)
+		Tree_Range(Node_Type *node_ptr, usize nodes_count, Node_Type *end_ptr = nullptr)
 			:node(node_ptr),
-			 _count(nodes_count)
+			 _count(nodes_count),
+			 _end(end_ptr)
 		{}
 
 		/**
@@ -2196,7 +2271,7 @@ namespace cppr
 		bool
 		operator==(const Tree_Range& other) const
 		{
-			return node == other.node && _count == other._count;
+			return node == other.node && _count == other._count && _end == other._end;
 		}
 
 		/**
@@ -2277,7 +2352,7 @@ namespace cppr
 		Const_Range_Type
 		all() const
 		{
-			return Const_Range_Type(node, _count);
+			return Const_Range_Type(node, _count, _end);
 		}
 
 		/**
@@ -2289,10 +2364,8 @@ namespace cppr
 		Range_Type
 		range(usize start, usize end)
 		{
-			auto it = node;
-			for(usize i = 0; i < start; ++i)
-				it = _get_successor(it);
-			return Range_Type(it, end - start);
+			Node_Type* start_ptr = _get_successor_n(node, start);
+			return Range_Type(start_ptr, end - start, _get_successor_n(start_ptr, end - start));
 		}
 
 		/**
@@ -2304,10 +2377,8 @@ namespace cppr
 		Const_Range_Type
 		range(usize start, usize end) const
 		{
-			auto it = node;
-			for(usize i = 0; i < start; ++i)
-				it = _get_successor(it);
-			return Const_Range_Type(it, end - start);
+			Node_Type* start_ptr = _get_successor_n(node, start);
+			return Const_Range_Type(start_ptr, end - start, _get_successor_n(start_ptr, end - start));
 		}
 
 		//Iterator interface
@@ -2348,7 +2419,7 @@ namespace cppr
 		iterator
 		end()
 		{
-			return iterator(nullptr);
+			return iterator(_end);
 		}
 
 		/**
@@ -2357,7 +2428,7 @@ namespace cppr
 		const_iterator
 		end() const
 		{
-			return const_iterator(nullptr);
+			return const_iterator(_end);
 		}
 
 		/**
@@ -2366,7 +2437,449 @@ namespace cppr
 		const_iterator
 		cend() const
 		{
-			return const_iterator(nullptr);
+			return const_iterator(_end);
+		}
+	};
+
+	//moves a position inside the linked leaves of a B-Tree forward by the given steps
+	//it skips the whole leaves instead of walking them one value at a time
+	template<typename TNode>
+	inline static void
+	_b_tree_advance(TNode*& node, usize& index, usize steps)
+	{
+		while(node != nullptr && steps > 0)
+		{
+			usize left = node->count - index;
+			if(steps < left)
+			{
+				index += steps;
+				return;
+			}
+			steps -= left;
+			node = node->next;
+			index = 0;
+		}
+	}
+
+	/**
+	 * @brief      A B-Tree iterator, it points to a value inside a leaf node and moves through the linked leaves
+	 *
+	 * @tparam     TNode  Leaf Node Type of the tree
+	 */
+	template<typename TNode>
+	struct B_Tree_Iterator
+	{
+		using Node_Type = TNode;
+		/**
+		 * Data type of the values in the tree
+		 */
+		using Data_Type = typename Node_Type::Data_Type;
+
+		Node_Type *node;
+		usize index;
+
+		/**
+		 * @brief      Constructs an invalid iterator
+		 */
+		B_Tree_Iterator()
+			:node(nullptr),
+			 index(0)
+		{}
+
+		/**
+		 * @brief      Constructs an iterator
+		 *
+		 * @param      node_ptr     The leaf node pointer
+		 * @param[in]  value_index  The index of the value inside the leaf node
+		 */
+		B_Tree_Iterator(Node_Type *node_ptr, usize value_index = 0)
+			:node(node_ptr),
+			 index(value_index)
+		{}
+
+		/**
+		 * @brief      Converts an iterator to a const iterator
+		 *
+		 * @param[in]  other  The other iterator
+		 */
+		template<typename TOther,
+				 typename = typename std::enable_if<std::is_same<const TOther, Node_Type>::value>::type>
+		B_Tree_Iterator(const B_Tree_Iterator<TOther>& other)
+			:node(other.node),
+			 index(other.index)
+		{}
+
+		/**
+		 * @brief      Moves this iterator forward in the tree
+		 *
+		 * @return     This iterator by reference
+		 */
+		B_Tree_Iterator&
+		operator++()
+		{
+			if(++index == node->count)
+			{
+				node = node->next;
+				index = 0;
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief      Moves this iterator forward in the tree
+		 *
+		 * @return     This iterator before moving forward by value
+		 */
+		B_Tree_Iterator
+		operator++(int)
+		{
+			B_Tree_Iterator result = *this;
+			operator++();
+			return result;
+		}
+
+		/**
+		 * @brief      Moves this iterator backward in the tree
+		 *
+		 * @return     This iterator by reference
+		 */
+		B_Tree_Iterator&
+		operator--()
+		{
+			if(index == 0)
+			{
+				node = node->prev;
+				index = node ? node->count - 1 : 0;
+			}
+			else
+			{
+				--index;
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief      Moves this iterator backward in the tree
+		 *
+		 * @return     This iterator before moving backward by value
+		 */
+		B_Tree_Iterator
+		operator--(int)
+		{
+			B_Tree_Iterator result = *this;
+			operator--();
+			return result;
+		}
+
+		/**
+		 * @brief      The Equal comparator operator
+		 *
+		 * @param[in]  other  The other iterator to compare
+		 *
+		 * @return     Whether the two iterators points to the same value
+		 */
+		bool
+		operator==(const B_Tree_Iterator& other) const
+		{
+			return node == other.node && index == other.index;
+		}
+
+		/**
+		 * @brief      The Not-Equal comparator operator
+		 *
+		 * @param[in]  other  The other iterator to compare
+		 *
+		 * @return     Whether the two iterators points to different values
+		 */
+		bool
+		operator!=(const B_Tree_Iterator& other) const
+		{
+			return !operator==(other);
+		}
+
+		/**
+		 * @brief      The Arrow access operator
+		 *
+		 * @return     A Pointer to the underlying value
+		 */
+		template<typename TCond = Node_Type, typename = typename std::enable_if<!std::is_const<TCond>::value>::type>
+		Data_Type*
+		operator->()
+		{
+			return &node->data(index);
+		}
+
+		/**
+		 * @brief      The Const arrow access operator
+		 *
+		 * @return     A Const pointer to the underlying value
+		 */
+		const Data_Type*
+		operator->() const
+		{
+			return &node->data(index);
+		}
+
+		/**
+		 * @brief      The Dereference operator
+		 *
+		 * @return     The underlying value by reference
+		 */
+		template<typename TCond = Node_Type, typename = typename std::enable_if<!std::is_const<TCond>::value>::type>
+		Data_Type&
+		operator*()
+		{
+			return node->data(index);
+		}
+
+		/**
+		 * @brief      The Const dereference operator
+		 *
+		 * @return     The underlying value by const reference
+		 */
+		const Data_Type&
+		operator*() const
+		{
+			return node->data(index);
+		}
+	};
+
+	/**
+	 * @brief      A B-Tree Range
+	 *
+	 * @tparam     TNode  Leaf Node type of the tree
+	 */
+	template<typename TNode>
+	struct B_Tree_Range
+	{
+		using Node_Type = TNode;
+		/**
+		 * Data Type of the values in the tree
+		 */
+		using Data_Type = typename Node_Type::Data_Type;
+		/**
+		 * Range Type of this range
+		 */
+		using Range_Type = B_Tree_Range<Node_Type>;
+		/**
+		 * Const Range Type of this range
+		 */
+		using Const_Range_Type = B_Tree_Range<const Node_Type>;
+		/**
+		 * Iterator type of this range
+		 */
+		using iterator = B_Tree_Iterator<Node_Type>;
+		/**
+		 * Const Iterator type of this range
+		 */
+		using const_iterator = B_Tree_Iterator<const Node_Type>;
+
+		iterator _begin, _end;
+		usize _count;
+
+		/**
+		 * @brief      Constructs an invalid tree range
+		 */
+		B_Tree_Range()
+			:_count(0)
+		{}
+
+		/**
+		 * @brief      Constructs a tree range
+		 *
+		 * @param[in]  begin_it      The begin iterator of the range
+		 * @param[in]  end_it        The end iterator of the range
+		 * @param[in]  values_count  The count of values between the begin and end
+		 */
+		B_Tree_Range(iterator begin_it, iterator end_it, usize values_count)
+			:_begin(begin_it),
+			 _end(end_it),
+			 _count(values_count)
+		{}
+
+		/**
+		 * @brief      The Equal comparator operator
+		 *
+		 * @param[in]  other  The other range to compare
+		 *
+		 * @return     Whether the two ranges point to the same range
+		 */
+		bool
+		operator==(const B_Tree_Range& other) const
+		{
+			return _begin == other._begin && _count == other._count;
+		}
+
+		/**
+		 * @brief      The Not-Equal comparator operator
+		 *
+		 * @param[in]  other  The other range to compare
+		 *
+		 * @return     Whether the two ranges point to different ranges
+		 */
+		bool
+		operator!=(const B_Tree_Range& other) const
+		{
+			return !operator==(other);
+		}
+
+		//Forward Range interface
+		/**
+		 * @return     Whether the range is empty
+		 */
+		bool
+		empty() const
+		{
+			return _count == 0;
+		}
+
+		/**
+		 * @return     The Front value of the range by reference
+		 */
+		template<typename TCond = TNode,
+				 typename = typename std::enable_if<!std::is_const<TCond>::value>::type>
+		Data_Type&
+		front()
+		{
+			return *_begin;
+		}
+
+		/**
+		 * @return     The Front value of the range by const reference
+		 */
+		const Data_Type&
+		front() const
+		{
+			return *_begin;
+		}
+
+		/**
+		 * @brief      Pops the front value of this range
+		 */
+		void
+		pop_front()
+		{
+			++_begin;
+			--_count;
+		}
+
+		/**
+		 * @return     The count of elements inside the range
+		 */
+		usize
+		count() const
+		{
+			return _count;
+		}
+
+		//Container interface
+		/**
+		 * @return     A Range view of entire tree range
+		 */
+		Range_Type
+		all()
+		{
+			return *this;
+		}
+
+		/**
+		 * @return     A Const Range view of entire tree range
+		 */
+		Const_Range_Type
+		all() const
+		{
+			return Const_Range_Type(_begin, _end, _count);
+		}
+
+		/**
+		 * @param[in]  start  The start index of the range
+		 * @param[in]  end    The end index of the range
+		 *
+		 * @return     Range viewing the specified values in the range
+		 */
+		Range_Type
+		range(usize start, usize end)
+		{
+			iterator first = _begin;
+			_b_tree_advance(first.node, first.index, start);
+			iterator last = first;
+			_b_tree_advance(last.node, last.index, end - start);
+			return Range_Type(first, last, end - start);
+		}
+
+		/**
+		 * @param[in]  start  The start index of the range
+		 * @param[in]  end    The end index of the range
+		 *
+		 * @return     Const range viewing the specified values in the range
+		 */
+		Const_Range_Type
+		range(usize start, usize end) const
+		{
+			const_iterator first = _begin;
+			_b_tree_advance(first.node, first.index, start);
+			const_iterator last = first;
+			_b_tree_advance(last.node, last.index, end - start);
+			return Const_Range_Type(first, last, end - start);
+		}
+
+		//Iterator interface
+		/**
+		 * @return     An Iterator to the start of the range
+		 */
+		template<typename TCond = Node_Type,
+				 typename = typename std::enable_if<!std::is_const<TCond>::value>::type>
+		iterator
+		begin()
+		{
+			return _begin;
+		}
+
+		/**
+		 * @return     A Const iterator to the start of the range
+		 */
+		const_iterator
+		begin() const
+		{
+			return _begin;
+		}
+
+		/**
+		 * @return     A Const iterator to the start of the range
+		 */
+		const_iterator
+		cbegin() const
+		{
+			return _begin;
+		}
+
+		/**
+		 * @return     An iterator to the end of the range
+		 */
+		template<typename TCond = Node_Type,
+				 typename = typename std::enable_if<!std::is_const<TCond>::value>::type>
+		iterator
+		end()
+		{
+			return _end;
+		}
+
+		/**
+		 * @return     A Const iterator to the end of the range
+		 */
+		const_iterator
+		end() const
+		{
+			return _end;
+		}
+
+		/**
+		 * @return     A Const iterator to the end of the range
+		 */
+		const_iterator
+		cend() const
+		{
+			return _end;
 		}
 	};
 
@@ -3014,7 +3527,7 @@ namespace cppr
 	 * @brief      A Hash Table Iterator
 	 *
 	 * @tparam     T       Type of the values in the hash table
-	 * @tparam     TFlags  Type of flags in the hash table
+	 * @tparam     TFlags  Type of flags in the hash table, `_hash_flag_used(flag)` should be found by ADL
 	 */
 	template<typename T, typename TFlags>
 	struct Hash_Iterator
@@ -3061,8 +3574,8 @@ namespace cppr
 			++_flag;
 			++ptr;
 			--_capacity;
-			while(*_flag != TFlags::USED &&
-				  _capacity > 0)
+			while(_capacity > 0 &&
+				  !_hash_flag_used(*_flag))
 			{
 				++_flag;
 				++ptr;
@@ -3083,8 +3596,8 @@ namespace cppr
 			++_flag;
 			++ptr;
 			--_capacity;
-			while(*_flag != TFlags::USED &&
-				  _capacity > 0)
+			while(_capacity > 0 &&
+				  !_hash_flag_used(*_flag))
 			{
 				++_flag;
 				++ptr;
@@ -0,0 +1,787 @@
+#pragma once
+
+#include "cpprelude/defines.h"
+#include "cpprelude/Hash_Map.h"
+
+namespace cppr
+{
+	/**
+	 * @brief      A hash map which stores up to N key-value pairs inline without any allocation, and moves them into
+	 * a Hash_Map once it holds more than N pairs.
+	 * The inline pairs have a 16 control bytes group next to them holding the 7 bits hash fragment of each pair
+	 * like the Hash_Map slots, so a lookup is a single group match (using SSE2 when available) and only the keys
+	 * with a matching fragment are compared.
+	 * The inline pairs are moved one by one when the small map is moved, and the pairs are unordered.
+	 *
+	 * @tparam     TKey    Type of the keys
+	 * @tparam     TValue  Type of the values
+	 * @tparam     N       The count of inline pairs, it can be up to 16
+	 * @tparam     THash   Type of the hash functor
+	 */
+	template<typename TKey, typename TValue, usize N = 8,
+			 typename THash = internal::Pair_Hash_Functor<TKey, TValue>>
+	struct Small_Map
+	{
+		static_assert(N > 0 && N <= internal::HASH_GROUP_WIDTH, "Small_Map inline count must be in [1, 16]");
+
+		/**
+		 * The hash map which holds the pairs once they're more than N
+		 */
+		using Map_Type = Hash_Map<TKey, TValue, THash>;
+
+		/**
+		 * Data type of the small map
+		 */
+		using Data_Type = typename Map_Type::Data_Type;
+
+		/**
+		 * Range Type of the small map
+		 */
+		using Range_Type = typename Map_Type::Range_Type;
+
+		/**
+		 * Const Range Type of the small map
+		 */
+		using Const_Range_Type = typename Map_Type::Const_Range_Type;
+
+		/**
+		 * Iterator type of this container, it's the same in the inline and the hashed mode
+		 */
+		using iterator = typename Map_Type::iterator;
+
+		/**
+		 * Const Iterator type of this container
+		 */
+		using const_iterator = typename Map_Type::const_iterator;
+
+		internal::HASH_FLAGS _tags[internal::HASH_GROUP_WIDTH];
+		alignas(Data_Type) byte _inline[N * sizeof(Data_Type)];
+		usize _inline_count;
+		Map_Type _map;
+
+		/**
+		 * @brief      Constructs a small map that uses the provided memory context once it outgrows its inline pairs
+		 *
+		 * @param      context  The memory context to use for allocation and freeing
+		 */
+		Small_Map(Allocator_Trait* context = allocator())
+			:_inline_count(0),
+			 _map(context)
+		{
+			_clear_tags();
+		}
+
+		/**
+		 * @brief      Constructs a small map that uses the provided memory context once it outgrows its inline pairs
+		 *
+		 * @param[in]  hasher   The hasher functor to use
+		 * @param      context  The memory context to use for allocation and freeing
+		 */
+		Small_Map(const THash& hasher, Allocator_Trait* context = allocator())
+			:_inline_count(0),
+			 _map(hasher, context)
+		{
+			_clear_tags();
+		}
+
+		/**
+		 * @brief      Copy constructor
+		 *
+		 * @param[in]  other  The other small map to copy from
+		 */
+		Small_Map(const Small_Map& other)
+			:_inline_count(0),
+			 _map(other._map)
+		{
+			_copy_inline(other);
+		}
+
+		/**
+		 * @brief      Copy constructor with another memory context
+		 *
+		 * @param[in]  other    The other small map to copy from
+		 * @param      context  The context to use for memory allocation and freeing
+		 */
+		Small_Map(const Small_Map& other, Allocator_Trait* context)
+			:_inline_count(0),
+			 _map(other._map, context)
+		{
+			_copy_inline(other);
+		}
+
+		/**
+		 * @brief      Move constructor
+		 *
+		 * @param[in]  other  The other small map to move from
+		 */
+		Small_Map(Small_Map&& other)
+			:_inline_count(0),
+			 _map(std::move(other._map))
+		{
+			_move_inline(other);
+		}
+
+		/**
+		 * @brief      Copy assignment operator
+		 *
+		 * @param[in]  other  The other small map to copy values from
+		 *
+		 * @return     A Reference to this small map
+		 */
+		Small_Map&
+		operator=(const Small_Map& other)
+		{
+			_destroy_inline();
+			_map = other._map;
+			_copy_inline(other);
+			return *this;
+		}
+
+		/**
+		 * @brief      Move assignment operator
+		 *
+		 * @param[in]  other  The other small map to move values from
+		 *
+		 * @return     A Reference to this small map
+		 */
+		Small_Map&
+		operator=(Small_Map&& other)
+		{
+			_destroy_inline();
+			_map = std::move(other._map);
+			_move_inline(other);
+			return *this;
+		}
+
+		/**
+		 * @brief      Destroys the small map
+		 */
+		~Small_Map()
+		{
+			_destroy_inline();
+		}
+
+		/**
+		 * @return     Whether the pairs are stored inline, it's true until the small map holds more than N pairs
+		 */
+		bool
+		is_inline() const
+		{
+			return _map.capacity() == 0;
+		}
+
+		/**
+		 * @return     The capacity of this small map, it's N while the pairs are inline
+		 */
+		usize
+		capacity() const
+		{
+			return is_inline() ? N : _map.capacity();
+		}
+
+		/**
+		 * @return     The count of values in this small map
+		 */
+		usize
+		count() const
+		{
+			return is_inline() ? _inline_count : _map.count();
+		}
+
+		/**
+		 * @return     Whether the small map is empty
+		 */
+		bool
+		empty() const
+		{
+			return count() == 0;
+		}
+
+		/**
+		 * @brief      Ensures that the small map has the capacity for the expected count, if they don't fit inline
+		 * the pairs are moved into the hash map
+		 *
+		 * @param[in]  expected_count  The expected count to reserve
+		 */
+		void
+		reserve(usize expected_count)
+		{
+			if(is_inline() == false)
+				_map.reserve(expected_count);
+			else if(_inline_count + expected_count > N)
+				_spill(_inline_count + expected_count);
+		}
+
+		/**
+		 * @brief      Shrinks the memory of the small map, if the pairs fit inline they're moved back and the memory is freed
+		 */
+		void
+		shrink_to_fit()
+		{
+			if(is_inline())
+				return;
+
+			if(_map.count() > N)
+			{
+				_map.shrink_to_fit();
+				return;
+			}
+
+			for(auto& pair: _map)
+			{
+				usize hash_value = _map._hasher(pair.key);
+				::new (_pairs() + _inline_count) Data_Type(std::move(pair));
+				_tags[_inline_count++] = static_cast<internal::HASH_FLAGS>(internal::_hash_h2(hash_value));
+			}
+			_map.reset();
+		}
+
+		/**
+		 * @param[in]  key  The key to be inserted, and value of this key will be default initialized
+		 *
+		 * @return     An Iterator to the inserted key-value pair
+		 */
+		iterator
+		insert(const TKey& key)
+		{
+			return _emplace(key);
+		}
+
+		/**
+		 * @param[in]  key  The key to be inserted, and value of this key will be default initialized
+		 *
+		 * @return     An Iterator to the inserted key-value pair
+		 */
+		iterator
+		insert(TKey&& key)
+		{
+			return _emplace(std::move(key));
+		}
+
+		/**
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted
+		 *
+		 * @return     An Iterator to the inserted key-value pair, or to the existing pair if the key exists
+		 */
+		iterator
+		insert(const TKey& key, const TValue& value)
+		{
+			return _emplace(key, value);
+		}
+
+		/**
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted
+		 *
+		 * @return     An Iterator to the inserted key-value pair, or to the existing pair if the key exists
+		 */
+		iterator
+		insert(const TKey& key, TValue&& value)
+		{
+			return _emplace(key, std::move(value));
+		}
+
+		/**
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted
+		 *
+		 * @return     An Iterator to the inserted key-value pair, or to the existing pair if the key exists
+		 */
+		iterator
+		insert(TKey&& key, const TValue& value)
+		{
+			return _emplace(std::move(key), value);
+		}
+
+		/**
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted
+		 *
+		 * @return     An Iterator to the inserted key-value pair, or to the existing pair if the key exists
+		 */
+		iterator
+		insert(TKey&& key, TValue&& value)
+		{
+			return _emplace(std::move(key), std::move(value));
+		}
+
+		/**
+		 * @brief      Inserts a value constructed in place from the given args if the key doesn't exist,
+		 * if it exists nothing is constructed and the small map is left unchanged
+		 *
+		 * @param[in]  key   The key to be inserted
+		 * @param[in]  args  values that will be passed to the value type constructor
+		 *
+		 * @tparam     TArgs      Variadic template type
+		 *
+		 * @return     An Iterator to the inserted or the existing key-value pair
+		 */
+		template<typename ... TArgs>
+		iterator
+		try_emplace(const TKey& key, TArgs&& ... args)
+		{
+			return _emplace(key, std::forward<TArgs>(args)...);
+		}
+
+		/**
+		 * @brief      Inserts a value constructed in place from the given args if the key doesn't exist,
+		 * if it exists nothing is constructed and the small map is left unchanged
+		 *
+		 * @param[in]  key   The key to be inserted
+		 * @param[in]  args  values that will be passed to the value type constructor
+		 *
+		 * @tparam     TArgs      Variadic template type
+		 *
+		 * @return     An Iterator to the inserted or the existing key-value pair
+		 */
+		template<typename ... TArgs>
+		iterator
+		try_emplace(TKey&& key, TArgs&& ... args)
+		{
+			return _emplace(std::move(key), std::forward<TArgs>(args)...);
+		}
+
+		/**
+		 * @brief      Inserts the key-value pair if the key doesn't exist, otherwise assigns the value to the existing key
+		 *
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted or assigned
+		 *
+		 * @return     An Iterator to the inserted or the assigned key-value pair
+		 */
+		template<typename TArg>
+		iterator
+		insert_or_assign(const TKey& key, TArg&& value)
+		{
+			usize old_count = count();
+			auto it = _emplace(key, std::forward<TArg>(value));
+			if(old_count == count())
+				it->value = std::forward<TArg>(value);
+			return it;
+		}
+
+		/**
+		 * @brief      Inserts the key-value pair if the key doesn't exist, otherwise assigns the value to the existing key
+		 *
+		 * @param[in]  key    The key to be inserted
+		 * @param[in]  value  The value to be inserted or assigned
+		 *
+		 * @return     An Iterator to the inserted or the assigned key-value pair
+		 */
+		template<typename TArg>
+		iterator
+		insert_or_assign(TKey&& key, TArg&& value)
+		{
+			usize old_count = count();
+			auto it = _emplace(std::move(key), std::forward<TArg>(value));
+			if(old_count == count())
+				it->value = std::forward<TArg>(value);
+			return it;
+		}
+
+		/**
+		 * @brief      Access a value of the small map with the given key. if the value doesn't exist it will be added with a default initialized value
+		 *
+		 * @param[in]  key   The key to be accessed
+		 *
+		 * @return     The corresponding value by reference
+		 */
+		TValue&
+		operator[](const TKey& key)
+		{
+			return _emplace(key)->value;
+		}
+
+		/**
+		 * @brief      Access a value of the small map with the given key. if the value doesn't exist it will be added with a default initialized value
+		 *
+		 * @param[in]  key   The key to be accessed
+		 *
+		 * @return     The corresponding value by reference
+		 */
+		TValue&
+		operator[](TKey&& key)
+		{
+			return _emplace(std::move(key))->value;
+		}
+
+		/**
+		 * @param[in]  key  The key to search for
+		 *
+		 * @return     An Iterator to the found value, or an iterator to the end if not found
+		 */
+		iterator
+		lookup(const TKey& key)
+		{
+			if(is_inline() == false)
+				return _map.lookup(key);
+			return _inline_iterator(_inline_index(key, _map._hasher(key)));
+		}
+
+		/**
+		 * @param[in]  key  The key to search for
+		 *
+		 * @return     A Const Iterator to the found value, or an iterator to the end if not found
+		 */
+		const_iterator
+		lookup(const TKey& key) const
+		{
+			if(is_inline() == false)
+				return _map.lookup(key);
+			return _inline_iterator(_inline_index(key, _map._hasher(key)));
+		}
+
+		/**
+		 * @brief      Heterogeneous lookup, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 *
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     An Iterator to the found value, or an iterator to the end if not found
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		iterator
+		lookup(const TLookup& key)
+		{
+			if(is_inline() == false)
+				return _map.lookup(key);
+			return _inline_iterator(_inline_index(key, _map._hasher(key)));
+		}
+
+		/**
+		 * @brief      Heterogeneous lookup, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 *
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     A Const Iterator to the found value, or an iterator to the end if not found
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		const_iterator
+		lookup(const TLookup& key) const
+		{
+			if(is_inline() == false)
+				return _map.lookup(key);
+			return _inline_iterator(_inline_index(key, _map._hasher(key)));
+		}
+
+		/**
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     Whether the key exists in the small map
+		 */
+		bool
+		contains(const TKey& key) const
+		{
+			return lookup(key) != end();
+		}
+
+		/**
+		 * @brief      Heterogeneous contains, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 *
+		 * @param[in]  key   The key to search for
+		 *
+		 * @return     Whether the key exists in the small map
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		bool
+		contains(const TLookup& key) const
+		{
+			return lookup(key) != end();
+		}
+
+		/**
+		 * @brief      Removes the key, the last inline pair is moved into its place
+		 *
+		 * @param[in]  key   The key to be removed
+		 *
+		 * @return     True if removed the value, false if the value doesn't exist
+		 */
+		bool
+		remove(const TKey& key)
+		{
+			if(is_inline() == false)
+				return _map.remove(key);
+			return _remove_inline(_inline_index(key, _map._hasher(key)));
+		}
+
+		/**
+		 * @brief      Heterogeneous remove, it's only available if the hasher is transparent (has an `is_transparent` type)
+		 *
+		 * @param[in]  key   The key to be removed
+		 *
+		 * @return     True if removed the value, false if the value doesn't exist
+		 */
+		template<typename TLookup, typename THasher = THash, typename = typename THasher::is_transparent>
+		bool
+		remove(const TLookup& key)
+		{
+			if(is_inline() == false)
+				return _map.remove(key);
+			return _remove_inline(_inline_index(key, _map._hasher(key)));
+		}
+
+		/**
+		 * @param[in]  it    The iterator to the value to be removed
+		 *
+		 * @return     True if removed the value, false if the value doesn't exist
+		 */
+		bool
+		remove(const iterator& it)
+		{
+			if(is_inline() == false)
+				return _map.remove(it);
+			return _remove_inline(it._flag - _tags);
+		}
+
+		/**
+		 * @param[in]  it    The iterator to the value to be removed
+		 *
+		 * @return     True if removed the value, false if the value doesn't exist
+		 */
+		bool
+		remove(const const_iterator& it)
+		{
+			if(is_inline() == false)
+				return _map.remove(it);
+			return _remove_inline(it._flag - _tags);
+		}
+
+		/**
+		 * @brief      Removes all the values of the small map, if it moved into the hash map it keeps its memory
+		 */
+		void
+		clear()
+		{
+			_destroy_inline();
+			_map.clear();
+		}
+
+		/**
+		 * @brief      Removes all the values of the small map and frees the memory, so it goes back to the inline pairs
+		 */
+		void
+		reset()
+		{
+			_destroy_inline();
+			_map.reset();
+		}
+
+		/**
+		 * @return     Range viewing all the values in the small map
+		 */
+		Range_Type
+		all()
+		{
+			return Range_Type(begin(), end());
+		}
+
+		/**
+		 * @return     Const range viewing all the values in the small map
+		 */
+		Const_Range_Type
+		all() const
+		{
+			return Const_Range_Type(begin(), end());
+		}
+
+		/**
+		 * @return     An Iterator to the beginning of this container
+		 */
+		iterator
+		begin()
+		{
+			if(is_inline() == false)
+				return _map.begin();
+			return _inline_iterator(_inline_count == 0 ? N : 0);
+		}
+
+		/**
+		 * @return     A Const iterator to the beginning of this container
+		 */
+		const_iterator
+		begin() const
+		{
+			if(is_inline() == false)
+				return _map.begin();
+			return _inline_iterator(_inline_count == 0 ? N : 0);
+		}
+
+		/**
+		 * @return     A Const iterator to the beginning of this container
+		 */
+		const_iterator
+		cbegin() const
+		{
+			return begin();
+		}
+
+		/**
+		 * @return     An Iterator to the end of the container
+		 */
+		iterator
+		end()
+		{
+			if(is_inline() == false)
+				return _map.end();
+			return _inline_iterator(N);
+		}
+
+		/**
+		 * @return     A Const Iterator to the end of the container
+		 */
+		const_iterator
+		end() const
+		{
+			if(is_inline() == false)
+				return _map.end();
+			return _inline_iterator(N);
+		}
+
+		/**
+		 * @return     A Const Iterator to the end of the container
+		 */
+		const_iterator
+		cend() const
+		{
+			return end();
+		}
+
+		Data_Type*
+		_pairs()
+		{
+			return reinterpret_cast<Data_Type*>(_inline);
+		}
+
+		const Data_Type*
+		_pairs() const
+		{
+			return reinterpret_cast<const Data_Type*>(_inline);
+		}
+
+		//the inline pairs are kept packed at the front, so the iterator runs over the used control bytes then skips
+		//the empty ones until the N end
+		iterator
+		_inline_iterator(usize index)
+		{
+			return iterator(_pairs() + index, _tags + index, N - index);
+		}
+
+		const_iterator
+		_inline_iterator(usize index) const
+		{
+			return const_iterator(_pairs() + index, _tags + index, N - index);
+		}
+
+		void
+		_clear_tags()
+		{
+			for(usize i = 0; i < internal::HASH_GROUP_WIDTH; ++i)
+				_tags[i] = internal::HASH_FLAGS::EMPTY;
+		}
+
+		//the unused control bytes are empty and never match a hash fragment
+		template<typename TLookup>
+		usize
+		_inline_index(const TLookup& key, usize hash_value) const
+		{
+			u32 mask = internal::Hash_Group(_tags).match(internal::_hash_h2(hash_value));
+			while(mask)
+			{
+				usize index = internal::_hash_bit_index(mask);
+				if(_pairs()[index].key == key)
+					return index;
+				mask &= mask - 1;
+			}
+			return N;
+		}
+
+		template<typename TKeyArg, typename ... TArgs>
+		iterator
+		_emplace(TKeyArg&& key, TArgs&& ... args)
+		{
+			Map_Type& map = _map;
+			if(is_inline() == false)
+			{
+				usize index = map._emplace_index(std::forward<TKeyArg>(key), std::forward<TArgs>(args)...);
+				return iterator(map._values.ptr + index, map._flags.ptr + index, map._capacity - index);
+			}
+
+			usize hash_value = map._hasher(key);
+			usize index = _inline_index(key, hash_value);
+			if(index != N)
+				return _inline_iterator(index);
+
+			if(_inline_count == N)
+			{
+				_spill(N * 2);
+				index = map._emplace_index_hashed(hash_value, std::forward<TKeyArg>(key), std::forward<TArgs>(args)...);
+				return iterator(map._values.ptr + index, map._flags.ptr + index, map._capacity - index);
+			}
+
+			index = _inline_count;
+			::new (_pairs() + index) Data_Type(internal::Hash_Emplace_Tag(), std::forward<TKeyArg>(key), std::forward<TArgs>(args)...);
+			_tags[index] = static_cast<internal::HASH_FLAGS>(internal::_hash_h2(hash_value));
+			++_inline_count;
+			return _inline_iterator(index);
+		}
+
+		//moves the inline pairs into the hash map which is reserved for the expected count
+		void
+		_spill(usize expected_count)
+		{
+			_map.reserve(expected_count);
+			for(usize i = 0; i < _inline_count; ++i)
+				_map._emplace_index(_pairs()[i].key, std::move(_pairs()[i].value));
+			_destroy_inline();
+		}
+
+		bool
+		_remove_inline(usize index)
+		{
+			if(index >= _inline_count)
+				return false;
+
+			usize last = _inline_count - 1;
+			_pairs()[index].~Data_Type();
+			if(index != last)
+			{
+				::new (_pairs() + index) Data_Type(std::move(_pairs()[last]));
+				_pairs()[last].~Data_Type();
+				_tags[index] = _tags[last];
+			}
+			_tags[last] = internal::HASH_FLAGS::EMPTY;
+			--_inline_count;
+			return true;
+		}
+
+		void
+		_destroy_inline()
+		{
+			for(usize i = 0; i < _inline_count; ++i)
+				_pairs()[i].~Data_Type();
+			_inline_count = 0;
+			_clear_tags();
+		}
+
+		void
+		_copy_inline(const Small_Map& other)
+		{
+			for(usize i = 0; i < other._inline_count; ++i)
+				::new (_pairs() + i) Data_Type(other._pairs()[i]);
+			for(usize i = 0; i < internal::HASH_GROUP_WIDTH; ++i)
+				_tags[i] = other._tags[i];
+			_inline_count = other._inline_count;
+		}
+
+		void
+		_move_inline(Small_Map& other)
+		{
+			for(usize i = 0; i < other._inline_count; ++i)
+				::new (_pairs() + i) Data_Type(std::move(other._pairs()[i]));
+			for(usize i = 0; i < internal::HASH_GROUP_WIDTH; ++i)
+				_tags[i] = other._tags[i];
+			_inline_count = other._inline_count;
+			other._destroy_inline();
+		}
+	};
+}
@@ -431,8 +431,12 @@ namespace cppr
 		 * @return     Whether the two strings are equal
 		 */
 		bool
-		operator==(const Range_Type& str)
+		operator==(const Range_Type& str) const
 		{
+			//a default constructed string has no null terminator
+			if(_bytes_size == 0)
+				return str.bytes.size == 0;
+
 			if(_bytes_size - 1 != str.bytes.size)
 				return false;
 
@@ -515,7 +519,7 @@ namespace cppr
 		 * @return     Whether the two strings are equal
 		 */
 		bool
-		operator==(const char* str)
+		operator==(const char* str) const
 		{
 			return operator==(make_strrng(str));
 		}
@@ -815,13 +819,39 @@ namespace cppr
 		}
 	};
 
+	/**
+	 * @brief      String hash functor
+	 * It's transparent, so the hash containers with String keys can be searched with String_Range and c strings
+	 * without constructing a String, all of them produce the same hash as Hash<String_Range> of the same bytes
+	 * and the same algorithm
+	 */
 	template<>
 	struct Hash<String>
 	{
+		using is_transparent = void;
+
+		HASH_ALGORITHM algorithm;
+
+		Hash(HASH_ALGORITHM hash_algorithm = DEFAULT_HASH_ALGORITHM)
+			:algorithm(hash_algorithm)
+		{}
+
 		inline usize
 		operator()(const String& data) const
 		{
-			return murmur_hash(data._bytes.ptr, data._bytes_size);
+			return operator()(data.all());
+		}
+
+		inline usize
+		operator()(const String_Range& data) const
+		{
+			return hash_bytes(data.data(), data.size(), algorithm);
+		}
+
+		inline usize
+		operator()(const char* str) const
+		{
+			return operator()(make_strrng(str));
 		}
 	};
 
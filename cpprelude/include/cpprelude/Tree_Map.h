@@ -4,6 +4,8 @@
 #include "cpprelude/defaults.h"
 #include "cpprelude/Ranges.h"
 #include "cpprelude/OS.h"
+#include "cpprelude/Panic.h"
+#include "cpprelude/Dynamic_Array.h"
 #include <utility>
 
 namespace cppr
@@ -18,12 +20,15 @@ namespace cppr
 			enum Color_Type: bool { RED, BLACK };
 			Red_Black_Tree_Node<T> *left, *right, *parent;
 			T data;
+			//count of the nodes in the subtree rooted at this node including itself
+			usize size;
 			Color_Type color;
 
 			Red_Black_Tree_Node()
 				:left(nullptr),
 				 right(nullptr),
 				 parent(nullptr),
+				 size(1),
 				 color(RED)
 			{}
 
@@ -32,6 +37,7 @@ namespace cppr
 				 right(nullptr),
 				 parent(nullptr),
 				 data(node_data),
+				 size(1),
 				 color(node_color)
 			{}
 
@@ -40,6 +46,7 @@ namespace cppr
 				 right(nullptr),
 				 parent(nullptr),
 				 data(std::move(node_data)),
+				 size(1),
 				 color(node_color)
 			{}
 		};
@@ -148,6 +155,8 @@ namespace cppr
 		usize _count;
 		Allocator_Trait* _allocator;
 		TCompare _less_than;
+		//the node blocks of build_from_sorted, merge adopts the blocks of the other tree with its nodes
+		Dynamic_Array<Owner<Node_Type>> _blocks;
 
 		/**
 		 * @brief      Constructs a tree
@@ -155,7 +164,7 @@ namespace cppr
 		 * @param[in]  context  The memory context to use for memory allocation and freeing
 		 */
 		Red_Black_Tree(Allocator_Trait* context = allocator())
-			:_root(nullptr), _count(0), _allocator(context)
+			:_root(nullptr), _count(0), _allocator(context), _blocks(context)
 		{}
 
 		/**
@@ -167,7 +176,7 @@ namespace cppr
 		Red_Black_Tree(const TCompare& compare_function,
 					   Allocator_Trait* context = allocator())
 			:_root(nullptr), _count(0), _allocator(context),
-			 _less_than(compare_function)
+			 _less_than(compare_function), _blocks(context)
 		{}
 
 		/**
@@ -180,7 +189,8 @@ namespace cppr
 		Red_Black_Tree(std::initializer_list<T> list,
 					   const TCompare& compare_function = TCompare(),
 					   Allocator_Trait* context = allocator())
-			:_root(nullptr), _count(0), _allocator(context), _less_than(compare_function)
+			:_root(nullptr), _count(0), _allocator(context), _less_than(compare_function),
+			 _blocks(context)
 		{
 			auto it = list.begin();
 			for(usize i = 0;
@@ -199,7 +209,7 @@ namespace cppr
 		 */
 		Red_Black_Tree(const Red_Black_Tree& other)
 			:_root(nullptr), _count(0), _allocator(other._allocator),
-			 _less_than(other._less_than)
+			 _less_than(other._less_than), _blocks(other._allocator)
 		{
 			_copy_content(other);
 		}
@@ -213,7 +223,7 @@ namespace cppr
 		Red_Black_Tree(const Red_Black_Tree& other,
 					   const TCompare& compare_function)
 			:_root(nullptr), _count(0), _allocator(other._allocator),
-			 _less_than(compare_function)
+			 _less_than(compare_function), _blocks(other._allocator)
 		{
 			_copy_content(other);
 		}
@@ -227,7 +237,7 @@ namespace cppr
 		Red_Black_Tree(const Red_Black_Tree& other,
 					   Allocator_Trait* context)
 			:_root(nullptr), _count(0), _allocator(context),
-			 _less_than(other._less_than)
+			 _less_than(other._less_than), _blocks(context)
 		{
 			_copy_content(other);
 		}
@@ -243,7 +253,7 @@ namespace cppr
 					   Allocator_Trait* context,
 					   const TCompare& compare_function)
 			:_root(nullptr), _count(0), _allocator(context),
-			 _less_than(compare_function)
+			 _less_than(compare_function), _blocks(context)
 		{
 			_copy_content(other);
 		}
@@ -256,7 +266,8 @@ namespace cppr
 		Red_Black_Tree(Red_Black_Tree&& other)
 			:_root(other._root), _count(other._count),
 			 _allocator(std::move(other._allocator)),
-			 _less_than(std::move(other._less_than))
+			 _less_than(std::move(other._less_than)),
+			 _blocks(std::move(other._blocks))
 		{
 			other._root = nullptr;
 			other._count = 0;
@@ -298,8 +309,10 @@ namespace cppr
 		operator=(Red_Black_Tree&& other)
 		{
 			_reset(_root);
+			_free_blocks();
 			_allocator = std::move(other._allocator);
 			_less_than = std::move(other._less_than);
+			_blocks = std::move(other._blocks);
 
 			_count = other._count;
 			_root = other._root;
@@ -317,6 +330,7 @@ namespace cppr
 			_reset(_root);
 			_root = nullptr;
 			_count = 0;
+			_free_blocks();
 		}
 
 		/**
@@ -419,6 +433,9 @@ namespace cppr
 			else
 				y.node->parent->right = x;
 
+			//the sizes are fixed before the fixup since its rotations depend on them
+			_update_sizes(x_parent, -1);
+
 			if (y != node_to_delete)
 			{
 				TConstFreeDataType& node_to_delete_data = (TConstFreeDataType&)node_to_delete.node->data;
@@ -616,6 +633,7 @@ namespace cppr
 			std::swap(_count, other._count);
 			std::swap(_allocator, other._allocator);
 			std::swap(_less_than, other._less_than);
+			std::swap(_blocks, other._blocks);
 		}
 
 		/**
@@ -654,6 +672,275 @@ namespace cppr
 			return const_iterator(_max());
 		}
 
+		/**
+		 * @param[in]  index  The in-order index of the value
+		 *
+		 * @return     An iterator to the value with the given index in the sorted order or to
+		 *             the end of the tree if the index is out of range
+		 */
+		iterator
+		select(usize index)
+		{
+			return iterator(_get_nth(_root, index));
+		}
+
+		/**
+		 * @param[in]  index  The in-order index of the value
+		 *
+		 * @return     A const iterator to the value with the given index in the sorted order or to
+		 *             the end of the tree if the index is out of range
+		 */
+		const_iterator
+		select(usize index) const
+		{
+			return const_iterator(_get_nth(_root, index));
+		}
+
+		/**
+		 * @param[in]  data  The data to rank
+		 *
+		 * @return     The count of values in the tree which are less than the data, it's the index of
+		 *             the data in the sorted order if it exists in the tree
+		 */
+		usize
+		rank(const Data_Type& data) const
+		{
+			usize result = 0;
+			Node_Type* it = _root;
+			while (it != nullptr)
+			{
+				if (_less_than(data, it->data))
+				{
+					it = it->left;
+				}
+				else
+				{
+					if (!_less_than(it->data, data))
+						return result + _get_subtree_size(it->left);
+					result += _get_subtree_size(it->left) + 1;
+					it = it->right;
+				}
+			}
+			return result;
+		}
+
+		/**
+		 * @param[in]  data  The data to look-up
+		 *
+		 * @return     Range viewing the values which are not less than the data till the end of the tree
+		 */
+		Range_Type
+		lower_bound(const Data_Type& data)
+		{
+			usize index = 0;
+			Node_Type* start = _lower_bound(data, index);
+			return Range_Type(start, _count - index);
+		}
+
+		/**
+		 * @param[in]  data  The data to look-up
+		 *
+		 * @return     Const range viewing the values which are not less than the data till the end of the tree
+		 */
+		Const_Range_Type
+		lower_bound(const Data_Type& data) const
+		{
+			usize index = 0;
+			Node_Type* start = _lower_bound(data, index);
+			return Const_Range_Type(start, _count - index);
+		}
+
+		/**
+		 * @param[in]  data  The data to look-up
+		 *
+		 * @return     Range viewing the values which are greater than the data till the end of the tree
+		 */
+		Range_Type
+		upper_bound(const Data_Type& data)
+		{
+			usize index = 0;
+			Node_Type* start = _upper_bound(data, index);
+			return Range_Type(start, _count - index);
+		}
+
+		/**
+		 * @param[in]  data  The data to look-up
+		 *
+		 * @return     Const range viewing the values which are greater than the data till the end of the tree
+		 */
+		Const_Range_Type
+		upper_bound(const Data_Type& data) const
+		{
+			usize index = 0;
+			Node_Type* start = _upper_bound(data, index);
+			return Const_Range_Type(start, _count - index);
+		}
+
+		/**
+		 * @param[in]  data  The data to look-up
+		 *
+		 * @return     Range viewing the values which are equal to the data, it's empty if the data doesn't exist
+		 *             and its start is the position the data would be inserted at
+		 */
+		Range_Type
+		equal_range(const Data_Type& data)
+		{
+			usize index = 0;
+			Node_Type* start = _lower_bound(data, index);
+			if (start != nullptr && !_less_than(data, start->data))
+				return Range_Type(start, 1, _get_successor(start));
+			return Range_Type(start, 0, start);
+		}
+
+		/**
+		 * @param[in]  data  The data to look-up
+		 *
+		 * @return     Const range viewing the values which are equal to the data, it's empty if the data doesn't exist
+		 *             and its start is the position the data would be inserted at
+		 */
+		Const_Range_Type
+		equal_range(const Data_Type& data) const
+		{
+			usize index = 0;
+			Node_Type* start = _lower_bound(data, index);
+			if (start != nullptr && !_less_than(data, start->data))
+				return Const_Range_Type(start, 1, _get_successor(start));
+			return Const_Range_Type(start, 0, start);
+		}
+
+		/**
+		 * @param[in]  data  The data to look-up
+		 *
+		 * @return     An iterator to the greatest value which is not greater than the data or to
+		 *             the end of the tree if all the values are greater
+		 */
+		iterator
+		floor(const Data_Type& data)
+		{
+			return iterator(_floor(data));
+		}
+
+		/**
+		 * @param[in]  data  The data to look-up
+		 *
+		 * @return     A const iterator to the greatest value which is not greater than the data or to
+		 *             the end of the tree if all the values are greater
+		 */
+		const_iterator
+		floor(const Data_Type& data) const
+		{
+			return const_iterator(_floor(data));
+		}
+
+		/**
+		 * @param[in]  data  The data to look-up
+		 *
+		 * @return     An iterator to the least value which is not less than the data or to
+		 *             the end of the tree if all the values are less
+		 */
+		iterator
+		ceil(const Data_Type& data)
+		{
+			usize index = 0;
+			return iterator(_lower_bound(data, index));
+		}
+
+		/**
+		 * @param[in]  data  The data to look-up
+		 *
+		 * @return     A const iterator to the least value which is not less than the data or to
+		 *             the end of the tree if all the values are less
+		 */
+		const_iterator
+		ceil(const Data_Type& data) const
+		{
+			usize index = 0;
+			return const_iterator(_lower_bound(data, index));
+		}
+
+		/**
+		 * @brief      Builds the tree from sorted values in linear time, the old values of the tree are removed
+		 *             All the nodes are allocated in a single block and linked into a balanced tree
+		 *             If a value is repeated its first occurrence is kept
+		 *
+		 * @param[in]  range   The range of the sorted values
+		 *
+		 * @tparam     TRange  Type of the range, it should be a forward range with a count
+		 */
+		template<typename TRange>
+		void
+		build_from_sorted(const TRange& range)
+		{
+			_build_from_sorted(range.begin(), range.count(), [](Data_Type* data, const Data_Type& value)
+			{
+				::new (data) Data_Type(value);
+			});
+		}
+
+		/**
+		 * @brief      Moves all the values of the other tree into this tree in linear time and leaves
+		 *             the other tree empty, the nodes of both trees are relinked in order as a balanced tree
+		 *             If a value exists in both trees the value of this tree is kept
+		 *             If the trees use different allocators the values of the other tree are moved into new nodes
+		 *
+		 * @param      other  The other tree to merge into this tree
+		 */
+		void
+		merge(Red_Black_Tree& other)
+		{
+			if (this == &other || other.empty())
+				return;
+
+			//the unique nodes are gathered from the front and the repeated nodes of the other tree from the back
+			Owner<Node_Type*> nodes = _allocator->template alloc<Node_Type*>(_count + other._count);
+			bool adopt = _allocator == other._allocator;
+			usize unique_count = 0;
+			usize repeated_count = 0;
+			Node_Type* a = _min();
+			Node_Type* b = other._min();
+			while (a != nullptr || b != nullptr)
+			{
+				if (b == nullptr || (a != nullptr && !_less_than(b->data, a->data)))
+				{
+					if (b != nullptr && !_less_than(a->data, b->data))
+					{
+						if (adopt)
+							nodes[nodes.count() - ++repeated_count] = b;
+						b = _get_successor(b);
+					}
+					nodes[unique_count++] = a;
+					a = _get_successor(a);
+				}
+				else
+				{
+					nodes[unique_count++] = adopt ? b : _create_node(std::move(b->data));
+					b = _get_successor(b);
+				}
+			}
+
+			if (adopt)
+			{
+				for (usize i = 0; i < other._blocks.count(); ++i)
+					_blocks.insert_back(std::move(other._blocks[i]));
+				other._blocks.reset();
+				other._root = nullptr;
+				other._count = 0;
+
+				//the repeated nodes are freed after the traversal because it walks through their parents
+				for (usize i = 0; i < repeated_count; ++i)
+					_free_mem(nodes[nodes.count() - 1 - i]);
+			}
+			else
+			{
+				other.clear();
+			}
+
+			_count = unique_count;
+			_root = _link_balanced(nodes.ptr, unique_count, 0, _balanced_red_depth(unique_count));
+			_root->parent = nullptr;
+			_allocator->free(nodes);
+		}
+
 		/**
 		 * @return     The count of values in the tree
 		 */
@@ -701,10 +988,7 @@ namespace cppr
 		Range_Type
 		range(usize start, usize end)
 		{
-			auto it = min();
-			for(usize i = 0; i < start; ++i)
-				++it;
-			return Range_Type(it.node, end - start);
+			return Range_Type(_get_nth(_root, start), end - start, _get_nth(_root, end));
 		}
 
 		/**
@@ -716,10 +1000,35 @@ namespace cppr
 		Const_Range_Type
 		range(usize start, usize end) const
 		{
-			auto it = min();
-			for(usize i = 0; i < start; ++i)
-				++it;
-			return Const_Range_Type(it.node, end - start);
+			return Const_Range_Type(_get_nth(_root, start), end - start, _get_nth(_root, end));
+		}
+
+		/**
+		 * @param[in]  start   The start iterator of the range
+		 * @param[in]  end_it  The end iterator of the range
+		 *
+		 * @return     Range viewing the specified values between the iterators [start, end)
+		 */
+		Range_Type
+		range(iterator start, iterator end_it)
+		{
+			return Range_Type(const_cast<Node_Type*>(start.node),
+							  _get_iterator_index(end_it) - _get_iterator_index(start),
+							  const_cast<Node_Type*>(end_it.node));
+		}
+
+		/**
+		 * @param[in]  start   The start iterator of the range
+		 * @param[in]  end_it  The end iterator of the range
+		 *
+		 * @return     Const range viewing the specified values between the iterators [start, end)
+		 */
+		Const_Range_Type
+		range(const_iterator start, const_iterator end_it) const
+		{
+			return Const_Range_Type(start.node,
+									_get_iterator_index(end_it) - _get_iterator_index(start),
+									end_it.node);
 		}
 
 		//iterator interface
@@ -842,6 +1151,7 @@ namespace cppr
 				else
 					y->right = z;
 			}
+			_update_sizes(y, 1);
 			_insert_fixup(z);
 			return z;
 		}
@@ -876,6 +1186,7 @@ namespace cppr
 				else
 					y->right = z;
 			}
+			_update_sizes(y, 1);
 			_insert_fixup(z);
 			return z;
 		}
@@ -1057,6 +1368,9 @@ namespace cppr
 				x->parent->right = y;
 			y->left = x;
 			x->parent = y;
+
+			y->size = x->size;
+			x->size = _get_subtree_size(x->left) + _get_subtree_size(x->right) + 1;
 		}
 
 		void
@@ -1075,6 +1389,109 @@ namespace cppr
 				x->parent->left = y;
 			y->right = x;
 			x->parent = y;
+
+			y->size = x->size;
+			x->size = _get_subtree_size(x->left) + _get_subtree_size(x->right) + 1;
+		}
+
+		//adds the delta to the subtree size of the node and all of its ancestors
+		void
+		_update_sizes(Node_Type* it, isize delta)
+		{
+			for(; it != nullptr; it = it->parent)
+				it->size += delta;
+		}
+
+		bool
+		_is_block_node(const Node_Type* it) const
+		{
+			for (usize i = 0; i < _blocks.count(); ++i)
+				if (it >= _blocks[i].ptr && it < _blocks[i].ptr + _blocks[i].count())
+					return true;
+			return false;
+		}
+
+		void
+		_free_blocks()
+		{
+			for (usize i = 0; i < _blocks.count(); ++i)
+				_allocator->free(_blocks[i]);
+			_blocks.reset();
+		}
+
+		//constructs the data of the nodes in the block from the sorted values, the repeated values are skipped
+		template<typename TInputIterator, typename TConstruct>
+		void
+		_build_from_sorted(TInputIterator it, usize count, TConstruct&& construct)
+		{
+			clear();
+			if (count == 0)
+				return;
+
+			_blocks.insert_back(_allocator->template alloc<Node_Type>(count));
+			Node_Type* nodes = _blocks[0].ptr;
+			usize unique_count = 0;
+			for (usize i = 0; i < count; ++i, ++it)
+			{
+				construct(&nodes[unique_count].data, *it);
+				if (unique_count > 0 && !_less_than(nodes[unique_count - 1].data, nodes[unique_count].data))
+				{
+					if (_less_than(nodes[unique_count].data, nodes[unique_count - 1].data))
+						panic("build_from_sorted input is not sorted");
+					nodes[unique_count].data.~Data_Type();
+					continue;
+				}
+				++unique_count;
+			}
+
+			_count = unique_count;
+			_root = _link_balanced(nodes, unique_count, 0, _balanced_red_depth(unique_count));
+			_root->parent = nullptr;
+		}
+
+		//the depth of the last level in a balanced tree of this many nodes
+		//it's the only level which can be partially filled so its nodes are the red ones
+		static usize
+		_balanced_red_depth(usize count)
+		{
+			usize result = 0;
+			while ((usize(2) << result) <= count)
+				++result;
+			return result;
+		}
+
+		static Node_Type*
+		_node_at(Node_Type* nodes, usize index)
+		{
+			return nodes + index;
+		}
+
+		static Node_Type*
+		_node_at(Node_Type** nodes, usize index)
+		{
+			return nodes[index];
+		}
+
+		//links the nodes which are already in order into a balanced tree bottom up
+		//the nodes are either an array of nodes or an array of pointers to them
+		template<typename TNodes>
+		static Node_Type*
+		_link_balanced(TNodes nodes, usize count, usize depth, usize red_depth)
+		{
+			if (count == 0)
+				return nullptr;
+
+			usize mid = count / 2;
+			Node_Type* node = _node_at(nodes, mid);
+			node->left = _link_balanced(nodes, mid, depth + 1, red_depth);
+			node->right = _link_balanced(nodes + mid + 1, count - mid - 1, depth + 1, red_depth);
+			if (node->left != nullptr)
+				node->left->parent = node;
+			if (node->right != nullptr)
+				node->right->parent = node;
+			node->size = count;
+			node->color = (depth == red_depth && depth > 0) ? Color_Type::RED : Color_Type::BLACK;
+			return node;
 		}
 
 		Node_Type*
@@ -1099,7 +1516,9 @@ namespace cppr
 			if (it == nullptr) return;
 
 			it->data.~Data_Type();
-			_allocator->free(own(it));
+			//the block nodes are freed all at once with the block
+			if (!_is_block_node(it))
+				_allocator->free(own(it));
 			--_count;
 		}
 
@@ -1109,7 +1528,9 @@ namespace cppr
 			if (it == nullptr) return;
 
 			it->data.~Data_Type();
-			_allocator->free(own(it));
+			//the block nodes are freed all at once with the block
+			if (!_is_block_node(it))
+				_allocator->free(own(it));
 			--_count;
 		}
 
@@ -1136,6 +1557,8 @@ namespace cppr
 
 			if (left_count == -1 || right_count == -1 || right_count != left_count)
 				return -1;
+			else if (it->size != _get_subtree_size(it->left) + _get_subtree_size(it->right) + 1)
+				return -1;
 			else
 				return (it->color == Color_Type::RED) ? left_count : left_count + 1;
 		}
@@ -1258,6 +1681,83 @@ namespace cppr
 		{
 			return _lookup(key, it);
 		}
+
+		//the first node which is not less than the key, index is set to the count of the values less than the key
+		Node_Type*
+		_lower_bound(const Data_Type& key, usize& index) const
+		{
+			Node_Type* result = nullptr;
+			Node_Type* it = _root;
+			index = 0;
+			while (it != nullptr)
+			{
+				if (_less_than(it->data, key))
+				{
+					index += _get_subtree_size(it->left) + 1;
+					it = it->right;
+				}
+				else
+				{
+					result = it;
+					it = it->left;
+				}
+			}
+			return result;
+		}
+
+		//the first node which is greater than the key, index is set to the count of the values not greater than the key
+		Node_Type*
+		_upper_bound(const Data_Type& key, usize& index) const
+		{
+			Node_Type* result = nullptr;
+			Node_Type* it = _root;
+			index = 0;
+			while (it != nullptr)
+			{
+				if (_less_than(key, it->data))
+				{
+					result = it;
+					it = it->left;
+				}
+				else
+				{
+					index += _get_subtree_size(it->left) + 1;
+					it = it->right;
+				}
+			}
+			return result;
+		}
+
+		//the last node which is not greater than the key
+		Node_Type*
+		_floor(const Data_Type& key) const
+		{
+			Node_Type* result = nullptr;
+			Node_Type* it = _root;
+			while (it != nullptr)
+			{
+				if (_less_than(key, it->data))
+				{
+					it = it->left;
+				}
+				else
+				{
+					result = it;
+					it = it->right;
+				}
+			}
+			return result;
+		}
+
+		//the in-order index of the iterator, the end of the tree is at the count of the values
+		template<typename TIteratorType>
+		usize
+		_get_iterator_index(const TIteratorType& it) const
+		{
+			if (it.node == nullptr)
+				return _count;
+			return _get_index(it.node);
+		}
 	};
 
 	/**
@@ -1290,6 +1790,8 @@ namespace cppr
 						Red_Black_Tree_Iterator<internal::Red_Black_Tree_Node<Pair_Node<const TKey, TValue>>>,
 						Red_Black_Tree_Iterator<const internal::Red_Black_Tree_Node<Pair_Node<const TKey, TValue>>>,
 						Pair_Node<TKey, TValue>>;
+		using Range_Type = typename _impl::Range_Type;
+		using Const_Range_Type = typename _impl::Const_Range_Type;
 
 		/**
 		 * @brief      Constructs a map
@@ -1569,6 +2071,162 @@ namespace cppr
 
 		using _impl::lookup;
 
+		/**
+		 * @brief      Builds the map from pairs sorted by key in linear time, the old pairs of the map are removed
+		 *             If a key is repeated its first pair is kept
+		 *
+		 * @param[in]  range   The range of the sorted pairs, the pairs should have key and value members
+		 *
+		 * @tparam     TRange  Type of the range, it should be a forward range with a count
+		 */
+		template<typename TRange>
+		void
+		build_from_sorted(const TRange& range)
+		{
+			_impl::_build_from_sorted(range.begin(), range.count(), [](Data_Type* data, const auto& pair)
+			{
+				::new (data) Data_Type(pair.key, pair.value);
+			});
+		}
+
+		/**
+		 * @param[in]  key   The key to rank
+		 *
+		 * @return     The count of keys in the map which are less than the key, it's the index of
+		 *             the key in the sorted order if it exists in the map
+		 */
+		usize
+		rank(const Key_Type& key) const
+		{
+			return _impl::rank(Data_Type(key));
+		}
+
+		using _impl::rank;
+
+		/**
+		 * @param[in]  key   The key to look-up
+		 *
+		 * @return     Range viewing the pairs whose keys are not less than the key till the end of the map
+		 */
+		Range_Type
+		lower_bound(const Key_Type& key)
+		{
+			return _impl::lower_bound(Data_Type(key));
+		}
+
+		/**
+		 * @param[in]  key   The key to look-up
+		 *
+		 * @return     Const range viewing the pairs whose keys are not less than the key till the end of the map
+		 */
+		Const_Range_Type
+		lower_bound(const Key_Type& key) const
+		{
+			return _impl::lower_bound(Data_Type(key));
+		}
+
+		using _impl::lower_bound;
+
+		/**
+		 * @param[in]  key   The key to look-up
+		 *
+		 * @return     Range viewing the pairs whose keys are greater than the key till the end of the map
+		 */
+		Range_Type
+		upper_bound(const Key_Type& key)
+		{
+			return _impl::upper_bound(Data_Type(key));
+		}
+
+		/**
+		 * @param[in]  key   The key to look-up
+		 *
+		 * @return     Const range viewing the pairs whose keys are greater than the key till the end of the map
+		 */
+		Const_Range_Type
+		upper_bound(const Key_Type& key) const
+		{
+			return _impl::upper_bound(Data_Type(key));
+		}
+
+		using _impl::upper_bound;
+
+		/**
+		 * @param[in]  key   The key to look-up
+		 *
+		 * @return     Range viewing the pair of the key, it's empty if the key doesn't exist
+		 */
+		Range_Type
+		equal_range(const Key_Type& key)
+		{
+			return _impl::equal_range(Data_Type(key));
+		}
+
+		/**
+		 * @param[in]  key   The key to look-up
+		 *
+		 * @return     Const range viewing the pair of the key, it's empty if the key doesn't exist
+		 */
+		Const_Range_Type
+		equal_range(const Key_Type& key) const
+		{
+			return _impl::equal_range(Data_Type(key));
+		}
+
+		using _impl::equal_range;
+
+		/**
+		 * @param[in]  key   The key to look-up
+		 *
+		 * @return     An iterator to the pair with the greatest key which is not greater than the key or to
+		 *             the end of the map if all the keys are greater
+		 */
+		iterator
+		floor(const Key_Type& key)
+		{
+			return _impl::floor(Data_Type(key));
+		}
+
+		/**
+		 * @param[in]  key   The key to look-up
+		 *
+		 * @return     A const iterator to the pair with the greatest key which is not greater than the key or to
+		 *             the end of the map if all the keys are greater
+		 */
+		const_iterator
+		floor(const Key_Type& key) const
+		{
+			return _impl::floor(Data_Type(key));
+		}
+
+		using _impl::floor;
+
+		/**
+		 * @param[in]  key   The key to look-up
+		 *
+		 * @return     An iterator to the pair with the least key which is not less than the key or to
+		 *             the end of the map if all the keys are less
+		 */
+		iterator
+		ceil(const Key_Type& key)
+		{
+			return _impl::ceil(Data_Type(key));
+		}
+
+		/**
+		 * @param[in]  key   The key to look-up
+		 *
+		 * @return     A const iterator to the pair with the least key which is not less than the key or to
+		 *             the end of the map if all the keys are less
+		 */
+		const_iterator
+		ceil(const Key_Type& key) const
+		{
+			return _impl::ceil(Data_Type(key));
+		}
+
+		using _impl::ceil;
+
 		/**
 		 * @return     An Iterator to the beginning of this container
 		 */
@@ -35,3 +35,15 @@ typedef intptr_t isize;
 #ifdef USE_CPPR_NAMESPACE
 }
 #endif
+
+//forces inlining even in debug builds
+#if defined(_MSC_VER)
+#define CPPR_FORCE_INLINE __forceinline
+#else
+#define CPPR_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+//SIMD support
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CPPR_SSE2 1
+#endif
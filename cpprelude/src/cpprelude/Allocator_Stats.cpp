@@ -0,0 +1,110 @@
+#include "cpprelude/Allocator_Stats.h"
+
+namespace cppr
+{
+	inline static usize
+	_log2(usize value)
+	{
+		usize result = 0;
+		while(value >>= 1)
+			++result;
+		return result;
+	}
+
+	Allocator_Stats::Allocator_Stats(bool track)
+		:track_call_sites(track)
+	{
+		reset();
+	}
+
+	void
+	Allocator_Stats::record_alloc(usize size, void* call_site)
+	{
+		alloc_count.fetch_add(1, std::memory_order_relaxed);
+		histogram[_log2(size)].fetch_add(1, std::memory_order_relaxed);
+
+		usize live = live_size.fetch_add(size, std::memory_order_relaxed) + size;
+		usize peak = peak_size.load(std::memory_order_relaxed);
+		while(live > peak && !peak_size.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+
+		if(!track_call_sites.load(std::memory_order_relaxed) || call_site == nullptr)
+			return;
+
+		//lock free open addressing table, slots are claimed once and never released until reset
+		usize index = ((usize)call_site >> 2) % CALL_SITES_CAPACITY;
+		for(usize i = 0; i < CALL_SITES_CAPACITY; ++i)
+		{
+			auto& entry = _call_sites[index];
+			void* address = entry.address.load(std::memory_order_relaxed);
+			if(address == nullptr &&
+			   entry.address.compare_exchange_strong(address, call_site, std::memory_order_relaxed))
+			{
+				address = call_site;
+			}
+
+			if(address == call_site)
+			{
+				entry.size.fetch_add(size, std::memory_order_relaxed);
+				entry.count.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			index = (index + 1) % CALL_SITES_CAPACITY;
+		}
+	}
+
+	void
+	Allocator_Stats::record_free(usize size)
+	{
+		free_count.fetch_add(1, std::memory_order_relaxed);
+		live_size.fetch_sub(size, std::memory_order_relaxed);
+	}
+
+	void
+	Allocator_Stats::reset()
+	{
+		live_size = 0;
+		peak_size = 0;
+		alloc_count = 0;
+		free_count = 0;
+		for(auto& bucket: histogram)
+			bucket = 0;
+		for(auto& entry: _call_sites)
+		{
+			entry.address = nullptr;
+			entry.size = 0;
+			entry.count = 0;
+		}
+	}
+
+	usize
+	Allocator_Stats::top_call_sites(Slice<Call_Site> result) const
+	{
+		usize result_count = 0;
+		usize capacity = result.count();
+		if(capacity == 0)
+			return 0;
+
+		//insertion into a sorted fixed size list
+		for(const auto& entry: _call_sites)
+		{
+			Call_Site site{ entry.address.load(std::memory_order_relaxed),
+							entry.size.load(std::memory_order_relaxed),
+							entry.count.load(std::memory_order_relaxed) };
+			if(site.address == nullptr)
+				continue;
+
+			if(result_count == capacity && result[capacity - 1].size >= site.size)
+				continue;
+
+			usize index = result_count < capacity ? result_count++ : capacity - 1;
+			while(index > 0 && result[index - 1].size < site.size)
+			{
+				result[index] = result[index - 1];
+				--index;
+			}
+			result[index] = site;
+		}
+		return result_count;
+	}
+}
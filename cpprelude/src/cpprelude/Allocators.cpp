@@ -1,20 +1,28 @@
 #include "cpprelude/Allocators.h"
 #include <new>
+#include <cstring>
+#include <cstddef>
+
+#if defined(OS_WINDOWS)
+#include <intrin.h>
+#endif
 
 namespace cppr
 {
 	Owner<byte>
-	_stack_allocator_alloc(void* _self, usize size)
+	_stack_allocator_alloc(void* _self, usize size, usize alignment)
 	{
 		Stack_Allocator* self = (Stack_Allocator*)_self;
 
+		//each block is preceded by the head it was allocated from so that free can give back the alignment padding
 		byte* last_ptr = self->_memory.ptr + self->_memory.size;
-		usize remaining_size = last_ptr - self->_alloc_head;
-		if(remaining_size < size)
+		byte* aligned_head = (byte*)internal::align_up((usize)(self->_alloc_head + sizeof(byte*)), alignment);
+		if(aligned_head > last_ptr || usize(last_ptr - aligned_head) < size)
 			return Owner<byte>();
 
-		auto result = Owner<byte>(self->_alloc_head, size);
-		self->_alloc_head += size;
+		std::memcpy(aligned_head - sizeof(byte*), &self->_alloc_head, sizeof(byte*));
+		auto result = Owner<byte>(aligned_head, size);
+		self->_alloc_head = aligned_head + size;
 		return result;
 	}
 
@@ -23,8 +31,8 @@ namespace cppr
 	{
 		Stack_Allocator* self = (Stack_Allocator*) _self;
 
-		if(self->_alloc_head == data.ptr + data.size)
-			self->_alloc_head = data.ptr;
+		if(data.ptr != nullptr && self->_alloc_head == data.ptr + data.size)
+			std::memcpy(&self->_alloc_head, data.ptr - sizeof(byte*), sizeof(byte*));
 	}
 
 	Stack_Allocator::Stack_Allocator(Allocator_Trait* context)
@@ -104,6 +112,19 @@ namespace cppr
 		_alloc_head = _memory.ptr;
 	}
 
+	Stack_Allocator::Marker
+	Stack_Allocator::marker() const
+	{
+		return Marker{ _alloc_head };
+	}
+
+	void
+	Stack_Allocator::rollback(const Marker& value)
+	{
+		if(value.alloc_head >= _memory.ptr && value.alloc_head <= _alloc_head)
+			_alloc_head = value.alloc_head;
+	}
+
 	usize
 	Stack_Allocator::used_memory_size() const
 	{
@@ -117,14 +138,16 @@ namespace cppr
 	}
 
 	Owner<byte>
-	_arena_allocator_alloc(void* _self, usize size)
+	_arena_allocator_alloc(void* _self, usize size, usize alignment)
 	{
 		Arena_Allocator* self = (Arena_Allocator*) _self;
 
-		self->grow(size);
-		auto result = own((byte*)self->_head->alloc_head, size);
-		self->_head->alloc_head += size;
-		self->used_size += size;
+		//worst case padding is alignment - 1 bytes
+		self->grow(size + alignment - 1);
+		byte* aligned_head = (byte*)internal::align_up((usize)self->_head->alloc_head, alignment);
+		auto result = own(aligned_head, size);
+		self->used_size += (aligned_head + size) - self->_head->alloc_head;
+		self->_head->alloc_head = aligned_head + size;
 		return result;
 	}
 
@@ -208,7 +231,7 @@ namespace cppr
 			usize request_size = grow_size > block_size ? grow_size : block_size;
 			request_size += node_size;
 
-			internal::Arena_Node* new_node = (internal::Arena_Node*)_allocator->template alloc<byte>(request_size).ptr;
+			internal::Arena_Node* new_node = (internal::Arena_Node*)_allocator->template alloc<byte>(request_size, alignof(internal::Arena_Node)).ptr;
 			arena_size += request_size - node_size;
 
 			::new (new_node) internal::Arena_Node(own(((byte*) new_node) + node_size, request_size - node_size));
@@ -227,6 +250,37 @@ namespace cppr
 			_head = next;
 		}
 		arena_size = 0;
+		used_size = 0;
+	}
+
+	Arena_Allocator::Marker
+	Arena_Allocator::marker() const
+	{
+		if(_head == nullptr)
+			return Marker{ nullptr, nullptr, used_size };
+		return Marker{ _head, _head->alloc_head, used_size };
+	}
+
+	void
+	Arena_Allocator::rollback(const Marker& value)
+	{
+		//free the blocks the arena has grown since the marker
+		while(_head != nullptr && _head != value.node)
+		{
+			auto next = _head->next_node;
+			arena_size -= _head->header.size;
+			_allocator->template free<byte>(own((byte*)_head, _head->header.size + sizeof(internal::Arena_Node)));
+			_head = next;
+		}
+
+		if(_head == nullptr)
+		{
+			used_size = 0;
+			return;
+		}
+
+		_head->alloc_head = value.alloc_head;
+		used_size = value.used_size;
 	}
 
 	usize
@@ -240,4 +294,948 @@ namespace cppr
 	{
 		return arena_size - used_size;
 	}
+
+	//Concurrent arena allocator
+	constexpr usize CONCURRENT_ARENA_NODE_SIZE =
+		(sizeof(internal::Concurrent_Arena_Node) + Concurrent_Arena_Allocator::ALIGN_SIZE - 1) &
+		~(Concurrent_Arena_Allocator::ALIGN_SIZE - 1);
+
+	inline static internal::Concurrent_Arena_Node*
+	_concurrent_arena_node_new(Allocator_Trait* context, usize size)
+	{
+		auto memory = context->template alloc<byte>(CONCURRENT_ARENA_NODE_SIZE + size, Concurrent_Arena_Allocator::ALIGN_SIZE);
+		if(memory.ptr == nullptr)
+			return nullptr;
+
+		auto node = (internal::Concurrent_Arena_Node*)memory.ptr;
+		::new (node) internal::Concurrent_Arena_Node();
+		node->memory = own(memory.ptr + CONCURRENT_ARENA_NODE_SIZE, size);
+		node->cursor.store(0, std::memory_order_relaxed);
+		node->next_node = nullptr;
+		return node;
+	}
+
+	inline static void
+	_concurrent_arena_node_free(Allocator_Trait* context, internal::Concurrent_Arena_Node* node)
+	{
+		context->template free<byte>(own((byte*)node, CONCURRENT_ARENA_NODE_SIZE + node->memory.size));
+	}
+
+	Owner<byte>
+	_concurrent_arena_allocator_alloc(void* _self, usize size, usize alignment)
+	{
+		Concurrent_Arena_Allocator* self = (Concurrent_Arena_Allocator*) _self;
+
+		//the cursor stays ALIGN_SIZE aligned so only bigger alignments need padding
+		usize request = internal::align_up(size, Concurrent_Arena_Allocator::ALIGN_SIZE);
+		if(alignment > Concurrent_Arena_Allocator::ALIGN_SIZE)
+			request += alignment - Concurrent_Arena_Allocator::ALIGN_SIZE;
+
+		internal::Concurrent_Arena_Node* node = self->_head.load(std::memory_order_acquire);
+		internal::Concurrent_Arena_Node* new_node = nullptr;
+		while(true)
+		{
+			if(node)
+			{
+				//a failed fetch-add leaves the cursor past the end so the block stays full
+				usize offset = node->cursor.fetch_add(request, std::memory_order_relaxed);
+				if(offset + request <= node->memory.size)
+				{
+					//another thread installed a block before us so ours isn't needed
+					if(new_node)
+						_concurrent_arena_node_free(self->_allocator, new_node);
+
+					byte* ptr = (byte*)internal::align_up((usize)(node->memory.ptr + offset), alignment);
+					return own(ptr, size);
+				}
+			}
+
+			if(new_node == nullptr)
+			{
+				new_node = _concurrent_arena_node_new(self->_allocator,
+					request > self->block_size ? request : self->block_size);
+				if(new_node == nullptr)
+					return Owner<byte>();
+			}
+
+			//claim the first allocation of the new block before publishing it
+			new_node->cursor.store(request, std::memory_order_relaxed);
+			new_node->next_node = node;
+			if(self->_head.compare_exchange_weak(node, new_node,
+												 std::memory_order_acq_rel,
+												 std::memory_order_acquire))
+			{
+				byte* ptr = (byte*)internal::align_up((usize)new_node->memory.ptr, alignment);
+				return own(ptr, size);
+			}
+		}
+	}
+
+	void
+	_concurrent_arena_allocator_free(void*, const Owner<byte>&)
+	{
+		//do nothing
+	}
+
+	Concurrent_Arena_Allocator::Concurrent_Arena_Allocator(Allocator_Trait* context)
+		:_allocator(context),
+		 _head(nullptr),
+		 block_size(KILOBYTES(64))
+	{
+		_allocator_trait._self = this;
+		_allocator_trait._alloc = _concurrent_arena_allocator_alloc;
+		_allocator_trait._free = _concurrent_arena_allocator_free;
+	}
+
+	Concurrent_Arena_Allocator::Concurrent_Arena_Allocator(usize mem_block_size, Allocator_Trait* context)
+		:_allocator(context),
+		 _head(nullptr),
+		 block_size(mem_block_size)
+	{
+		_allocator_trait._self = this;
+		_allocator_trait._alloc = _concurrent_arena_allocator_alloc;
+		_allocator_trait._free = _concurrent_arena_allocator_free;
+	}
+
+	Concurrent_Arena_Allocator::Concurrent_Arena_Allocator(Concurrent_Arena_Allocator&& other)
+		:_allocator_trait(std::move(other._allocator_trait)),
+		 _allocator(std::move(other._allocator)),
+		 _head(other._head.load()),
+		 block_size(other.block_size)
+	{
+		_allocator_trait._self = this;
+
+		other._head = nullptr;
+	}
+
+	Concurrent_Arena_Allocator&
+	Concurrent_Arena_Allocator::operator=(Concurrent_Arena_Allocator&& other)
+	{
+		reset();
+
+		_allocator_trait = std::move(other._allocator_trait);
+		_allocator = std::move(other._allocator);
+		_head = other._head.load();
+		block_size = other.block_size;
+
+		_allocator_trait._self = this;
+
+		other._head = nullptr;
+		return *this;
+	}
+
+	Concurrent_Arena_Allocator::~Concurrent_Arena_Allocator()
+	{
+		reset();
+	}
+
+	void
+	Concurrent_Arena_Allocator::reset()
+	{
+		auto it = _head.exchange(nullptr);
+		while(it != nullptr)
+		{
+			auto next = it->next_node;
+			_concurrent_arena_node_free(_allocator, it);
+			it = next;
+		}
+	}
+
+	void
+	Concurrent_Arena_Allocator::free_all()
+	{
+		auto head = _head.load();
+		if(head == nullptr)
+			return;
+
+		auto it = head->next_node;
+		while(it != nullptr)
+		{
+			auto next = it->next_node;
+			_concurrent_arena_node_free(_allocator, it);
+			it = next;
+		}
+
+		head->next_node = nullptr;
+		head->cursor = 0;
+	}
+
+	//the sizes are derived from the blocks cursors when they're read instead of being counted
+	//on every allocation which would add a second shared atomic to the allocation path
+	//a published block's next node never changes so the list can be walked while other threads allocate
+	inline static usize
+	_concurrent_arena_block_used_size(const internal::Concurrent_Arena_Node* node)
+	{
+		//a failed fetch-add leaves the cursor past the end of the block
+		usize cursor = node->cursor.load(std::memory_order_relaxed);
+		return cursor < node->memory.size ? cursor : node->memory.size;
+	}
+
+	usize
+	Concurrent_Arena_Allocator::used_memory_size() const
+	{
+		usize result = 0;
+		for(auto it = _head.load(std::memory_order_acquire); it != nullptr; it = it->next_node)
+			result += _concurrent_arena_block_used_size(it);
+		return result;
+	}
+
+	usize
+	Concurrent_Arena_Allocator::unused_memory_size() const
+	{
+		usize result = 0;
+		for(auto it = _head.load(std::memory_order_acquire); it != nullptr; it = it->next_node)
+			result += it->memory.size - _concurrent_arena_block_used_size(it);
+		return result;
+	}
+
+	Owner<byte>
+	_virtual_arena_allocator_alloc(void* _self, usize size, usize alignment)
+	{
+		Virtual_Arena_Allocator* self = (Virtual_Arena_Allocator*) _self;
+
+		byte* aligned_head = (byte*)internal::align_up((usize)self->_alloc_head, alignment);
+		usize needed_size = (aligned_head + size) - self->_alloc_head;
+		if(!self->grow(needed_size))
+			return Owner<byte>();
+
+		self->_alloc_head = aligned_head + size;
+		return own(aligned_head, size);
+	}
+
+	void
+	_virtual_arena_allocator_free(void* _self, const Owner<byte>& data)
+	{
+		Virtual_Arena_Allocator* self = (Virtual_Arena_Allocator*) _self;
+
+		//we can only reclaim the last allocation
+		if(self->_alloc_head == data.ptr + data.size)
+			self->_alloc_head = data.ptr;
+	}
+
+	//a huge page only backs an extent which is fully read-write when it's first touched
+	//so with huge pages the arena commits and decommits whole huge pages
+	inline static usize
+	_virtual_arena_page_size(VIRTUAL_FLAGS flags)
+	{
+		if(flags & VIRTUAL_FLAGS::HUGE_PAGES)
+			return os->virtual_huge_page_size();
+		return os->virtual_page_size();
+	}
+
+	Virtual_Arena_Allocator::Virtual_Arena_Allocator(usize reserve_size,
+													 usize mem_commit_size,
+													 usize mem_high_water_mark,
+													 VIRTUAL_FLAGS mem_flags)
+		:commit_size(mem_commit_size),
+		 high_water_mark(mem_high_water_mark),
+		 flags(mem_flags)
+	{
+		usize page_size = _virtual_arena_page_size(flags);
+		_memory = os->virtual_reserve(nullptr, internal::align_up(reserve_size, page_size), flags);
+		_alloc_head = _memory.ptr;
+		_commit_head = _memory.ptr;
+
+		_allocator_trait._self = this;
+		_allocator_trait._alloc = _virtual_arena_allocator_alloc;
+		_allocator_trait._free = _virtual_arena_allocator_free;
+	}
+
+	Virtual_Arena_Allocator::Virtual_Arena_Allocator(Virtual_Arena_Allocator&& other)
+		:_allocator_trait(std::move(other._allocator_trait)),
+		 _memory(std::move(other._memory)),
+		 _alloc_head(other._alloc_head),
+		 _commit_head(other._commit_head),
+		 commit_size(other.commit_size),
+		 high_water_mark(other.high_water_mark),
+		 flags(other.flags)
+	{
+		_allocator_trait._self = this;
+
+		other._alloc_head = nullptr;
+		other._commit_head = nullptr;
+	}
+
+	Virtual_Arena_Allocator&
+	Virtual_Arena_Allocator::operator=(Virtual_Arena_Allocator&& other)
+	{
+		if(_memory)
+			os->virtual_free(_memory);
+
+		_allocator_trait = std::move(other._allocator_trait);
+		_memory = std::move(other._memory);
+		_alloc_head = other._alloc_head;
+		_commit_head = other._commit_head;
+		commit_size = other.commit_size;
+		high_water_mark = other.high_water_mark;
+		flags = other.flags;
+
+		_allocator_trait._self = this;
+
+		other._alloc_head = nullptr;
+		other._commit_head = nullptr;
+		return *this;
+	}
+
+	Virtual_Arena_Allocator::~Virtual_Arena_Allocator()
+	{
+		if(_memory)
+			os->virtual_free(_memory);
+	}
+
+	bool
+	Virtual_Arena_Allocator::grow(usize grow_size)
+	{
+		usize available_size = _commit_head - _alloc_head;
+		if(available_size >= grow_size)
+			return true;
+
+		usize reserved_left = (_memory.ptr + _memory.size) - _commit_head;
+		usize request_size = grow_size - available_size;
+		if(request_size < commit_size)
+			request_size = commit_size;
+		request_size = internal::align_up(request_size, _virtual_arena_page_size(flags));
+		if(request_size > reserved_left)
+			request_size = reserved_left;
+
+		if(request_size < grow_size - available_size)
+			return false;
+
+		if(!os->virtual_commit(make_slice(_commit_head, request_size)))
+			return false;
+
+		if(flags & VIRTUAL_FLAGS::POPULATE)
+			os->virtual_populate(make_slice(_commit_head, request_size));
+
+		_commit_head += request_size;
+		return true;
+	}
+
+	void
+	Virtual_Arena_Allocator::reset()
+	{
+		_alloc_head = _memory.ptr;
+
+		byte* mark = _memory.ptr + internal::align_up(high_water_mark, _virtual_arena_page_size(flags));
+		if(_commit_head > mark)
+		{
+			os->virtual_decommit(make_slice(mark, _commit_head - mark));
+			_commit_head = mark;
+		}
+	}
+
+	Virtual_Arena_Allocator::Marker
+	Virtual_Arena_Allocator::marker() const
+	{
+		return Marker{ _alloc_head };
+	}
+
+	void
+	Virtual_Arena_Allocator::rollback(const Marker& value)
+	{
+		if(value.alloc_head >= _memory.ptr && value.alloc_head <= _alloc_head)
+			_alloc_head = value.alloc_head;
+	}
+
+	usize
+	Virtual_Arena_Allocator::used_memory_size() const
+	{
+		return _alloc_head - _memory.ptr;
+	}
+
+	usize
+	Virtual_Arena_Allocator::unused_memory_size() const
+	{
+		return _commit_head - _alloc_head;
+	}
+
+	usize
+	Virtual_Arena_Allocator::committed_memory_size() const
+	{
+		return _commit_head - _memory.ptr;
+	}
+
+	usize
+	Virtual_Arena_Allocator::reserved_memory_size() const
+	{
+		return _memory.size;
+	}
+
+	//TLSF allocator
+	using internal::TLSF_Block;
+
+	//the free list links overlap with the payload so the header is only the first 2 fields
+	constexpr usize TLSF_BLOCK_OVERHEAD = offsetof(TLSF_Block, next_free);
+	constexpr usize TLSF_BLOCK_SIZE_MIN = sizeof(TLSF_Block) - TLSF_BLOCK_OVERHEAD;
+	constexpr usize TLSF_BLOCK_SIZE_MAX = usize(1) << TLSF_Allocator::FL_INDEX_MAX;
+	constexpr usize TLSF_BLOCK_FREE_BIT = 1 << 0;
+	constexpr usize TLSF_BLOCK_PREV_FREE_BIT = 1 << 1;
+
+	static_assert(TLSF_BLOCK_OVERHEAD == TLSF_Allocator::ALIGN_SIZE,
+		"tlsf block header should keep the payload aligned");
+	static_assert(TLSF_Allocator::FL_INDEX_COUNT <= 32 && TLSF_Allocator::SL_INDEX_COUNT <= 32,
+		"tlsf bitmaps are 32 bits");
+
+	//index of the least significant set bit
+	inline static usize
+	_tlsf_ffs(u32 value)
+	{
+		#if defined(OS_WINDOWS)
+			unsigned long index;
+			_BitScanForward(&index, value);
+			return index;
+		#elif defined(OS_LINUX)
+			return __builtin_ctz(value);
+		#endif
+	}
+
+	//index of the most significant set bit
+	inline static usize
+	_tlsf_fls(usize value)
+	{
+		#if defined(OS_WINDOWS) && defined(_WIN64)
+			unsigned long index;
+			_BitScanReverse64(&index, value);
+			return index;
+		#elif defined(OS_WINDOWS)
+			unsigned long index;
+			_BitScanReverse(&index, value);
+			return index;
+		#elif defined(OS_LINUX)
+			return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(value);
+		#endif
+	}
+
+	inline static usize
+	_tlsf_block_size(const TLSF_Block* block)
+	{
+		return block->size & ~(TLSF_BLOCK_FREE_BIT | TLSF_BLOCK_PREV_FREE_BIT);
+	}
+
+	inline static void
+	_tlsf_block_set_size(TLSF_Block* block, usize size)
+	{
+		block->size = size | (block->size & (TLSF_BLOCK_FREE_BIT | TLSF_BLOCK_PREV_FREE_BIT));
+	}
+
+	inline static bool
+	_tlsf_block_is_free(const TLSF_Block* block)
+	{
+		return (block->size & TLSF_BLOCK_FREE_BIT) != 0;
+	}
+
+	inline static bool
+	_tlsf_block_is_prev_free(const TLSF_Block* block)
+	{
+		return (block->size & TLSF_BLOCK_PREV_FREE_BIT) != 0;
+	}
+
+	inline static byte*
+	_tlsf_block_payload(const TLSF_Block* block)
+	{
+		return (byte*)block + TLSF_BLOCK_OVERHEAD;
+	}
+
+	inline static TLSF_Block*
+	_tlsf_block_from_payload(const byte* ptr)
+	{
+		return (TLSF_Block*)(ptr - TLSF_BLOCK_OVERHEAD);
+	}
+
+	inline static TLSF_Block*
+	_tlsf_block_next(const TLSF_Block* block)
+	{
+		return (TLSF_Block*)(_tlsf_block_payload(block) + _tlsf_block_size(block));
+	}
+
+	inline static TLSF_Block*
+	_tlsf_block_link_next(TLSF_Block* block)
+	{
+		TLSF_Block* next = _tlsf_block_next(block);
+		next->prev_physical = block;
+		return next;
+	}
+
+	inline static void
+	_tlsf_block_mark_as_free(TLSF_Block* block)
+	{
+		TLSF_Block* next = _tlsf_block_link_next(block);
+		next->size |= TLSF_BLOCK_PREV_FREE_BIT;
+		block->size |= TLSF_BLOCK_FREE_BIT;
+	}
+
+	inline static void
+	_tlsf_block_mark_as_used(TLSF_Block* block)
+	{
+		TLSF_Block* next = _tlsf_block_next(block);
+		next->size &= ~TLSF_BLOCK_PREV_FREE_BIT;
+		block->size &= ~TLSF_BLOCK_FREE_BIT;
+	}
+
+	//maps a block size to its first and second level indices
+	inline static void
+	_tlsf_mapping_insert(usize size, usize& fl, usize& sl)
+	{
+		if(size < TLSF_Allocator::SMALL_BLOCK_SIZE)
+		{
+			fl = 0;
+			sl = size / (TLSF_Allocator::SMALL_BLOCK_SIZE / TLSF_Allocator::SL_INDEX_COUNT);
+		}
+		else
+		{
+			fl = _tlsf_fls(size);
+			sl = (size >> (fl - TLSF_Allocator::SL_INDEX_COUNT_LOG2)) ^ (usize(1) << TLSF_Allocator::SL_INDEX_COUNT_LOG2);
+			fl -= (TLSF_Allocator::FL_INDEX_SHIFT - 1);
+		}
+	}
+
+	//rounds the size up to the next size class so that any block in that class fits the request
+	inline static void
+	_tlsf_mapping_search(usize size, usize& fl, usize& sl)
+	{
+		if(size >= TLSF_Allocator::SMALL_BLOCK_SIZE)
+			size += (usize(1) << (_tlsf_fls(size) - TLSF_Allocator::SL_INDEX_COUNT_LOG2)) - 1;
+		_tlsf_mapping_insert(size, fl, sl);
+	}
+
+	static TLSF_Block*
+	_tlsf_search_suitable_block(TLSF_Allocator* self, usize& fl, usize& sl)
+	{
+		if(fl >= TLSF_Allocator::FL_INDEX_COUNT)
+			return nullptr;
+
+		u32 sl_map = self->_sl_bitmap[fl] & (~u32(0) << sl);
+		if(sl_map == 0)
+		{
+			u32 fl_map = fl + 1 < 32 ? self->_fl_bitmap & (~u32(0) << (fl + 1)) : 0;
+			if(fl_map == 0)
+				return nullptr;
+
+			fl = _tlsf_ffs(fl_map);
+			sl_map = self->_sl_bitmap[fl];
+		}
+		sl = _tlsf_ffs(sl_map);
+		return self->_blocks[fl][sl];
+	}
+
+	static void
+	_tlsf_remove_free_block(TLSF_Allocator* self, TLSF_Block* block, usize fl, usize sl)
+	{
+		TLSF_Block* prev = block->prev_free;
+		TLSF_Block* next = block->next_free;
+		if(next) next->prev_free = prev;
+		if(prev) prev->next_free = next;
+
+		if(self->_blocks[fl][sl] == block)
+		{
+			self->_blocks[fl][sl] = next;
+			if(next == nullptr)
+			{
+				self->_sl_bitmap[fl] &= ~(u32(1) << sl);
+				if(self->_sl_bitmap[fl] == 0)
+					self->_fl_bitmap &= ~(u32(1) << fl);
+			}
+		}
+		self->_free_size -= _tlsf_block_size(block);
+	}
+
+	static void
+	_tlsf_insert_free_block(TLSF_Allocator* self, TLSF_Block* block, usize fl, usize sl)
+	{
+		TLSF_Block* current = self->_blocks[fl][sl];
+		block->next_free = current;
+		block->prev_free = nullptr;
+		if(current) current->prev_free = block;
+
+		self->_blocks[fl][sl] = block;
+		self->_fl_bitmap |= u32(1) << fl;
+		self->_sl_bitmap[fl] |= u32(1) << sl;
+		self->_free_size += _tlsf_block_size(block);
+	}
+
+	inline static void
+	_tlsf_block_remove(TLSF_Allocator* self, TLSF_Block* block)
+	{
+		usize fl, sl;
+		_tlsf_mapping_insert(_tlsf_block_size(block), fl, sl);
+		_tlsf_remove_free_block(self, block, fl, sl);
+	}
+
+	inline static void
+	_tlsf_block_insert(TLSF_Allocator* self, TLSF_Block* block)
+	{
+		usize fl, sl;
+		_tlsf_mapping_insert(_tlsf_block_size(block), fl, sl);
+		_tlsf_insert_free_block(self, block, fl, sl);
+	}
+
+	//splits the block into a block of the given size and a free remaining block
+	static TLSF_Block*
+	_tlsf_block_split(TLSF_Block* block, usize size)
+	{
+		TLSF_Block* remaining = (TLSF_Block*)(_tlsf_block_payload(block) + size);
+		usize remaining_size = _tlsf_block_size(block) - (size + TLSF_BLOCK_OVERHEAD);
+
+		remaining->size = remaining_size;
+		_tlsf_block_set_size(block, size);
+		_tlsf_block_link_next(block);
+		_tlsf_block_mark_as_free(remaining);
+		return remaining;
+	}
+
+	inline static TLSF_Block*
+	_tlsf_block_absorb(TLSF_Block* prev, TLSF_Block* block)
+	{
+		prev->size += _tlsf_block_size(block) + TLSF_BLOCK_OVERHEAD;
+		_tlsf_block_link_next(prev);
+		return prev;
+	}
+
+	inline static TLSF_Block*
+	_tlsf_block_merge_prev(TLSF_Allocator* self, TLSF_Block* block)
+	{
+		if(_tlsf_block_is_prev_free(block))
+		{
+			TLSF_Block* prev = block->prev_physical;
+			_tlsf_block_remove(self, prev);
+			block = _tlsf_block_absorb(prev, block);
+		}
+		return block;
+	}
+
+	inline static TLSF_Block*
+	_tlsf_block_merge_next(TLSF_Allocator* self, TLSF_Block* block)
+	{
+		TLSF_Block* next = _tlsf_block_next(block);
+		if(_tlsf_block_is_free(next))
+		{
+			_tlsf_block_remove(self, next);
+			block = _tlsf_block_absorb(block, next);
+		}
+		return block;
+	}
+
+	//returns the trailing part of the block back to the free lists if it's big enough
+	inline static void
+	_tlsf_block_trim_free(TLSF_Allocator* self, TLSF_Block* block, usize size)
+	{
+		if(_tlsf_block_size(block) >= sizeof(TLSF_Block) + size)
+		{
+			TLSF_Block* remaining = _tlsf_block_split(block, size);
+			_tlsf_block_insert(self, remaining);
+		}
+	}
+
+	//returns the leading gap of the block back to the free lists and returns the aligned block
+	inline static TLSF_Block*
+	_tlsf_block_trim_free_leading(TLSF_Allocator* self, TLSF_Block* block, usize gap)
+	{
+		TLSF_Block* remaining = _tlsf_block_split(block, gap - TLSF_BLOCK_OVERHEAD);
+		remaining->size |= TLSF_BLOCK_PREV_FREE_BIT;
+		block->size |= TLSF_BLOCK_FREE_BIT;
+		_tlsf_block_insert(self, block);
+		return remaining;
+	}
+
+	static void
+	_tlsf_init_pool(TLSF_Allocator* self)
+	{
+		self->_fl_bitmap = 0;
+		::memset(self->_sl_bitmap, 0, sizeof(self->_sl_bitmap));
+		::memset(self->_blocks, 0, sizeof(self->_blocks));
+		self->_used_size = 0;
+		self->_free_size = 0;
+
+		if(self->_memory.ptr == nullptr)
+			return;
+
+		//the pool holds one free block followed by a zero sized used sentinel block
+		byte* pool_begin = (byte*)internal::align_up((usize)self->_memory.ptr, TLSF_Allocator::ALIGN_SIZE);
+		byte* pool_end = self->_memory.ptr + self->_memory.size;
+		if(pool_end < pool_begin + sizeof(TLSF_Block) + TLSF_BLOCK_OVERHEAD)
+			return;
+
+		usize pool_size = (pool_end - pool_begin) - 2 * TLSF_BLOCK_OVERHEAD;
+		pool_size &= ~(TLSF_Allocator::ALIGN_SIZE - 1);
+		if(pool_size >= TLSF_BLOCK_SIZE_MAX)
+			pool_size = TLSF_BLOCK_SIZE_MAX - TLSF_Allocator::ALIGN_SIZE;
+
+		TLSF_Block* block = (TLSF_Block*)pool_begin;
+		block->prev_physical = nullptr;
+		block->size = pool_size | TLSF_BLOCK_FREE_BIT;
+		_tlsf_block_insert(self, block);
+
+		TLSF_Block* sentinel = _tlsf_block_link_next(block);
+		sentinel->size = TLSF_BLOCK_PREV_FREE_BIT;
+	}
+
+	Owner<byte>
+	_tlsf_allocator_alloc(void* _self, usize size, usize alignment)
+	{
+		TLSF_Allocator* self = (TLSF_Allocator*) _self;
+
+		if(size == 0 || size >= TLSF_BLOCK_SIZE_MAX)
+			return Owner<byte>();
+
+		usize adjusted_size = internal::align_up(size, TLSF_Allocator::ALIGN_SIZE);
+		if(adjusted_size < TLSF_BLOCK_SIZE_MIN)
+			adjusted_size = TLSF_BLOCK_SIZE_MIN;
+
+		//over-aligned requests need room to split off a leading free block
+		constexpr usize GAP_MIN = sizeof(TLSF_Block);
+		usize search_size = adjusted_size;
+		if(alignment > TLSF_Allocator::ALIGN_SIZE)
+			search_size += alignment + GAP_MIN;
+
+		usize fl, sl;
+		_tlsf_mapping_search(search_size, fl, sl);
+		TLSF_Block* block = _tlsf_search_suitable_block(self, fl, sl);
+		if(block == nullptr)
+			return Owner<byte>();
+		_tlsf_remove_free_block(self, block, fl, sl);
+
+		if(alignment > TLSF_Allocator::ALIGN_SIZE)
+		{
+			byte* ptr = _tlsf_block_payload(block);
+			byte* aligned_ptr = (byte*)internal::align_up((usize)ptr, alignment);
+			usize gap = aligned_ptr - ptr;
+			if(gap != 0 && gap < GAP_MIN)
+			{
+				usize offset = GAP_MIN - gap > alignment ? GAP_MIN - gap : alignment;
+				aligned_ptr = (byte*)internal::align_up((usize)(ptr + offset), alignment);
+				gap = aligned_ptr - ptr;
+			}
+
+			if(gap != 0)
+				block = _tlsf_block_trim_free_leading(self, block, gap);
+		}
+
+		_tlsf_block_trim_free(self, block, adjusted_size);
+		_tlsf_block_mark_as_used(block);
+		self->_used_size += _tlsf_block_size(block);
+		return own(_tlsf_block_payload(block), size);
+	}
+
+	void
+	_tlsf_allocator_free(void* _self, const Owner<byte>& data)
+	{
+		TLSF_Allocator* self = (TLSF_Allocator*) _self;
+
+		if(data.ptr == nullptr)
+			return;
+
+		TLSF_Block* block = _tlsf_block_from_payload(data.ptr);
+		self->_used_size -= _tlsf_block_size(block);
+		_tlsf_block_mark_as_free(block);
+		block = _tlsf_block_merge_prev(self, block);
+		block = _tlsf_block_merge_next(self, block);
+		_tlsf_block_insert(self, block);
+	}
+
+	TLSF_Allocator::TLSF_Allocator(Allocator_Trait* context)
+		:_allocator(context)
+	{
+		_tlsf_init_pool(this);
+
+		_allocator_trait._self = this;
+		_allocator_trait._alloc = _tlsf_allocator_alloc;
+		_allocator_trait._free = _tlsf_allocator_free;
+	}
+
+	TLSF_Allocator::TLSF_Allocator(usize pool_size, Allocator_Trait* context)
+		:_allocator(context)
+	{
+		_memory = _allocator->template alloc<byte>(pool_size, ALIGN_SIZE);
+		_tlsf_init_pool(this);
+
+		_allocator_trait._self = this;
+		_allocator_trait._alloc = _tlsf_allocator_alloc;
+		_allocator_trait._free = _tlsf_allocator_free;
+	}
+
+	TLSF_Allocator::TLSF_Allocator(Owner<byte>&& memory, Allocator_Trait* context)
+		:_allocator(context),
+		 _memory(std::move(memory))
+	{
+		_tlsf_init_pool(this);
+
+		_allocator_trait._self = this;
+		_allocator_trait._alloc = _tlsf_allocator_alloc;
+		_allocator_trait._free = _tlsf_allocator_free;
+	}
+
+	TLSF_Allocator::TLSF_Allocator(TLSF_Allocator&& other)
+		:_allocator_trait(std::move(other._allocator_trait)),
+		 _allocator(std::move(other._allocator)),
+		 _memory(std::move(other._memory)),
+		 _fl_bitmap(other._fl_bitmap),
+		 _used_size(other._used_size),
+		 _free_size(other._free_size)
+	{
+		::memcpy(_sl_bitmap, other._sl_bitmap, sizeof(_sl_bitmap));
+		::memcpy(_blocks, other._blocks, sizeof(_blocks));
+		_allocator_trait._self = this;
+
+		_tlsf_init_pool(&other);
+	}
+
+	TLSF_Allocator&
+	TLSF_Allocator::operator=(TLSF_Allocator&& other)
+	{
+		reset();
+
+		_allocator_trait = std::move(other._allocator_trait);
+		_allocator = std::move(other._allocator);
+		_memory = std::move(other._memory);
+		_fl_bitmap = other._fl_bitmap;
+		::memcpy(_sl_bitmap, other._sl_bitmap, sizeof(_sl_bitmap));
+		::memcpy(_blocks, other._blocks, sizeof(_blocks));
+		_used_size = other._used_size;
+		_free_size = other._free_size;
+
+		_allocator_trait._self = this;
+
+		_tlsf_init_pool(&other);
+		return *this;
+	}
+
+	TLSF_Allocator::~TLSF_Allocator()
+	{
+		reset();
+	}
+
+	void
+	TLSF_Allocator::init(usize pool_size)
+	{
+		reset();
+
+		_memory = _allocator->template alloc<byte>(pool_size, ALIGN_SIZE);
+		_tlsf_init_pool(this);
+	}
+
+	void
+	TLSF_Allocator::init(Owner<byte>&& memory)
+	{
+		reset();
+
+		_memory = std::move(memory);
+		_tlsf_init_pool(this);
+	}
+
+	void
+	TLSF_Allocator::reset()
+	{
+		if(_memory)
+			_allocator->template free<byte>(_memory);
+		_tlsf_init_pool(this);
+	}
+
+	void
+	TLSF_Allocator::free_all()
+	{
+		_tlsf_init_pool(this);
+	}
+
+	usize
+	TLSF_Allocator::used_memory_size() const
+	{
+		return _used_size;
+	}
+
+	usize
+	TLSF_Allocator::unused_memory_size() const
+	{
+		return _free_size;
+	}
+
+	usize
+	TLSF_Allocator::largest_free_block_size() const
+	{
+		if(_fl_bitmap == 0)
+			return 0;
+
+		//the largest blocks live in the highest non empty size class
+		usize fl = _tlsf_fls(_fl_bitmap);
+		usize sl = _tlsf_fls(_sl_bitmap[fl]);
+		usize result = 0;
+		for(TLSF_Block* it = _blocks[fl][sl]; it != nullptr; it = it->next_free)
+		{
+			usize size = _tlsf_block_size(it);
+			if(size > result)
+				result = size;
+		}
+		return result;
+	}
+
+	r64
+	TLSF_Allocator::fragmentation() const
+	{
+		if(_free_size == 0)
+			return 0;
+		return 1.0 - r64(largest_free_block_size()) / r64(_free_size);
+	}
+
+	Owner<byte>
+	_instrumented_allocator_alloc(void* _self, usize size, usize alignment)
+	{
+		Instrumented_Allocator* self = (Instrumented_Allocator*) _self;
+
+		auto result = self->_allocator->_alloc(self->_allocator->_self, size, alignment);
+		if(result)
+			self->stats.record_alloc(size, CPPR_RETURN_ADDRESS());
+		return result;
+	}
+
+	void
+	_instrumented_allocator_free(void* _self, const Owner<byte>& data)
+	{
+		Instrumented_Allocator* self = (Instrumented_Allocator*) _self;
+
+		if(data)
+			self->stats.record_free(data.size);
+		self->_allocator->_free(self->_allocator->_self, data);
+	}
+
+	Instrumented_Allocator::Instrumented_Allocator(Allocator_Trait* context)
+		:_allocator(context),
+		 stats(true)
+	{
+		_allocator_trait._self = this;
+		_allocator_trait._alloc = _instrumented_allocator_alloc;
+		_allocator_trait._free = _instrumented_allocator_free;
+	}
+
+	usize
+	print_str(IO_Trait* trait, const Print_Format&, const Allocator_Stats& stats)
+	{
+		constexpr usize TOP_CALL_SITES_COUNT = 10;
+
+		usize result = vprints(trait, "live size: ", stats.live_size.load(),
+								", peak size: ", stats.peak_size.load(),
+								", allocations count: ", stats.alloc_count.load(),
+								", frees count: ", stats.free_count.load(), "\n");
+
+		result += vprints(trait, "size histogram:\n");
+		for(usize i = 0; i < Allocator_Stats::HISTOGRAM_SIZE; ++i)
+		{
+			usize count = stats.histogram[i].load();
+			if(count == 0)
+				continue;
+			result += vprints(trait, "  [", usize(1) << i, ", ", (usize(1) << i) * 2, "): ", count, "\n");
+		}
+
+		Call_Site sites[TOP_CALL_SITES_COUNT];
+		usize sites_count = stats.top_call_sites(make_slice(sites, TOP_CALL_SITES_COUNT));
+		if(sites_count > 0)
+		{
+			result += vprints(trait, "top call sites:\n");
+			for(usize i = 0; i < sites_count; ++i)
+			{
+				result += vprints(trait, "  ", sites[i].size, " bytes in ", sites[i].count, " allocations from ");
+				result += os->print_symbol(trait, sites[i].address);
+				result += vprints(trait, "\n");
+			}
+		}
+		return result;
+	}
 }
\ No newline at end of file
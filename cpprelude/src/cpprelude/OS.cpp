@@ -4,6 +4,7 @@
 #include "cpprelude/Dynamic_Array.h"
 #include "sewing-fcontext/fcontext.h"
 #include <mutex>
+#include <atomic>
 #include <stdlib.h>
 
 #if defined(OS_WINDOWS)
@@ -12,6 +13,7 @@
 #include <Windows.h>
 #include <Psapi.h>
 #include <DbgHelp.h>
+#include <malloc.h>
 #undef min
 #undef max
 #elif defined(OS_LINUX)
@@ -34,28 +36,202 @@ static_assert(sizeof(intptr_t) == sizeof(void*),
 
 namespace cppr
 {
+	//the alignment malloc guarantees without asking for it
+	constexpr usize MALLOC_ALIGNMENT = alignof(max_align_t);
+
+	inline static void*
+	_os_aligned_alloc(usize size, usize alignment)
+	{
+		#if defined(OS_WINDOWS)
+		{
+			return ::_aligned_malloc(size, alignment);
+		}
+		#elif defined(OS_LINUX)
+		{
+			if(alignment <= MALLOC_ALIGNMENT)
+				return ::malloc(size);
+
+			void* result = nullptr;
+			if(posix_memalign(&result, alignment, size) != 0)
+				return nullptr;
+			return result;
+		}
+		#endif
+	}
+
+	inline static void
+	_os_aligned_free(void* ptr)
+	{
+		#if defined(OS_WINDOWS)
+		{
+			::_aligned_free(ptr);
+		}
+		#elif defined(OS_LINUX)
+		{
+			::free(ptr);
+		}
+		#endif
+	}
+
+	static Allocator_Stats _global_memory_stats;
+
 	Owner<byte>
-	_malloc(void* _self, usize size)
+	_malloc(void* _self, usize size, usize alignment)
 	{
-		return Owner<byte>((byte*)::malloc(size), size);
+		auto result = Owner<byte>((byte*)_os_aligned_alloc(size, alignment), size);
+		OS* self = (OS*)_self;
+		if(result && self->track_global_memory_stats.load(std::memory_order_relaxed))
+			_global_memory_stats.record_alloc(size, CPPR_RETURN_ADDRESS());
+		return result;
 	}
 
 	void
 	_free(void* _self, const Owner<byte>& value)
 	{
-		::free(value.ptr);
+		OS* self = (OS*)_self;
+		if(value && self->track_global_memory_stats.load(std::memory_order_relaxed))
+			_global_memory_stats.record_free(value.size);
+		_os_aligned_free(value.ptr);
 	}
 	
+	//the leak detector tracks blocks in independently locked lists to reduce the contention
+	constexpr usize LEAK_SHARDS_COUNT = 16;
+	constexpr usize LEAK_CALLSTACK_MAX = 32;
+
 	struct Memory_Block
 	{
 		usize size = 0;
-		Memory_Stream call_stack;
+		//the start of the underlying allocation, the block header lies right before the user memory
+		void* base = nullptr;
+		u32 call_stack_count = 0;
+		u32 shard = 0;
 		Memory_Block *next = nullptr, *prev = nullptr;
+		#if defined(DEBUG)
+		//raw return addresses of the sampled call stack, symbolized only when the leak report is printed
+		void* call_stack[LEAK_CALLSTACK_MAX];
+		#endif
+	};
+
+	struct alignas(64) Leak_Shard
+	{
+		std::mutex mtx;
+		Memory_Block* head = nullptr;
 	};
 
-	static Allocator_Trait 	_mallocator { nullptr, _malloc, _free };
-	static Memory_Block* 	_leak_head = nullptr;
-	static std::mutex		_leak_mtx;
+	static Leak_Shard			_leak_shards[LEAK_SHARDS_COUNT];
+	static std::atomic<usize>	_leak_next_shard(0);
+	static thread_local usize	_leak_sampling_counter = 0;
+
+	inline static usize
+	_capture_callstack(void** callstack, usize frames_max)
+	{
+		#if defined(OS_WINDOWS)
+			return CaptureStackBackTrace(0, frames_max, callstack, NULL);
+		#elif defined(OS_LINUX)
+			return backtrace(callstack, frames_max);
+		#endif
+	}
+
+	static usize
+	_print_symbol(IO_Trait* io, void* address)
+	{
+		#if defined(OS_WINDOWS)
+		{
+			#if defined(DEBUG)
+			{
+				constexpr usize MAX_NAME_LEN = 1024;
+				auto process_handle = GetCurrentProcess();
+
+				//allocaet a buffer for the symbol info
+				//windows lays the symbol info in memory in this form
+				//[struct][name buffer]
+				//and the name buffer size is the same as the MaxNameLen set below
+				byte buffer[sizeof(SYMBOL_INFO) + MAX_NAME_LEN];
+
+				SYMBOL_INFO* symbol = reinterpret_cast<SYMBOL_INFO*>(buffer);
+				memset(symbol, 0, sizeof(SYMBOL_INFO));
+
+				symbol->MaxNameLen = MAX_NAME_LEN;
+				symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+
+				if(SymFromAddr(process_handle, (DWORD64)(address), NULL, symbol))
+					return vprints(io, symbol->Name);
+				else
+					return vprints(io, "unknown symbol");
+			}
+			#else
+			{
+				return vprints(io, address);
+			}
+			#endif
+		}
+		#elif defined(OS_LINUX)
+		{
+			constexpr usize MAX_NAME_LEN = 1024;
+			//+1 for null terminated string
+			char name_buffer[MAX_NAME_LEN+1];
+			char demangled_buffer[MAX_NAME_LEN+1];
+			usize demangled_buffer_length = MAX_NAME_LEN;
+
+			//resolve the symbol
+			char** symbols = backtrace_symbols(&address, 1);
+			if(symbols == nullptr)
+				return vprints(io, address);
+
+			//isolate the function name
+			char *name_begin = nullptr, *name_end = nullptr, *name_it = symbols[0];
+			while(*name_it != 0)
+			{
+				if(*name_it == '(')
+					name_begin = name_it+1;
+				else if(*name_it == ')' || *name_it == '+')
+				{
+					name_end = name_it;
+					break;
+				}
+				++name_it;
+			}
+
+			usize result = 0;
+			usize mangled_name_size = name_end - name_begin;
+			//function maybe inlined
+			if(mangled_name_size == 0)
+			{
+				result = vprints(io, "unknown/inlined symbol");
+			}
+			else
+			{
+				//copy the function name into the name buffer
+				usize copy_size = mangled_name_size > MAX_NAME_LEN ? MAX_NAME_LEN : mangled_name_size;
+				memcpy(name_buffer, name_begin, copy_size);
+				name_buffer[copy_size] = 0;
+
+				int status = 0;
+				abi::__cxa_demangle(name_buffer, demangled_buffer, &demangled_buffer_length, &status);
+				demangled_buffer[MAX_NAME_LEN] = 0;
+				if(status == 0)
+					result = vprints(io, demangled_buffer);
+				else
+					result = vprints(io, name_buffer);
+			}
+			::free(symbols);
+			return result;
+		}
+		#endif
+	}
+
+#if defined(DEBUG)
+	static void
+	_print_callstack(IO_Trait* io, void** callstack, usize frames_count)
+	{
+		for(usize i = 0; i < frames_count; ++i)
+		{
+			vprints(io, "[", frames_count - i - 1, "]: ");
+			_print_symbol(io, callstack[i]);
+			vprints(io, "\n");
+		}
+	}
+#endif
 
 	OS::~OS()
 	{
@@ -75,25 +251,36 @@ namespace cppr
 	void
 	OS::print_leak_report(IO_Trait* io) const
 	{
-		if(_leak_head)
+		if(io == nullptr) io = unbuf_stderr;
+		usize count = 0;
+		usize size = 0;
+		for(auto& shard: _leak_shards)
 		{
-			if(io == nullptr) io = unbuf_stderr;
-			usize count = 0;
-			usize size = 0;
-			auto it = _leak_head;
+			std::lock_guard<std::mutex> lock(shard.mtx);
+			auto it = shard.head;
 			while(it)
 			{
 				vprints(io, "Leak size: ", it->size, ", call stack:\n");
-				if(it->call_stack.empty())
+				#if defined(DEBUG)
+				{
+					if(it->call_stack_count == 0)
+						vprints(io, "call stack wasn't sampled, set leak_sampling_rate to 1 to get call stack info\n");
+					else
+						_print_callstack(io, it->call_stack, it->call_stack_count);
+				}
+				#else
+				{
 					vprints(io, "run in debug mode to get call stack info\n");
-				else
-					vprints(io, it->call_stack.str_content(), "\n");
+				}
+				#endif
+				vprints(io, "\n");
 				count++;
 				size += it->size;
 				it = it->next;
 			}
-			vprints(io, "Leaks count: ", count, ", Leaks size(bytes): ", size, "\n");
 		}
+		if(count > 0)
+			vprints(io, "Leaks count: ", count, ", Leaks size(bytes): ", size, "\n");
 	}
 
 	void
@@ -102,97 +289,124 @@ namespace cppr
 		#ifdef DEBUG
 		{
 			if(io == nullptr) io = unbuf_stderr;
-			constexpr usize MAX_NAME_LEN = 1024;
 			constexpr usize STACK_MAX = 4096;
 			void* callstack[STACK_MAX];
 
-			#if defined(OS_WINDOWS)
-			{
-				auto process_handle = GetCurrentProcess();
+			usize frames_count = _capture_callstack(callstack, STACK_MAX);
+			_print_callstack(io, callstack, frames_count);
+		}
+		#endif
+	}
 
-				//allocaet a buffer for the symbol info
-				//windows lays the symbol info in memory in this form
-				//[struct][name buffer]
-				//and the name buffer size is the same as the MaxNameLen set below
-				byte buffer[sizeof(SYMBOL_INFO) + MAX_NAME_LEN];
+	void
+	OS::reset_leak_sampling() const
+	{
+		_leak_sampling_counter = 0;
+	}
 
-				SYMBOL_INFO* symbol = reinterpret_cast<SYMBOL_INFO*>(buffer);
-				memset(symbol, 0, sizeof(SYMBOL_INFO));
+	usize
+	OS::print_symbol(IO_Trait* io, void* address) const
+	{
+		return _print_symbol(io, address);
+	}
 
-				symbol->MaxNameLen = MAX_NAME_LEN;
-				symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+	#if defined(OS_LINUX)
+	//maps an anonymous region which starts at the given alignment by over-mapping then trimming the edges
+	static void*
+	_mmap_aligned(usize size, usize alignment, int prot, int flags)
+	{
+		byte* ptr = (byte*)mmap(nullptr, size + alignment, prot, flags, -1, 0);
+		if(ptr == MAP_FAILED)
+			return nullptr;
 
-				usize frames_count = CaptureStackBackTrace(0, STACK_MAX, callstack, NULL);
-				for(usize i = 0; i < frames_count; ++i)
-				{
-					if(SymFromAddr(process_handle, (DWORD64)(callstack[i]), NULL, symbol))
-						vprints(io, "[", frames_count - i - 1, "]: ", symbol->Name, "\n");
-					else
-						vprints(io, "[", frames_count - i - 1, "]: unknown symbol", "\n");
-				}
-			}
-			#elif defined(OS_LINUX)
+		byte* aligned_ptr = (byte*)internal::align_up((usize)ptr, alignment);
+		usize head_size = aligned_ptr - ptr;
+		usize tail_size = alignment - head_size;
+		if(head_size > 0)
+			munmap(ptr, head_size);
+		if(tail_size > 0)
+			munmap(aligned_ptr + size, tail_size);
+		return aligned_ptr;
+	}
+	#endif
+
+	Owner<byte>
+	OS::virtual_alloc(void* address_hint, usize size, VIRTUAL_FLAGS flags)
+	{
+		if(size == 0)
+			return Owner<byte>();
+
+		void* result = nullptr;
+
+		#if defined(OS_WINDOWS)
+		{
+			if(flags & VIRTUAL_FLAGS::HUGE_PAGES)
 			{
-				//+1 for null terminated string
-				char name_buffer[MAX_NAME_LEN+1];
-				char demangled_buffer[MAX_NAME_LEN+1];
-				usize demangled_buffer_length = MAX_NAME_LEN;
+				//large pages need the SeLockMemoryPrivilege so we fallback to normal pages on failure
+				usize huge_size = internal::align_up(size, virtual_huge_page_size());
+				result = VirtualAlloc(address_hint, huge_size, MEM_RESERVE|MEM_COMMIT|MEM_LARGE_PAGES, PAGE_READWRITE);
+				if(result)
+					size = huge_size;
+			}
 
-				//capture the call stack
-				usize frames_count = backtrace(callstack, STACK_MAX);
-				//resolve the symbols
-				char** symbols = backtrace_symbols(callstack, frames_count);
+			if(result == nullptr)
+				result = VirtualAlloc(address_hint, size, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
+
+			if(result && (flags & VIRTUAL_FLAGS::POPULATE))
+				virtual_populate(make_slice((byte*)result, size));
+		}
+		#elif defined(OS_LINUX)
+		{
+			int mmap_flags = MAP_PRIVATE|MAP_ANONYMOUS;
+			if(flags & VIRTUAL_FLAGS::POPULATE)
+				mmap_flags |= MAP_POPULATE;
 
-				if(symbols)
+			if(flags & VIRTUAL_FLAGS::HUGE_PAGES)
+			{
+				//explicit huge pages only work if the admin reserved some, otherwise we use transparent huge pages
+				usize huge_size = internal::align_up(size, virtual_huge_page_size());
+				result = mmap(address_hint, huge_size, PROT_READ|PROT_WRITE, mmap_flags|MAP_HUGETLB, -1, 0);
+				if(result != MAP_FAILED)
+				{
+					size = huge_size;
+				}
+				else
 				{
-					for(usize i = 0; i < frames_count; ++i)
+					result = _mmap_aligned(size, virtual_huge_page_size(), PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS);
+					if(result)
 					{
-						//isolate the function name
-						char *name_begin = nullptr, *name_end = nullptr, *name_it = symbols[i];
-						while(*name_it != 0)
-						{
-							if(*name_it == '(')
-								name_begin = name_it+1;
-							else if(*name_it == ')' || *name_it == '+')
-							{
-								name_end = name_it;
-								break;
-							}
-							++name_it;
-						}
-
-						
-						usize mangled_name_size = name_end - name_begin;
-						//function maybe inlined
-						if(mangled_name_size == 0)
-						{
-							vprints(io, "[", frames_count - i - 1, "]: unknown/inlined symbol\n");
-							continue;
-						}
-
-						//copy the function name into the name buffer
-						usize copy_size = mangled_name_size > MAX_NAME_LEN ? MAX_NAME_LEN : mangled_name_size;
-						memcpy(name_buffer, name_begin, copy_size);
-						name_buffer[copy_size] = 0;
-
-						int status = 0;
-						abi::__cxa_demangle(name_buffer, demangled_buffer, &demangled_buffer_length, &status);
-						demangled_buffer[MAX_NAME_LEN] = 0;
-						if(status == 0)
-							vprints(io, "[", frames_count - i - 1, "]: ", demangled_buffer, "\n");
-						else
-							vprints(io, "[", frames_count - i - 1, "]: ", name_buffer, "\n");
+						madvise(result, size, MADV_HUGEPAGE);
+						//populate after the advice so that the pages are faulted in as huge pages
+						if(flags & VIRTUAL_FLAGS::POPULATE)
+							virtual_populate(make_slice((byte*)result, size));
 					}
-					::free(symbols);
 				}
 			}
-			#endif
+			else
+			{
+				result = mmap(address_hint, size, PROT_READ|PROT_WRITE, mmap_flags, -1, 0);
+			}
+
+			if(result == MAP_FAILED)
+				result = nullptr;
 		}
 		#endif
+
+		return own((byte*)result, size);
+	}
+
+	bool
+	OS::virtual_free(const Owner<byte>& data)
+	{
+		#if defined(OS_WINDOWS)
+			return VirtualFree(data.ptr, 0, MEM_RELEASE) != NULL;
+		#elif defined(OS_LINUX)
+			return munmap(data.ptr, data.size) == 0;
+		#endif
 	}
 
 	Owner<byte>
-	OS::virtual_alloc(void* address_hint, usize size)
+	OS::virtual_reserve(void* address_hint, usize size, VIRTUAL_FLAGS flags)
 	{
 		if(size == 0)
 			return Owner<byte>();
@@ -200,21 +414,157 @@ namespace cppr
 		void* result = nullptr;
 
 		#if defined(OS_WINDOWS)
-			result = VirtualAlloc(address_hint, size, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
+		{
+			//windows large pages can't be committed on demand so the flags are ignored
+			result = VirtualAlloc(address_hint, size, MEM_RESERVE, PAGE_NOACCESS);
+		}
 		#elif defined(OS_LINUX)
-			result = mmap(address_hint, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+		{
+			if(flags & VIRTUAL_FLAGS::HUGE_PAGES)
+			{
+				size = internal::align_up(size, virtual_huge_page_size());
+				result = _mmap_aligned(size, virtual_huge_page_size(), PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE);
+				if(result)
+					madvise(result, size, MADV_HUGEPAGE);
+			}
+			else
+			{
+				result = mmap(address_hint, size, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0);
+				if(result == MAP_FAILED)
+					result = nullptr;
+			}
+		}
 		#endif
 
 		return own((byte*)result, size);
 	}
 
 	bool
-	OS::virtual_free(const Owner<byte>& data)
+	OS::virtual_commit(const Slice<byte>& data)
 	{
+		if(data.size == 0)
+			return true;
+
 		#if defined(OS_WINDOWS)
-			return VirtualFree(data.ptr, 0, MEM_RELEASE) != NULL;
+			return VirtualAlloc(data.ptr, data.size, MEM_COMMIT, PAGE_READWRITE) != NULL;
 		#elif defined(OS_LINUX)
-			return munmap(data.ptr, data.size) == 0;
+			return mprotect(data.ptr, data.size, PROT_READ|PROT_WRITE) == 0;
+		#endif
+	}
+
+	bool
+	OS::virtual_decommit(const Slice<byte>& data)
+	{
+		if(data.size == 0)
+			return true;
+
+		#if defined(OS_WINDOWS)
+			return VirtualFree(data.ptr, data.size, MEM_DECOMMIT) != 0;
+		#elif defined(OS_LINUX)
+			if(madvise(data.ptr, data.size, MADV_DONTNEED) != 0)
+				return false;
+			return mprotect(data.ptr, data.size, PROT_NONE) == 0;
+		#endif
+	}
+
+	bool
+	OS::virtual_advise(const Slice<byte>& data, VIRTUAL_ADVICE advice)
+	{
+		if(data.size == 0)
+			return true;
+
+		#if defined(OS_WINDOWS)
+		{
+			switch(advice)
+			{
+				case VIRTUAL_ADVICE::WILL_NEED:
+				{
+					WIN32_MEMORY_RANGE_ENTRY range;
+					range.VirtualAddress = data.ptr;
+					range.NumberOfBytes = data.size;
+					return PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0) != 0;
+				}
+
+				case VIRTUAL_ADVICE::DONT_NEED:
+				case VIRTUAL_ADVICE::FREE:
+					return VirtualAlloc(data.ptr, data.size, MEM_RESET, PAGE_READWRITE) != NULL;
+
+				case VIRTUAL_ADVICE::NORMAL:
+				default:
+					return true;
+			}
+		}
+		#elif defined(OS_LINUX)
+		{
+			int linux_advice;
+			switch(advice)
+			{
+				case VIRTUAL_ADVICE::WILL_NEED:
+					linux_advice = MADV_WILLNEED;
+					break;
+
+				case VIRTUAL_ADVICE::DONT_NEED:
+					linux_advice = MADV_DONTNEED;
+					break;
+
+				case VIRTUAL_ADVICE::FREE:
+					#if defined(MADV_FREE)
+						linux_advice = MADV_FREE;
+					#else
+						linux_advice = MADV_DONTNEED;
+					#endif
+					break;
+
+				case VIRTUAL_ADVICE::NORMAL:
+				default:
+					linux_advice = MADV_NORMAL;
+					break;
+			}
+
+			return madvise(data.ptr, data.size, linux_advice) == 0;
+		}
+		#endif
+	}
+
+	void
+	OS::virtual_populate(const Slice<byte>& data)
+	{
+		usize page_size = virtual_page_size();
+		volatile byte* it = data.ptr;
+		volatile byte* end = data.ptr + data.size;
+		for(; it < end; it += page_size)
+			*it = *it;
+	}
+
+	usize
+	OS::virtual_page_size() const
+	{
+		#if defined(OS_WINDOWS)
+		{
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+			return info.dwPageSize;
+		}
+		#elif defined(OS_LINUX)
+		{
+			return sysconf(_SC_PAGESIZE);
+		}
+		#endif
+	}
+
+	usize
+	OS::virtual_huge_page_size() const
+	{
+		#if defined(OS_WINDOWS)
+		{
+			usize result = GetLargePageMinimum();
+			return result ? result : MEGABYTES(2);
+		}
+		#elif defined(OS_LINUX)
+		{
+			//the default transparent huge page size on x86_64 and arm64
+			return MEGABYTES(2);
+		}
 		#endif
 	}
 
@@ -589,29 +939,51 @@ namespace cppr
 
 	//Memory Functions
 	Owner<byte>
-	_debug_memory_alloc(void* _self, usize size)
+	_debug_memory_alloc(void* _self, usize size, usize alignment)
 	{
 		if(size == 0)
 			return Owner<byte>();
 
-		Memory_Block* ptr = (Memory_Block*)std::malloc(size + sizeof(Memory_Block));
+		if(alignment < alignof(Memory_Block))
+			alignment = alignof(Memory_Block);
 
-		if(ptr == nullptr)
+		//pad the header so that the user memory starts at an aligned address
+		usize header_size = internal::align_up(sizeof(Memory_Block), alignment);
+		byte* base = (byte*)_os_aligned_alloc(size + header_size, alignment);
+
+		if(base == nullptr)
 			return Owner<byte>();
 
+		Memory_Block* ptr = (Memory_Block*)(base + header_size) - 1;
 		ptr->size = size;
-		ptr->next = _leak_head;
-		ptr->prev = nullptr;
-		_leak_mtx.lock();
+		ptr->base = base;
+		ptr->call_stack_count = 0;
+
+		//only capture the raw return addresses of the sampled allocations
+		#if defined(DEBUG)
 		{
-			if(_leak_head) _leak_head->prev = ptr;
-			_leak_head = ptr;
+			OS* self = (OS*)_self;
+			if(self->leak_sampling_rate != 0 && ++_leak_sampling_counter >= self->leak_sampling_rate)
+			{
+				_leak_sampling_counter = 0;
+				ptr->call_stack_count = _capture_callstack(ptr->call_stack, LEAK_CALLSTACK_MAX);
+			}
 		}
-		_leak_mtx.unlock();
+		#endif
 
-		::new (&ptr->call_stack) Memory_Stream(&_mallocator);
-		OS* os = (OS*)_self;
-		os->dump_callstack(ptr->call_stack);
+		//each thread sticks to a shard to avoid contending on a single lock
+		static thread_local usize _shard_index = _leak_next_shard.fetch_add(1) % LEAK_SHARDS_COUNT;
+		ptr->shard = _shard_index;
+		ptr->prev = nullptr;
+
+		Leak_Shard& shard = _leak_shards[ptr->shard];
+		shard.mtx.lock();
+		{
+			ptr->next = shard.head;
+			if(shard.head) shard.head->prev = ptr;
+			shard.head = ptr;
+		}
+		shard.mtx.unlock();
 
 		return Owner<byte>((byte*)(ptr + 1), size);
 	}
@@ -624,10 +996,12 @@ namespace cppr
 
 		Memory_Block* ptr = (Memory_Block*)(value.ptr - sizeof(Memory_Block));
 
-		_leak_mtx.lock();
+		//the block is freed from the shard it was allocated in which may belong to another thread
+		Leak_Shard& shard = _leak_shards[ptr->shard];
+		shard.mtx.lock();
 		{
-			if(ptr == _leak_head)
-				_leak_head = ptr->next;
+			if(ptr == shard.head)
+				shard.head = ptr->next;
 			
 			if(ptr->prev)
 				ptr->prev->next = ptr->next;
@@ -635,16 +1009,15 @@ namespace cppr
 			if(ptr->next)
 				ptr->next->prev = ptr->prev;
 		}
-		_leak_mtx.unlock();
-
-		ptr->call_stack.reset();
+		shard.mtx.unlock();
 
-		std::free(ptr);
+		_os_aligned_free(ptr->base);
 	}
 
 	Owner<byte>
-	_virtual_memory_alloc(void* _self, usize size)
+	_virtual_memory_alloc(void* _self, usize size, usize)
 	{
+		//virtual memory is page aligned which satisfies any sane alignment
 		if(size == 0)
 			return Owner<byte>();
 
@@ -797,6 +1170,7 @@ namespace cppr
 
 		//setup the OS hooks
 		_os.global_memory = &_global_memory_trait;
+		_os.global_memory_stats = &_global_memory_stats;
 		_os.virtual_memory = &_virtual_memory_trait;
 		_os.leak_detector = &_leak_detector_trait;
 		_os.unbuf_stdout = &_stdout;
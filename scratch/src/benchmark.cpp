@@ -25,14 +25,22 @@
 #include <algorithm>
 
 #include <cpprelude/Tree_Map.h>
+#include <cpprelude/B_Tree_Map.h>
 #include <map>
 
 #include <cpprelude/String.h>
 #include <string>
+#include <cstdio>
 
 #include <cpprelude/Hash_Map.h>
+#include <cpprelude/Concurrent_Hash_Map.h>
+#include <cpprelude/Dense_Hash_Map.h>
+#include <cpprelude/Frozen_Hash_Map.h>
+#include <cpprelude/Small_Map.h>
 #include <unordered_set>
 #include <unordered_map>
+#include <thread>
+#include <mutex>
 
 #include <cpprelude/IO.h>
 
@@ -164,6 +172,27 @@ bm_Arena_Allocator_Single_List(Stopwatch &watch, usize limit)
 	return r;
 }
 
+usize
+bm_TLSF_Allocator_Single_List(Stopwatch &watch, usize limit)
+{
+	TLSF_Allocator tlsf(limit * 64 + MEGABYTES(1));
+	usize r = rand();
+
+	watch.start();
+	{
+		Single_List<usize> list(tlsf);
+		for(usize i = 0; i < limit; ++i)
+			list.insert_front(i + r);
+
+		for (const auto& number : list)
+			if (number % 2 == 0)
+				r += number;
+	}
+	watch.stop();
+
+	return r;
+}
+
 usize
 bm_forward_list(Stopwatch &watch, usize limit)
 {
@@ -430,6 +459,31 @@ bm_Tree_Map(Stopwatch &watch, usize limit)
 	return r;
 }
 
+usize
+bm_B_Tree_Map(Stopwatch &watch, usize limit)
+{
+	usize r = rand();
+
+	watch.start();
+	{
+		B_Tree_Map<usize, usize> map;
+		for(usize i = 0; i < limit; ++i)
+			map[i] = i+r;
+		for(usize i = 0; i < limit; ++i)
+		{
+			auto it = map.lookup(i);
+			if(it != map.end())
+			{
+				if((it->key + it->value) % 2 == 0)
+					map.remove(it);
+			}
+		}
+	}
+	watch.stop();
+
+	return r;
+}
+
 usize
 bm_map(Stopwatch &watch, usize limit)
 {
@@ -521,6 +575,28 @@ bm_Arena_Allocator_Hash_Set(Stopwatch &watch, usize limit)
 	return r;
 }
 
+usize
+bm_TLSF_Allocator_Hash_Set(Stopwatch &watch, usize limit)
+{
+	TLSF_Allocator tlsf(limit * 64 + MEGABYTES(1));
+	usize r = rand();
+
+	watch.start();
+	{
+		Hash_Set<usize> s(tlsf);
+		for(usize i = 0; i < limit; ++i)
+			s.insert(r + i);
+		for(usize i = r; i < limit + r; ++i)
+			if(i % 2 == 0)
+				s.remove(i);
+		for(const auto& num: s)
+			r += num;
+	}
+	watch.stop();
+
+	return r;
+}
+
 usize
 bm_unordered_set(Stopwatch &watch, usize limit)
 {
@@ -589,165 +665,1004 @@ bm_unordered_map(Stopwatch &watch, usize limit)
 }
 
 
-void
-bm_String(Stopwatch &watch, usize limit)
+usize
+bm_Hash_Map_Insert(Stopwatch &watch, usize limit)
 {
+	usize r = 0;
+
 	watch.start();
 	{
-		String str;
+		Hash_Map<usize, usize> m;
 		for(usize i = 0; i < limit; ++i)
-			str.concat("Mostafa");
+			m.insert(RANDOM_ARRAY[i] * 2, i);
+		r += m.count();
 	}
 	watch.stop();
+	return r;
 }
 
-void
-bm_string(Stopwatch &watch, usize limit)
+usize
+bm_unordered_map_Insert(Stopwatch &watch, usize limit)
 {
+	usize r = 0;
+
 	watch.start();
 	{
-		std::string str;
+		std::unordered_map<usize, usize> m;
 		for(usize i = 0; i < limit; ++i)
-			str += "Mostafa";
+			m.emplace(RANDOM_ARRAY[i] * 2, i);
+		r += m.size();
 	}
 	watch.stop();
+	return r;
 }
 
-
-bool
-bm_heap_sort(Stopwatch &watch, usize limit)
+usize
+bm_Hash_Map_Lookup(Stopwatch &watch, usize limit)
 {
-	Dynamic_Array<usize> array = RANDOM_ARRAY;
+	usize r = 0;
+	Hash_Map<usize, usize> m;
+	for(usize i = 0; i < limit; ++i)
+		m.insert(RANDOM_ARRAY[i] * 2, i);
 
 	watch.start();
-		cppr::heap_sort(array.all());
+	for(usize j = 0; j < 10; ++j)
+		for(usize i = 0; i < limit; ++i)
+			r += m.lookup(RANDOM_ARRAY[i] * 2)->value;
 	watch.stop();
-
-	bool result = cppr::is_sorted(array.all());
-	assert(result);
-
-	return result;
+	return r;
 }
 
-bool
-bm_std_heap_sort(Stopwatch &watch, usize limit)
+usize
+bm_unordered_map_Lookup(Stopwatch &watch, usize limit)
 {
-	std::vector<usize> array(RANDOM_ARRAY.begin(), RANDOM_ARRAY.end());
+	usize r = 0;
+	std::unordered_map<usize, usize> m;
+	for(usize i = 0; i < limit; ++i)
+		m.emplace(RANDOM_ARRAY[i] * 2, i);
 
 	watch.start();
-		std::make_heap(array.begin(), array.end());
-		std::sort_heap(array.begin(), array.end());
+	for(usize j = 0; j < 10; ++j)
+		for(usize i = 0; i < limit; ++i)
+			r += m.find(RANDOM_ARRAY[i] * 2)->second;
 	watch.stop();
+	return r;
+}
 
-	bool result = std::is_sorted(array.begin(), array.end());
-	assert(result);
+usize
+bm_Hash_Map_Miss(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	Hash_Map<usize, usize> m;
+	for(usize i = 0; i < limit; ++i)
+		m.insert(RANDOM_ARRAY[i] * 2, i);
 
-	return result;
+	//all the keys are even so the odd keys are misses
+	watch.start();
+	for(usize j = 0; j < 10; ++j)
+		for(usize i = 0; i < limit; ++i)
+			r += m.lookup(RANDOM_ARRAY[i] * 2 + 1) == m.end();
+	watch.stop();
+	return r;
 }
 
-
-bool
-bm_merge_sort(Stopwatch &watch, usize limit)
+template<HASH_PROBING PROBING>
+usize
+bm_Hash_Map_Churn(Stopwatch &watch, usize limit)
 {
-	Dynamic_Array<usize> array = RANDOM_ARRAY;
+	usize r = 0;
+	Hash_Map<usize, usize, internal::Pair_Hash_Functor<usize, usize>, PROBING> m;
+	for(usize i = 0; i < limit; ++i)
+		m.insert(RANDOM_ARRAY[i] * 2, i);
 
+	//each round removes a key and inserts a new one so the count stays the same,
+	//then looks for a missing key which has to walk the whole probe sequence
 	watch.start();
-		cppr::merge_sort(array.all());
+	for(usize j = 0; j < 10; ++j)
+	{
+		for(usize i = 0; i < limit; ++i)
+		{
+			usize key = RANDOM_ARRAY[i] * 2 + (j & 1);
+			r += m.remove(key);
+			m.insert(key ^ 1, i);
+			r += m.lookup(RANDOM_ARRAY[(i * 7) % limit] * 2 + 1 - (j & 1)) == m.end();
+		}
+	}
 	watch.stop();
+	return r;
+}
 
-	bool result = cppr::is_sorted(array.all());
-	assert(result);
+//runs the same total count of operations split over the given count of threads, one in every
+//WRITE_RATIO operations is an insert and the rest are lookups
+template<usize WRITE_RATIO>
+usize
+bm_mutex_Hash_Map_Threads(Stopwatch &watch, usize limit, usize threads_count)
+{
+	Hash_Map<usize, usize> m;
+	std::mutex mtx;
+	for(usize i = 0; i < limit; ++i)
+		m.insert(RANDOM_ARRAY[i] * 2, i);
 
-	return result;
+	std::atomic<usize> r(0);
+	std::vector<std::thread> threads;
+	watch.start();
+	for(usize t = 0; t < threads_count; ++t)
+	{
+		threads.emplace_back([&, t]{
+			usize found = 0;
+			for(usize i = t; i < limit * 4; i += threads_count)
+			{
+				usize key = RANDOM_ARRAY[i % limit] * 2 + (i % WRITE_RATIO == 0);
+				std::lock_guard<std::mutex> lock(mtx);
+				if(i % WRITE_RATIO == 0)
+					m.insert_or_assign(key, i);
+				else
+					found += m.lookup(key) != m.end();
+			}
+			r += found;
+		});
+	}
+	for(auto& thread: threads)
+		thread.join();
+	watch.stop();
+	return r;
 }
 
-bool
-bm_std_merge_sort(Stopwatch &watch, usize limit)
+template<usize WRITE_RATIO>
+usize
+bm_Concurrent_Hash_Map_Threads(Stopwatch &watch, usize limit, usize threads_count)
 {
-	std::vector<usize> array(RANDOM_ARRAY.begin(), RANDOM_ARRAY.end());
+	Concurrent_Hash_Map<usize, usize> m(threads_count);
+	for(usize i = 0; i < limit; ++i)
+		m.insert(RANDOM_ARRAY[i] * 2, i);
 
+	std::atomic<usize> r(0);
+	std::vector<std::thread> threads;
 	watch.start();
-		std::stable_sort(array.begin(), array.end());
+	for(usize t = 0; t < threads_count; ++t)
+	{
+		threads.emplace_back([&, t]{
+			usize found = 0, value = 0;
+			for(usize i = t; i < limit * 4; i += threads_count)
+			{
+				usize key = RANDOM_ARRAY[i % limit] * 2 + (i % WRITE_RATIO == 0);
+				if(i % WRITE_RATIO == 0)
+					m.insert_or_assign(key, i);
+				else
+					found += m.lookup(key, value);
+			}
+			r += found;
+		});
+	}
+	for(auto& thread: threads)
+		thread.join();
 	watch.stop();
+	return r;
+}
 
-	bool result = std::is_sorted(array.begin(), array.end());
-	assert(result);
+template<usize WRITE_RATIO>
+void
+compare_hash_map_threads(usize limit, const char* name)
+{
+	println();
+	println(name);
+	compare_benchmarks(
+		summary("mutex Hash_Map 1 thread"_rng, [&](Stopwatch& watch)
+		{
+			bm_mutex_Hash_Map_Threads<WRITE_RATIO>(watch, limit, 1);
+		}),
 
-	return result;
+		summary("mutex Hash_Map 8 threads"_rng, [&](Stopwatch& watch)
+		{
+			bm_mutex_Hash_Map_Threads<WRITE_RATIO>(watch, limit, 8);
+		}),
+
+		summary("Concurrent_Hash_Map 1 thread"_rng, [&](Stopwatch& watch)
+		{
+			bm_Concurrent_Hash_Map_Threads<WRITE_RATIO>(watch, limit, 1);
+		}),
+
+		summary("Concurrent_Hash_Map 2 threads"_rng, [&](Stopwatch& watch)
+		{
+			bm_Concurrent_Hash_Map_Threads<WRITE_RATIO>(watch, limit, 2);
+		}),
+
+		summary("Concurrent_Hash_Map 4 threads"_rng, [&](Stopwatch& watch)
+		{
+			bm_Concurrent_Hash_Map_Threads<WRITE_RATIO>(watch, limit, 4);
+		}),
+
+		summary("Concurrent_Hash_Map 8 threads"_rng, [&](Stopwatch& watch)
+		{
+			bm_Concurrent_Hash_Map_Threads<WRITE_RATIO>(watch, limit, 8);
+		})
+	);
 }
 
+//the results of the benchmarks which only compute are stored in it so their loops aren't removed
+volatile usize benchmark_sink;
 
-bool
-bm_quick_sort(Stopwatch &watch, usize limit)
+//hashes the same amount of bytes split into keys of the given size, each hash feeds the next one
+//so the calls can't be hoisted out of the loop
+
+template<HASH_ALGORITHM ALGORITHM>
+void
+bm_hash_bytes(Stopwatch &watch, usize limit, usize key_size)
 {
-	Dynamic_Array<usize> array = RANDOM_ARRAY;
+	constexpr usize BUFFER_SIZE = KILOBYTES(64);
+	Owner<byte> buffer = alloc<byte>(BUFFER_SIZE + key_size);
+	for(usize i = 0; i < buffer.count(); ++i)
+		buffer[i] = static_cast<byte>(i * 31);
 
+	usize keys_count = limit * KILOBYTES(4) / key_size;
+	usize r = 0;
 	watch.start();
-		cppr::quick_sort(array.all());
+	for(usize i = 0; i < keys_count; ++i)
+	{
+		usize offset = (i * key_size + (r & 7)) % BUFFER_SIZE;
+		r += hash_bytes(buffer.ptr + offset, key_size, ALGORITHM);
+	}
 	watch.stop();
 
-	bool result = cppr::is_sorted(array.all());
-	assert(result);
+	benchmark_sink = r;
+	free(buffer);
+}
 
-	return result;
+void
+compare_hash_bytes(usize limit)
+{
+	usize key_sizes[] = {4, 16, 64, 256, 1024, 4096};
+	for(usize key_size: key_sizes)
+	{
+		println();
+		println("hash ", key_size, " bytes keys");
+		compare_benchmarks(
+			summary("murmur_hash"_rng, [&](Stopwatch& watch)
+			{
+				bm_hash_bytes<HASH_ALGORITHM::MURMUR>(watch, limit, key_size);
+			}),
+
+			summary("wyhash"_rng, [&](Stopwatch& watch)
+			{
+				bm_hash_bytes<HASH_ALGORITHM::WYHASH>(watch, limit, key_size);
+			})
+		);
+	}
 }
 
-bool
-bm_std_quick_sort(Stopwatch &watch, usize limit)
+//big values iterated over several times, the sparse tables scan their empty slots on every pass
+struct Big_Value
 {
-	std::vector<usize> array(RANDOM_ARRAY.begin(), RANDOM_ARRAY.end());
+	usize data[8];
+};
+
+template<typename TMap>
+usize
+bm_map_Iterate(Stopwatch &watch, usize limit)
+{
+	TMap m;
+	for(usize i = 0; i < limit; ++i)
+		m[i].data[0] = i;
 
+	usize r = 0;
 	watch.start();
-		std::sort(array.begin(), array.end());
+	for(usize pass = 0; pass < 16; ++pass)
+		for(const auto& pair: m)
+			r += pair.second.data[0];
 	watch.stop();
+	return r;
+}
 
-	bool result = std::is_sorted(array.begin(), array.end());
-	assert(result);
+template<typename TMap>
+usize
+bm_Hash_Map_Iterate(Stopwatch &watch, usize limit)
+{
+	TMap m;
+	for(usize i = 0; i < limit; ++i)
+		m[i].data[0] = i;
 
-	return result;
+	usize r = 0;
+	watch.start();
+	for(usize pass = 0; pass < 16; ++pass)
+		for(const auto& pair: m)
+			r += pair.value.data[0];
+	watch.stop();
+	return r;
 }
 
-struct Screamer
+//random keys in the ordered maps, the lookups and the scans go over the whole tree
+template<typename TMap>
+usize
+bm_Tree_Map_Insert(Stopwatch &watch, usize limit)
 {
-	Screamer()
-	{
-		println("Screamer()");
-	}
-
-	Screamer(const Screamer& other)
-	{
-		println("Screamer(const Screamer&)");
-	}
+	usize r = 0;
 
-	Screamer(Screamer&& other)
+	watch.start();
 	{
-		println("Screamer(Screamer&&)");
+		TMap m;
+		for(usize i = 0; i < limit; ++i)
+			m[RANDOM_ARRAY[i]] = i;
+		r += m.count();
 	}
+	watch.stop();
 
-	Screamer&
-	operator=(const Screamer& other)
-	{
-		println("operator=(const Screamer&)");
-		return *this;
-	}
+	benchmark_sink = r;
+	return r;
+}
 
-	Screamer&
-	operator=(Screamer&& other)
-	{
-		println("operator=(Screamer&&");
-		return *this;
-	}
+usize
+bm_map_Insert(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
 
-	~Screamer()
+	watch.start();
 	{
-		println("~Screamer()");
+		std::map<usize, usize> m;
+		for(usize i = 0; i < limit; ++i)
+			m[RANDOM_ARRAY[i]] = i;
+		r += m.size();
 	}
-};
+	watch.stop();
 
-int x;
+	benchmark_sink = r;
+	return r;
+}
 
-Executer*
-task_wait(Executer* exe, Task::Arg arg)
+template<typename TMap>
+usize
+bm_Tree_Map_Lookup(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	TMap m;
+	for(usize i = 0; i < limit; ++i)
+		m[RANDOM_ARRAY[i]] = i;
+
+	watch.start();
+	for(usize j = 0; j < 10; ++j)
+		for(usize i = 0; i < limit; ++i)
+			r += m.lookup(RANDOM_ARRAY[i])->value;
+	watch.stop();
+
+	benchmark_sink = r;
+	return r;
+}
+
+usize
+bm_map_Lookup(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	std::map<usize, usize> m;
+	for(usize i = 0; i < limit; ++i)
+		m[RANDOM_ARRAY[i]] = i;
+
+	watch.start();
+	for(usize j = 0; j < 10; ++j)
+		for(usize i = 0; i < limit; ++i)
+			r += m.find(RANDOM_ARRAY[i])->second;
+	watch.stop();
+
+	benchmark_sink = r;
+	return r;
+}
+
+template<typename TMap>
+usize
+bm_Tree_Map_Scan(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	TMap m;
+	for(usize i = 0; i < limit; ++i)
+		m[RANDOM_ARRAY[i]] = i;
+
+	watch.start();
+	for(usize pass = 0; pass < 16; ++pass)
+		for(const auto& pair: m)
+			r += pair.value;
+	watch.stop();
+
+	benchmark_sink = r;
+	return r;
+}
+
+usize
+bm_map_Scan(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	std::map<usize, usize> m;
+	for(usize i = 0; i < limit; ++i)
+		m[RANDOM_ARRAY[i]] = i;
+
+	watch.start();
+	for(usize pass = 0; pass < 16; ++pass)
+		for(const auto& pair: m)
+			r += pair.second;
+	watch.stop();
+
+	benchmark_sink = r;
+	return r;
+}
+
+//pages of 10 values at random indices, the walk is how the index had to be reached without the subtree sizes
+usize
+bm_map_Page(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	std::map<usize, usize> m;
+	for(usize i = 0; i < limit; ++i)
+		m[RANDOM_ARRAY[i]] = i;
+
+	watch.start();
+	for(usize i = 0; i < 100; ++i)
+	{
+		auto it = std::next(m.begin(), RANDOM_ARRAY[i] % (m.size() - 10));
+		for(usize j = 0; j < 10; ++j, ++it)
+			r += it->second;
+	}
+	watch.stop();
+
+	benchmark_sink = r;
+	return r;
+}
+
+usize
+bm_Tree_Map_Page_Walk(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	Tree_Map<usize, usize> m;
+	for(usize i = 0; i < limit; ++i)
+		m[RANDOM_ARRAY[i]] = i;
+
+	watch.start();
+	for(usize i = 0; i < 100; ++i)
+	{
+		auto it = m.begin();
+		for(usize j = RANDOM_ARRAY[i] % (m.count() - 10); j > 0; --j)
+			++it;
+		for(usize j = 0; j < 10; ++j, ++it)
+			r += it->value;
+	}
+	watch.stop();
+
+	benchmark_sink = r;
+	return r;
+}
+
+usize
+bm_Tree_Map_Page(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	Tree_Map<usize, usize> m;
+	for(usize i = 0; i < limit; ++i)
+		m[RANDOM_ARRAY[i]] = i;
+
+	watch.start();
+	for(usize i = 0; i < 100; ++i)
+	{
+		usize start = RANDOM_ARRAY[i] % (m.count() - 10);
+		for(auto range = m.range(start, start + 10); !range.empty(); range.pop_front())
+			r += range.front().value;
+	}
+	watch.stop();
+
+	benchmark_sink = r;
+	return r;
+}
+
+//time windows [from, from + 40) over keys spaced by 4, the scan is how the window had to be found without bounds
+usize
+bm_map_Window(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	std::map<usize, usize> m;
+	for(usize i = 0; i < limit; ++i)
+		m[RANDOM_ARRAY[i] % limit * 4] = i;
+
+	watch.start();
+	for(usize i = 0; i < 100; ++i)
+	{
+		usize from = RANDOM_ARRAY[i] % limit * 4;
+		for(auto it = m.lower_bound(from), end = m.lower_bound(from + 40); it != end; ++it)
+			r += it->second;
+	}
+	watch.stop();
+
+	benchmark_sink = r;
+	return r;
+}
+
+usize
+bm_Tree_Map_Window_Scan(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	Tree_Map<usize, usize> m;
+	for(usize i = 0; i < limit; ++i)
+		m[RANDOM_ARRAY[i] % limit * 4] = i;
+
+	watch.start();
+	for(usize i = 0; i < 100; ++i)
+	{
+		usize from = RANDOM_ARRAY[i] % limit * 4;
+		for(const auto& pair: m)
+		{
+			if(pair.key >= from + 40)
+				break;
+			if(pair.key >= from)
+				r += pair.value;
+		}
+	}
+	watch.stop();
+
+	benchmark_sink = r;
+	return r;
+}
+
+usize
+bm_Tree_Map_Window(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	Tree_Map<usize, usize> m;
+	for(usize i = 0; i < limit; ++i)
+		m[RANDOM_ARRAY[i] % limit * 4] = i;
+
+	watch.start();
+	for(usize i = 0; i < 100; ++i)
+	{
+		usize from = RANDOM_ARRAY[i] % limit * 4;
+		for(const auto& pair: m.range(m.ceil(from), m.ceil(from + 40)))
+			r += pair.value;
+	}
+	watch.stop();
+
+	benchmark_sink = r;
+	return r;
+}
+
+//rebuilds a map from sorted pairs like an index rebuild
+usize
+bm_map_Build_Sorted(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	watch.start();
+	{
+		std::map<usize, usize> m;
+		for(usize i = 0; i < limit; ++i)
+			m.emplace_hint(m.end(), i, i);
+		r += m.size();
+	}
+	watch.stop();
+	return r;
+}
+
+usize
+bm_Tree_Map_Build_Sorted_Insert(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	watch.start();
+	{
+		Tree_Map<usize, usize> m;
+		for(usize i = 0; i < limit; ++i)
+			m.insert(i, i);
+		r += m.count();
+	}
+	watch.stop();
+	return r;
+}
+
+usize
+bm_Tree_Map_Build_Sorted(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	Dynamic_Array<Pair_Node<usize, usize>> pairs;
+	for(usize i = 0; i < limit; ++i)
+		pairs.insert_back(Pair_Node<usize, usize>(i, i));
+
+	watch.start();
+	{
+		Tree_Map<usize, usize> m;
+		m.build_from_sorted(pairs.all());
+		r += m.count();
+	}
+	watch.stop();
+	return r;
+}
+
+//merges two maps of the random keys
+usize
+bm_Tree_Map_Merge_Insert(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	Tree_Map<usize, usize> a, b;
+	for(usize i = 0; i < limit; ++i)
+		(i % 2 ? a : b)[RANDOM_ARRAY[i]] = i;
+
+	watch.start();
+	for(const auto& pair: b)
+		a.insert(pair.key, pair.value);
+	b.clear();
+	watch.stop();
+
+	r += a.count();
+	return r;
+}
+
+usize
+bm_Tree_Map_Merge(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	Tree_Map<usize, usize> a, b;
+	for(usize i = 0; i < limit; ++i)
+		(i % 2 ? a : b)[RANDOM_ARRAY[i]] = i;
+
+	watch.start();
+	a.merge(b);
+	watch.stop();
+
+	r += a.count();
+	return r;
+}
+
+//many short lived maps of a few keys each, like the per request or per node maps
+template<typename TMap>
+usize
+bm_map_Tiny(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	watch.start();
+	for(usize i = 0; i < limit * 10; ++i)
+	{
+		TMap m;
+		for(usize j = 0; j < 5; ++j)
+			m[RANDOM_ARRAY[(i + j) % limit]] = j;
+		for(usize j = 0; j < 5; ++j)
+			r += m.lookup(RANDOM_ARRAY[(i + j * 2) % limit]) != m.end();
+	}
+	watch.stop();
+	return r;
+}
+
+void
+compare_frozen_hash_map(usize keys_count)
+{
+	constexpr usize LOOKUPS_COUNT = 1 << 20;
+
+	Hash_Map<usize, usize> m;
+	m.reserve(keys_count);
+	for(usize i = 0; i < keys_count; ++i)
+		m.insert(i * 2, i);
+
+	Stopwatch build_watch;
+	build_watch.start();
+	Frozen_Hash_Map<usize, usize> frozen;
+	frozen.build(m);
+	build_watch.stop();
+
+	//the odd keys miss, the hash map stops at an empty slot while the frozen map always compares a key
+	Dynamic_Array<usize> hit_keys, mixed_keys;
+	for(usize i = 0; i < LOOKUPS_COUNT; ++i)
+	{
+		hit_keys.insert_back(usize(rand()) % keys_count * 2);
+		mixed_keys.insert_back(usize(rand()) % (keys_count * 2));
+	}
+
+	println();
+	println("frozen hash map lookups in ", keys_count, " keys, built in ", build_watch.milliseconds(), "ms");
+	for(const Dynamic_Array<usize>* keys: {&hit_keys, &mixed_keys})
+	{
+		println(keys == &hit_keys ? "all hit" : "half miss");
+		compare_benchmarks(
+			summary("Hash_Map lookup"_rng, [&](Stopwatch& watch)
+			{
+				usize r = 0;
+				watch.start();
+				for(usize i = 0; i < LOOKUPS_COUNT; ++i)
+				{
+					r += m.lookup((*keys)[i]) != m.end();
+				}
+				watch.stop();
+				benchmark_sink = r;
+			}),
+
+			summary("Frozen_Hash_Map lookup"_rng, [&](Stopwatch& watch)
+			{
+				usize r = 0;
+				watch.start();
+				for(usize i = 0; i < LOOKUPS_COUNT; ++i)
+				{
+					r += frozen.lookup((*keys)[i]) != frozen.end();
+				}
+				watch.stop();
+				benchmark_sink = r;
+			})
+		);
+	}
+}
+
+//times each alloc and free of a random churn on its own, the percentiles show the worst cases
+//which the container benchmarks average away, the live blocks are capped so the TLSF pool never runs out
+void
+compare_allocator_latency(usize ops_count)
+{
+	constexpr usize LIVE_MAX = 4096;
+	constexpr usize BLOCK_SIZE_MAX = 2048;
+	TLSF_Allocator tlsf(LIVE_MAX * BLOCK_SIZE_MAX * 2);
+
+	println();
+	println("allocator latency of ", ops_count, " random alloc/free in nanoseconds [p50, p99, p99.9, max]");
+	for(usize i = 0; i < 2; ++i)
+	{
+		Allocator_Trait* allocator = i == 0 ? os->global_memory : (Allocator_Trait*)tlsf;
+		Dynamic_Array<r64> alloc_laps, free_laps;
+		Dynamic_Array<Owner<byte>> blocks;
+		Stopwatch watch;
+		srand(1234);
+
+		for(usize j = 0; j < ops_count; ++j)
+		{
+			if(blocks.count() == LIVE_MAX || (blocks.count() > 0 && rand() % 2 == 0))
+			{
+				usize index = usize(rand()) % blocks.count();
+				std::swap(blocks[index], blocks[blocks.count() - 1]);
+				watch.start();
+				allocator->free(blocks[blocks.count() - 1]);
+				free_laps.insert_back(watch.stop());
+				blocks.remove_back();
+			}
+			else
+			{
+				usize size = 16 + usize(rand()) % BLOCK_SIZE_MAX;
+				watch.start();
+				auto block = allocator->alloc<byte>(size);
+				alloc_laps.insert_back(watch.stop());
+				block[0] = 1;
+				blocks.insert_back(std::move(block));
+			}
+		}
+		for(auto& block: blocks)
+			allocator->free(block);
+
+		quick_sort(alloc_laps.all());
+		quick_sort(free_laps.all());
+		auto percentile = [](const Dynamic_Array<r64>& laps, r64 ratio) { return laps[usize((laps.count() - 1) * ratio)]; };
+		const char* name = i == 0 ? "global_memory " : "TLSF_Allocator";
+		println(name, " alloc: ", percentile(alloc_laps, 0.5), ", ", percentile(alloc_laps, 0.99), ", ",
+				percentile(alloc_laps, 0.999), ", ", percentile(alloc_laps, 1.0));
+		println(name, " free:  ", percentile(free_laps, 0.5), ", ", percentile(free_laps, 0.99), ", ",
+				percentile(free_laps, 0.999), ", ", percentile(free_laps, 1.0));
+	}
+}
+
+usize
+bm_unordered_map_Miss(Stopwatch &watch, usize limit)
+{
+	usize r = 0;
+	std::unordered_map<usize, usize> m;
+	for(usize i = 0; i < limit; ++i)
+		m.emplace(RANDOM_ARRAY[i] * 2, i);
+
+	watch.start();
+	for(usize j = 0; j < 10; ++j)
+		for(usize i = 0; i < limit; ++i)
+			r += m.find(RANDOM_ARRAY[i] * 2 + 1) == m.end();
+	watch.stop();
+	return r;
+}
+
+//header lookups as in request parsing, the names are ranges into the request buffer
+template<bool TEMP_STRING>
+usize
+bm_Hash_Map_String_Lookup(Stopwatch &watch, usize limit)
+{
+	const char* names[] = {"Host", "Accept", "Content-Type", "Content-Length", "User-Agent", "Connection"};
+	const char* request = "Content-Length: 42\r\nUser-Agent: cpprelude\r\nX-Unknown: 1\r\n";
+	String_Range headers[] = {
+		make_strrng(request, 14),
+		make_strrng(request + 20, 10),
+		make_strrng(request + 43, 9)
+	};
+
+	Hash_Map<String, usize> m;
+	for(usize i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+		m.insert(String(names[i]), i);
+
+	usize r = 0;
+	watch.start();
+	for(usize i = 0; i < limit; ++i)
+	{
+		const auto& header = headers[(i + r) % 3];
+		if(TEMP_STRING)
+			r += m.lookup(String(header)) != m.end();
+		else
+			r += m.lookup(header) != m.end();
+	}
+	watch.stop();
+	return r;
+}
+
+//long String keys inserted without reserving so the set grows several times, then looked up
+template<bool CACHE_HASH>
+usize
+bm_Hash_Set_String_Keys(Stopwatch &watch, usize limit)
+{
+	Dynamic_Array<String> keys;
+	char buffer[64];
+	for(usize i = 0; i < limit; ++i)
+	{
+		std::snprintf(buffer, sizeof(buffer), "/usr/share/cpprelude/resources/file_%zu.txt", i);
+		keys.insert_back(String(buffer));
+	}
+
+	usize r = 0;
+	watch.start();
+	{
+		Hash_Set<String, Hash<String>, HASH_PROBING::SWISS, CACHE_HASH> set;
+		for(const auto& key: keys)
+			set.insert(key);
+		for(const auto& key: keys)
+			r += set.contains(key);
+	}
+	watch.stop();
+	return r;
+}
+
+void
+bm_String(Stopwatch &watch, usize limit)
+{
+	watch.start();
+	{
+		String str;
+		for(usize i = 0; i < limit; ++i)
+			str.concat("Mostafa");
+	}
+	watch.stop();
+}
+
+void
+bm_string(Stopwatch &watch, usize limit)
+{
+	watch.start();
+	{
+		std::string str;
+		for(usize i = 0; i < limit; ++i)
+			str += "Mostafa";
+	}
+	watch.stop();
+}
+
+
+bool
+bm_heap_sort(Stopwatch &watch, usize limit)
+{
+	Dynamic_Array<usize> array = RANDOM_ARRAY;
+
+	watch.start();
+		cppr::heap_sort(array.all());
+	watch.stop();
+
+	bool result = cppr::is_sorted(array.all());
+	assert(result);
+
+	return result;
+}
+
+bool
+bm_std_heap_sort(Stopwatch &watch, usize limit)
+{
+	std::vector<usize> array(RANDOM_ARRAY.begin(), RANDOM_ARRAY.end());
+
+	watch.start();
+		std::make_heap(array.begin(), array.end());
+		std::sort_heap(array.begin(), array.end());
+	watch.stop();
+
+	bool result = std::is_sorted(array.begin(), array.end());
+	assert(result);
+
+	return result;
+}
+
+
+bool
+bm_merge_sort(Stopwatch &watch, usize limit)
+{
+	Dynamic_Array<usize> array = RANDOM_ARRAY;
+
+	watch.start();
+		cppr::merge_sort(array.all());
+	watch.stop();
+
+	bool result = cppr::is_sorted(array.all());
+	assert(result);
+
+	return result;
+}
+
+bool
+bm_std_merge_sort(Stopwatch &watch, usize limit)
+{
+	std::vector<usize> array(RANDOM_ARRAY.begin(), RANDOM_ARRAY.end());
+
+	watch.start();
+		std::stable_sort(array.begin(), array.end());
+	watch.stop();
+
+	bool result = std::is_sorted(array.begin(), array.end());
+	assert(result);
+
+	return result;
+}
+
+
+bool
+bm_quick_sort(Stopwatch &watch, usize limit)
+{
+	Dynamic_Array<usize> array = RANDOM_ARRAY;
+
+	watch.start();
+		cppr::quick_sort(array.all());
+	watch.stop();
+
+	bool result = cppr::is_sorted(array.all());
+	assert(result);
+
+	return result;
+}
+
+bool
+bm_std_quick_sort(Stopwatch &watch, usize limit)
+{
+	std::vector<usize> array(RANDOM_ARRAY.begin(), RANDOM_ARRAY.end());
+
+	watch.start();
+		std::sort(array.begin(), array.end());
+	watch.stop();
+
+	bool result = std::is_sorted(array.begin(), array.end());
+	assert(result);
+
+	return result;
+}
+
+struct Screamer
+{
+	Screamer()
+	{
+		println("Screamer()");
+	}
+
+	Screamer(const Screamer& other)
+	{
+		println("Screamer(const Screamer&)");
+	}
+
+	Screamer(Screamer&& other)
+	{
+		println("Screamer(Screamer&&)");
+	}
+
+	Screamer&
+	operator=(const Screamer& other)
+	{
+		println("operator=(const Screamer&)");
+		return *this;
+	}
+
+	Screamer&
+	operator=(Screamer&& other)
+	{
+		println("operator=(Screamer&&");
+		return *this;
+	}
+
+	~Screamer()
+	{
+		println("~Screamer()");
+	}
+};
+
+int x;
+
+Executer*
+task_wait(Executer* exe, Task::Arg arg)
 {
 	++x;
 	//cppr::printf("Task #{}, From Worker #{}\n", exe->task.id, exe->worker.id);
@@ -903,6 +1818,34 @@ do_benchmark()
 
 	println();
 
+	compare_benchmarks(
+		summary("Hash_Map<String> lookup String"_rng, [&](Stopwatch& watch)
+		{
+			bm_Hash_Map_String_Lookup<true>(watch, limit);
+		}),
+
+		summary("Hash_Map<String> lookup String_Range"_rng, [&](Stopwatch& watch)
+		{
+			bm_Hash_Map_String_Lookup<false>(watch, limit);
+		})
+	);
+
+	println();
+
+	compare_benchmarks(
+		summary("Hash_Set<String> no cached hash"_rng, [&](Stopwatch& watch)
+		{
+			bm_Hash_Set_String_Keys<false>(watch, limit);
+		}),
+
+		summary("Hash_Set<String> cached hash"_rng, [&](Stopwatch& watch)
+		{
+			bm_Hash_Set_String_Keys<true>(watch, limit);
+		})
+	);
+
+	println();
+
 	compare_benchmarks(
 		summary("std::forward_list"_rng, [&](Stopwatch& watch)
 		{
@@ -922,6 +1865,11 @@ do_benchmark()
 		summary("Single_List Arena_Allocator"_rng, [&](Stopwatch& watch)
 		{
 			bm_Arena_Allocator_Single_List(watch, limit);
+		}),
+
+		summary("Single_List TLSF_Allocator"_rng, [&](Stopwatch& watch)
+		{
+			bm_TLSF_Allocator_Single_List(watch, limit);
 		})
 	);
 
@@ -1002,6 +1950,11 @@ do_benchmark()
 		summary("Tree_Map"_rng, [&](Stopwatch& watch)
 		{
 			bm_Tree_Map(watch, limit);
+		}),
+
+		summary("B_Tree_Map"_rng, [&](Stopwatch& watch)
+		{
+			bm_B_Tree_Map(watch, limit);
 		})
 	);
 
@@ -1026,6 +1979,11 @@ do_benchmark()
 		summary("Hash_Set Arena_Allocator"_rng, [&](Stopwatch& watch)
 		{
 			bm_Arena_Allocator_Hash_Set(watch, limit);
+		}),
+
+		summary("Hash_Set TLSF_Allocator"_rng, [&](Stopwatch& watch)
+		{
+			bm_TLSF_Allocator_Hash_Set(watch, limit);
 		})
 	);
 
@@ -1047,6 +2005,235 @@ do_benchmark()
 
 	println();
 
+	compare_benchmarks(
+		summary("std::unordered_map insert"_rng, [&](Stopwatch& watch)
+		{
+			bm_unordered_map_Insert(watch, limit);
+		}),
+
+		summary("Hash_Map insert"_rng, [&](Stopwatch& watch)
+		{
+			bm_Hash_Map_Insert(watch, limit);
+		})
+	);
+
+	println();
+
+	compare_benchmarks(
+		summary("std::unordered_map lookup"_rng, [&](Stopwatch& watch)
+		{
+			bm_unordered_map_Lookup(watch, limit);
+		}),
+
+		summary("Hash_Map lookup"_rng, [&](Stopwatch& watch)
+		{
+			bm_Hash_Map_Lookup(watch, limit);
+		})
+	);
+
+	println();
+
+	compare_benchmarks(
+		summary("std::unordered_map miss"_rng, [&](Stopwatch& watch)
+		{
+			bm_unordered_map_Miss(watch, limit);
+		}),
+
+		summary("Hash_Map miss"_rng, [&](Stopwatch& watch)
+		{
+			bm_Hash_Map_Miss(watch, limit);
+		})
+	);
+
+	println();
+
+	compare_benchmarks(
+		summary("Hash_Map swiss churn"_rng, [&](Stopwatch& watch)
+		{
+			bm_Hash_Map_Churn<HASH_PROBING::SWISS>(watch, limit);
+		}),
+
+		summary("Hash_Map robin hood churn"_rng, [&](Stopwatch& watch)
+		{
+			bm_Hash_Map_Churn<HASH_PROBING::ROBIN_HOOD>(watch, limit);
+		})
+	);
+
+	println();
+
+	compare_benchmarks(
+		summary("std::unordered_map iterate"_rng, [&](Stopwatch& watch)
+		{
+			bm_map_Iterate<std::unordered_map<usize, Big_Value>>(watch, limit);
+		}),
+
+		summary("Hash_Map iterate"_rng, [&](Stopwatch& watch)
+		{
+			bm_Hash_Map_Iterate<Hash_Map<usize, Big_Value>>(watch, limit);
+		}),
+
+		summary("Dense_Hash_Map iterate"_rng, [&](Stopwatch& watch)
+		{
+			bm_Hash_Map_Iterate<Dense_Hash_Map<usize, Big_Value>>(watch, limit);
+		})
+	);
+
+	println();
+
+	compare_benchmarks(
+		summary("Hash_Map tiny maps"_rng, [&](Stopwatch& watch)
+		{
+			bm_map_Tiny<Hash_Map<usize, usize>>(watch, limit);
+		}),
+
+		summary("Small_Map tiny maps"_rng, [&](Stopwatch& watch)
+		{
+			bm_map_Tiny<Small_Map<usize, usize>>(watch, limit);
+		})
+	);
+
+	println();
+
+	compare_benchmarks(
+		summary("std::map insert"_rng, [&](Stopwatch& watch)
+		{
+			bm_map_Insert(watch, limit);
+		}),
+
+		summary("Tree_Map insert"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Insert<Tree_Map<usize, usize>>(watch, limit);
+		}),
+
+		summary("B_Tree_Map insert"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Insert<B_Tree_Map<usize, usize>>(watch, limit);
+		})
+	);
+
+	println();
+
+	compare_benchmarks(
+		summary("std::map lookup"_rng, [&](Stopwatch& watch)
+		{
+			bm_map_Lookup(watch, limit);
+		}),
+
+		summary("Tree_Map lookup"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Lookup<Tree_Map<usize, usize>>(watch, limit);
+		}),
+
+		summary("B_Tree_Map lookup"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Lookup<B_Tree_Map<usize, usize>>(watch, limit);
+		})
+	);
+
+	println();
+
+	compare_benchmarks(
+		summary("std::map scan"_rng, [&](Stopwatch& watch)
+		{
+			bm_map_Scan(watch, limit);
+		}),
+
+		summary("Tree_Map scan"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Scan<Tree_Map<usize, usize>>(watch, limit);
+		}),
+
+		summary("B_Tree_Map scan"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Scan<B_Tree_Map<usize, usize>>(watch, limit);
+		})
+	);
+
+	println();
+
+	compare_benchmarks(
+		summary("std::map page"_rng, [&](Stopwatch& watch)
+		{
+			bm_map_Page(watch, limit);
+		}),
+
+		summary("Tree_Map page walk"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Page_Walk(watch, limit);
+		}),
+
+		summary("Tree_Map page"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Page(watch, limit);
+		})
+	);
+
+	println();
+
+	compare_benchmarks(
+		summary("std::map window"_rng, [&](Stopwatch& watch)
+		{
+			bm_map_Window(watch, limit);
+		}),
+
+		summary("Tree_Map window scan"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Window_Scan(watch, limit);
+		}),
+
+		summary("Tree_Map window"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Window(watch, limit);
+		})
+	);
+
+	println();
+
+	compare_benchmarks(
+		summary("std::map sorted build"_rng, [&](Stopwatch& watch)
+		{
+			bm_map_Build_Sorted(watch, limit);
+		}),
+
+		summary("Tree_Map sorted insert"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Build_Sorted_Insert(watch, limit);
+		}),
+
+		summary("Tree_Map build_from_sorted"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Build_Sorted(watch, limit);
+		})
+	);
+
+	println();
+
+	compare_benchmarks(
+		summary("Tree_Map merge by insert"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Merge_Insert(watch, limit);
+		}),
+
+		summary("Tree_Map merge"_rng, [&](Stopwatch& watch)
+		{
+			bm_Tree_Map_Merge(watch, limit);
+		})
+	);
+
+	compare_hash_map_threads<10>(limit, "hash map 90% readers 10% writers");
+	compare_hash_map_threads<2>(limit, "hash map 50% readers 50% writers");
+
+	compare_hash_bytes(limit);
+
+	compare_allocator_latency(1 << 20);
+
+	compare_frozen_hash_map(1 << 16);
+	compare_frozen_hash_map(1 << 22);
+
+	generate_random_data(limit);
+
+	println();
+
 	compare_benchmarks(
 		summary("std::heap_sort"_rng, [&](Stopwatch& watch)
 		{
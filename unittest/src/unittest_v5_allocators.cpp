@@ -0,0 +1,496 @@
+#include "catch.hpp"
+#include <cpprelude/Allocators.h>
+#include <cpprelude/Dynamic_Array.h>
+#include <cpprelude/Memory_Stream.h>
+#include <cpprelude/String.h>
+#include <cpprelude/IO.h>
+#include <cpprelude/Loom.h>
+#include <thread>
+#include <random>
+#include <string>
+
+using namespace cppr;
+
+struct alignas(64) Padded_Counter
+{
+	usize value;
+};
+
+struct Concurrent_Arena_Job
+{
+	Concurrent_Arena_Allocator* arena;
+	Slice<Owner<usize>> blocks;
+	usize id;
+};
+
+Executer*
+concurrent_arena_task(Executer* exe, Task::Arg arg)
+{
+	auto job = (Concurrent_Arena_Job*)arg;
+	for(usize i = 0; i < job->blocks.count(); ++i)
+	{
+		usize count = (i % 7) + 1;
+		auto block = job->arena->alloc<usize>(count, i % 3 == 0 ? 64 : alignof(usize));
+		for(usize j = 0; j < count; ++j)
+			block[j] = job->id;
+		job->blocks[i] = std::move(block);
+	}
+	return exe;
+}
+
+TEST_CASE("Allocators", "[Allocators]")
+{
+	SECTION("Case 01")
+	{
+		Stack_Allocator stack(KILOBYTES(4));
+
+		auto a = stack.alloc<byte>(3);
+		auto b = stack.alloc<Padded_Counter>(2);
+		auto c = stack.alloc<byte>(1, 32);
+
+		CHECK(a.ptr != nullptr);
+		CHECK(b.ptr != nullptr);
+		CHECK(c.ptr != nullptr);
+		CHECK(((usize)b.ptr % alignof(Padded_Counter)) == 0);
+		CHECK(((usize)c.ptr % 32) == 0);
+
+		stack.free(c);
+		stack.free(b);
+		stack.free(a);
+		CHECK(stack.used_memory_size() == 0);
+
+		a = stack.alloc<byte>(3);
+		b = stack.alloc<Padded_Counter>(2);
+		stack.free(b);
+		CHECK(stack.used_memory_size() == usize(a.ptr + 3 - stack._memory.ptr));
+		stack.free(a);
+		CHECK(stack.used_memory_size() == 0);
+	}
+
+	SECTION("Case 02")
+	{
+		Arena_Allocator arena;
+
+		for(usize i = 0; i < 100; ++i)
+		{
+			auto a = arena.alloc<byte>(i + 1);
+			auto b = arena.alloc<Padded_Counter>(i + 1);
+			CHECK(a.ptr != nullptr);
+			CHECK(((usize)b.ptr % alignof(Padded_Counter)) == 0);
+		}
+	}
+
+	SECTION("Case 03")
+	{
+		for(auto context: {os->global_memory, os->leak_detector})
+		{
+			auto a = context->alloc<byte>(1);
+			auto b = context->alloc<Padded_Counter>(3);
+			auto c = context->alloc<byte>(100, 128);
+
+			CHECK(((usize)b.ptr % alignof(Padded_Counter)) == 0);
+			CHECK(((usize)c.ptr % 128) == 0);
+
+			context->free(c);
+			context->free(b);
+			context->free(a);
+		}
+	}
+
+	SECTION("Case 04")
+	{
+		Arena_Allocator arena;
+		Dynamic_Array<Padded_Counter> counters(arena);
+
+		for(usize i = 0; i < 100; ++i)
+			counters.insert_back(Padded_Counter{ i });
+
+		CHECK(((usize)counters.data() % alignof(Padded_Counter)) == 0);
+		for(usize i = 0; i < 100; ++i)
+			CHECK(counters[i].value == i);
+	}
+
+	SECTION("Case 05")
+	{
+		Virtual_Arena_Allocator arena(MEGABYTES(64), KILOBYTES(64), KILOBYTES(64));
+
+		CHECK(arena.reserved_memory_size() >= MEGABYTES(64));
+		CHECK(arena.committed_memory_size() == 0);
+
+		auto first = arena.alloc<byte>(1);
+		Dynamic_Array<Owner<usize>> blocks;
+		for(usize i = 0; i < 1000; ++i)
+		{
+			auto block = arena.alloc<usize>(1000);
+			REQUIRE(block.ptr != nullptr);
+			block[999] = i;
+			blocks.insert_back(std::move(block));
+		}
+
+		//the arena is contiguous
+		CHECK(blocks[0].ptr > (usize*)first.ptr);
+		CHECK(blocks[999].ptr < (usize*)(first.ptr + arena.reserved_memory_size()));
+		for(usize i = 0; i < 1000; ++i)
+			CHECK(blocks[i][999] == i);
+
+		CHECK(arena.used_memory_size() >= 1000 * 1000 * sizeof(usize));
+		CHECK(arena.committed_memory_size() >= arena.used_memory_size());
+
+		arena.reset();
+		CHECK(arena.used_memory_size() == 0);
+		CHECK(arena.committed_memory_size() <= KILOBYTES(64));
+
+		auto again = arena.alloc<byte>(1);
+		CHECK(again.ptr == first.ptr);
+
+		//can't allocate beyond the reserved range
+		auto big = arena.alloc<byte>(MEGABYTES(128));
+		CHECK(big.ptr == nullptr);
+	}
+
+	SECTION("Case 06")
+	{
+		Stack_Allocator stack(KILOBYTES(4));
+
+		stack.alloc<i32>(10);
+		auto used = stack.used_memory_size();
+		{
+			Marker_Scope<Stack_Allocator> scope(stack);
+			auto b = stack.alloc<i32>(10);
+			stack.alloc<i32>(10);
+			CHECK(stack.used_memory_size() > used);
+			//freeing out of order doesn't release the memory
+			stack.free(b);
+			CHECK(stack.used_memory_size() > used);
+		}
+		CHECK(stack.used_memory_size() == used);
+
+		auto m = stack.marker();
+		stack.alloc<byte>(100);
+		stack.rollback(m);
+		CHECK(stack.used_memory_size() == used);
+	}
+
+	SECTION("Case 07")
+	{
+		Arena_Allocator arena(KILOBYTES(1));
+
+		auto a = arena.alloc<i32>(10);
+		auto used = arena.used_memory_size();
+		auto size = arena.used_memory_size() + arena.unused_memory_size();
+		{
+			Marker_Scope<Arena_Allocator> scope(arena);
+			//forces the arena to grow multiple times
+			for(usize i = 0; i < 10; ++i)
+				arena.alloc<byte>(KILOBYTES(1));
+			CHECK(arena.used_memory_size() > used);
+		}
+		CHECK(arena.used_memory_size() == used);
+		CHECK(arena.used_memory_size() + arena.unused_memory_size() == size);
+
+		auto b = arena.alloc<i32>(10);
+		CHECK(b.ptr == a.ptr + 10);
+
+		arena.reset();
+		CHECK(arena.used_memory_size() == 0);
+		CHECK(arena.unused_memory_size() == 0);
+	}
+
+	SECTION("Case 08")
+	{
+		Virtual_Arena_Allocator arena(MEGABYTES(16));
+
+		auto a = arena.alloc<byte>(10);
+		auto used = arena.used_memory_size();
+		{
+			Marker_Scope<Virtual_Arena_Allocator> scope(arena);
+			arena.alloc<byte>(MEGABYTES(2));
+		}
+		CHECK(arena.used_memory_size() == used);
+		CHECK(arena.alloc<byte>(1).ptr == a.ptr + 10);
+	}
+
+	SECTION("Case 09")
+	{
+		auto sampling_rate = os->leak_sampling_rate;
+		os->leak_sampling_rate = 4;
+		os->reset_leak_sampling();
+
+		Dynamic_Array<std::thread> threads;
+		for(usize i = 0; i < 4; ++i)
+		{
+			threads.insert_back(std::thread([]{
+				Dynamic_Array<Owner<byte>> blocks;
+				for(usize j = 0; j < 1000; ++j)
+					blocks.insert_back(os->leak_detector->alloc<byte>(j + 1));
+				for(auto& block: blocks)
+					os->leak_detector->free(block);
+			}));
+		}
+		for(auto& thread: threads)
+			thread.join();
+
+		//the first allocation after the reset isn't sampled
+		os->reset_leak_sampling();
+		auto leak = os->leak_detector->alloc<byte>(1234);
+
+		Memory_Stream report;
+		os->print_leak_report(report);
+		#if defined(DEBUG)
+		String expected = "Leak size: 1234, call stack:\n"
+						  "call stack wasn't sampled, set leak_sampling_rate to 1 to get call stack info\n"
+						  "\n"
+						  "Leaks count: 1, Leaks size(bytes): 1234\n";
+		#else
+		String expected = "Leak size: 1234, call stack:\n"
+						  "run in debug mode to get call stack info\n"
+						  "\n"
+						  "Leaks count: 1, Leaks size(bytes): 1234\n";
+		#endif
+		CHECK(String(report.str_content()) == expected);
+
+		os->leak_detector->free(leak);
+		report.clear();
+		os->print_leak_report(report);
+		CHECK(report.empty());
+
+		//while the 4th one is
+		#if defined(DEBUG)
+		{
+			os->reset_leak_sampling();
+			Owner<byte> leaks[4];
+			for(auto& block: leaks)
+				block = os->leak_detector->alloc<byte>(16);
+
+			os->print_leak_report(report);
+			auto content = report.str_content();
+			std::string sampled_report((const char*)content.bytes.ptr, content.bytes.size);
+			usize unsampled_count = 0;
+			for(auto pos = sampled_report.find("wasn't sampled"); pos != std::string::npos;
+				pos = sampled_report.find("wasn't sampled", pos + 1))
+				++unsampled_count;
+			CHECK(unsampled_count == 3);
+			CHECK(sampled_report.find("Leaks count: 4") != std::string::npos);
+
+			for(auto& block: leaks)
+				os->leak_detector->free(block);
+			report.clear();
+		}
+		#endif
+
+		os->leak_sampling_rate = sampling_rate;
+	}
+
+	SECTION("Case 10")
+	{
+		Instrumented_Allocator instrumented(os->global_memory);
+		{
+			Dynamic_Array<usize> array(instrumented);
+			for(usize i = 0; i < 1000; ++i)
+				array.insert_back(i);
+
+			CHECK(instrumented.stats.live_size == array.capacity() * sizeof(usize));
+			CHECK(instrumented.stats.alloc_count > 1);
+			CHECK(instrumented.stats.peak_size >= instrumented.stats.live_size);
+		}
+		CHECK(instrumented.stats.live_size == 0);
+		CHECK(instrumented.stats.alloc_count == instrumented.stats.free_count);
+
+		Call_Site sites[4];
+		CHECK(instrumented.stats.top_call_sites(make_slice(sites, 4)) > 0);
+		CHECK(sites[0].size > 0);
+
+		//each allocation call is its own call site even when the allocation function isn't inlined
+		{
+			Instrumented_Allocator sites_allocator(os->global_memory);
+			auto first = sites_allocator.alloc<byte>(10);
+			auto second = sites_allocator.alloc<byte>(20);
+			CHECK(sites_allocator.stats.top_call_sites(make_slice(sites, 4)) == 2);
+			CHECK(sites[0].size == 20);
+			CHECK(sites[1].size == 10);
+			sites_allocator.free(first);
+			sites_allocator.free(second);
+		}
+
+		Memory_Stream report;
+		CHECK(vprintf(report, "{}", instrumented.stats) > 0);
+		CHECK(String(report.str_content()).count() > 0);
+
+		//the global memory stats are opt-in
+		usize alloc_count = os->global_memory_stats->alloc_count;
+		auto block = os->global_memory->alloc<byte>(1000);
+		CHECK(os->global_memory_stats->alloc_count == alloc_count);
+		os->global_memory->free(block);
+
+		os->track_global_memory_stats = true;
+		usize live_size = os->global_memory_stats->live_size;
+		block = os->global_memory->alloc<byte>(1000);
+		CHECK(os->global_memory_stats->live_size == live_size + 1000);
+		os->global_memory->free(block);
+		CHECK(os->global_memory_stats->live_size == live_size);
+		os->track_global_memory_stats = false;
+	}
+
+	SECTION("Case 11")
+	{
+		for(auto flags: {VIRTUAL_FLAGS::NONE,
+						 VIRTUAL_FLAGS::POPULATE,
+						 VIRTUAL_FLAGS::HUGE_PAGES,
+						 VIRTUAL_FLAGS::HUGE_PAGES | VIRTUAL_FLAGS::POPULATE})
+		{
+			auto memory = os->virtual_alloc(nullptr, MEGABYTES(3), flags);
+			REQUIRE(memory.ptr != nullptr);
+			CHECK(memory.size >= MEGABYTES(3));
+			if(flags & VIRTUAL_FLAGS::HUGE_PAGES)
+				CHECK(((usize)memory.ptr % os->virtual_huge_page_size()) == 0);
+
+			memory[0] = 1;
+			memory[memory.size - 1] = 2;
+			CHECK(os->virtual_advise(memory.all(), VIRTUAL_ADVICE::WILL_NEED));
+			CHECK(os->virtual_advise(memory.all(), VIRTUAL_ADVICE::DONT_NEED));
+			CHECK(os->virtual_advise(memory.all(), VIRTUAL_ADVICE::FREE));
+			memory[0] = 3;
+			CHECK(memory[0] == 3);
+			CHECK(os->virtual_free(memory));
+		}
+
+		Virtual_Arena_Allocator arena(MEGABYTES(16), MEGABYTES(2), 0, VIRTUAL_FLAGS::HUGE_PAGES | VIRTUAL_FLAGS::POPULATE);
+		CHECK(((usize)arena._memory.ptr % os->virtual_huge_page_size()) == 0);
+		auto block = arena.alloc<usize>(1000);
+		REQUIRE(block.ptr != nullptr);
+		block[999] = 999;
+		CHECK(arena.committed_memory_size() >= MEGABYTES(2));
+
+		//small commit sizes and high water marks are rounded up to whole huge pages
+		usize huge_page_size = os->virtual_huge_page_size();
+		Virtual_Arena_Allocator huge_arena(MEGABYTES(16), KILOBYTES(64), KILOBYTES(64), VIRTUAL_FLAGS::HUGE_PAGES);
+		CHECK(huge_arena.alloc<byte>(KILOBYTES(4)).ptr != nullptr);
+		CHECK(huge_arena.committed_memory_size() == huge_page_size);
+		CHECK(huge_arena.alloc<byte>(huge_page_size).ptr != nullptr);
+		CHECK(huge_arena.committed_memory_size() % huge_page_size == 0);
+		CHECK(huge_arena.committed_memory_size() == 2 * huge_page_size);
+		huge_arena.reset();
+		CHECK(huge_arena.committed_memory_size() == huge_page_size);
+	}
+
+	SECTION("Case 12")
+	{
+		TLSF_Allocator tlsf(MEGABYTES(1));
+
+		usize free_size = tlsf.unused_memory_size();
+		CHECK(tlsf.used_memory_size() == 0);
+		CHECK(tlsf.largest_free_block_size() == free_size);
+		CHECK(tlsf.fragmentation() == 0);
+
+		std::mt19937 gen(1234);
+		std::uniform_int_distribution<usize> size_dist(1, 2000);
+		Dynamic_Array<Owner<byte>> blocks;
+		for(usize i = 0; i < 10000; ++i)
+		{
+			if(blocks.count() > 0 && gen() % 3 == 0)
+			{
+				usize index = gen() % blocks.count();
+				std::swap(blocks[index], blocks[blocks.count() - 1]);
+				tlsf.free(blocks[blocks.count() - 1]);
+				blocks.remove_back();
+			}
+			else
+			{
+				usize size = size_dist(gen);
+				usize alignment = usize(1) << (gen() % 8);
+				auto block = tlsf.alloc<byte>(size, alignment);
+				if(block.ptr == nullptr)
+					continue;
+				CHECK(((usize)block.ptr % alignment) == 0);
+				::memset(block.ptr, (int)(i & 0xFF), size);
+				blocks.insert_back(std::move(block));
+			}
+		}
+		CHECK(tlsf.used_memory_size() > 0);
+		CHECK(tlsf.fragmentation() >= 0);
+		CHECK(tlsf.fragmentation() < 1);
+
+		for(auto& block: blocks)
+			tlsf.free(block);
+
+		//everything coalesces back into a single free block
+		CHECK(tlsf.used_memory_size() == 0);
+		CHECK(tlsf.unused_memory_size() == free_size);
+		CHECK(tlsf.largest_free_block_size() == free_size);
+		CHECK(tlsf.fragmentation() == 0);
+
+		//exhaust the pool
+		auto big = tlsf.alloc<byte>(free_size / 2);
+		CHECK(big.ptr != nullptr);
+		CHECK(tlsf.alloc<byte>(free_size).ptr == nullptr);
+		tlsf.free(big);
+
+		Dynamic_Array<usize> array(tlsf);
+		for(usize i = 0; i < 1000; ++i)
+			array.insert_back(i);
+		for(usize i = 0; i < 1000; ++i)
+			CHECK(array[i] == i);
+	}
+
+	SECTION("Case 13")
+	{
+		Concurrent_Arena_Allocator arena(KILOBYTES(4));
+
+		Loom loom;
+		u32 workers_count = 4, max_tasks = 64;
+		usize required_size = loom.init(Owner<byte>(), workers_count, max_tasks, 16, KILOBYTES(32));
+		loom.init(alloc<byte>(required_size), workers_count, max_tasks, 16, KILOBYTES(32));
+
+		constexpr usize BLOCKS_COUNT = 1000;
+		Dynamic_Array<Owner<usize>> blocks;
+		blocks.expand_back(max_tasks * BLOCKS_COUNT);
+		Dynamic_Array<Concurrent_Arena_Job> jobs;
+		for(usize i = 0; i < max_tasks; ++i)
+			jobs.insert_back(Concurrent_Arena_Job{ &arena, blocks.range(i * BLOCKS_COUNT, (i + 1) * BLOCKS_COUNT), i });
+
+		for(auto& job: jobs)
+			loom.task_push(concurrent_arena_task, &job);
+		loom.wait_until_finished();
+		loom.dispose();
+		free(loom.memory);
+
+		//no two tasks got overlapping memory
+		usize mismatch_count = 0;
+		for(usize i = 0; i < blocks.count(); ++i)
+		{
+			auto& block = blocks[i];
+			if(block.ptr == nullptr)
+			{
+				++mismatch_count;
+				continue;
+			}
+			if(((i % BLOCKS_COUNT) % 3) == 0 && ((usize)block.ptr % 64) != 0)
+				++mismatch_count;
+			for(usize j = 0; j < block.count(); ++j)
+				if(block[j] != i / BLOCKS_COUNT)
+					++mismatch_count;
+		}
+		CHECK(mismatch_count == 0);
+		CHECK(arena.used_memory_size() >= max_tasks * BLOCKS_COUNT * sizeof(usize));
+		CHECK(arena.used_memory_size() + arena.unused_memory_size() >= arena.used_memory_size());
+
+		arena.free_all();
+		CHECK(arena.used_memory_size() == 0);
+		CHECK(arena.unused_memory_size() > 0);
+		auto block = arena.alloc<usize>(4);
+		REQUIRE(block.ptr != nullptr);
+
+		arena.reset();
+		CHECK(arena.used_memory_size() == 0);
+		CHECK(arena.unused_memory_size() == 0);
+
+		//the sizes come from the blocks cursors
+		arena.alloc<byte>(10);
+		arena.alloc<byte>(16);
+		CHECK(arena.used_memory_size() == 32);
+		CHECK(arena.unused_memory_size() == KILOBYTES(4) - 32);
+		arena.alloc<byte>(KILOBYTES(4));
+		CHECK(arena.used_memory_size() == KILOBYTES(8));
+		CHECK(arena.unused_memory_size() == 0);
+	}
+}
@@ -0,0 +1,174 @@
+#include "catch.hpp"
+#include <cpprelude/B_Tree_Map.h>
+#include <cpprelude/String.h>
+#include <map>
+#include <random>
+#include <string>
+
+using namespace cppr;
+
+TEST_CASE("B_Tree_Map", "[B_Tree_Map]")
+{
+	SECTION("Case 01")
+	{
+		B_Tree_Map<usize, usize> map;
+		CHECK(map.empty());
+		CHECK(map._is_b_tree());
+		CHECK(map.begin() == map.end());
+		CHECK(map.lookup(1) == map.end());
+		CHECK(map.max() == map.end());
+		map.remove(1);
+
+		map[5] = 50;
+		map.insert(3, 30);
+		map.insert(7, 70);
+		CHECK(map.insert(5, 42)->value == 50);
+		CHECK(map.count() == 3);
+		CHECK(map._is_b_tree());
+		CHECK(map.min()->key == 3);
+		CHECK(map.max()->key == 7);
+
+		map.remove(3);
+		map.remove(5);
+		map.remove(7);
+		CHECK(map.empty());
+		CHECK(map._is_b_tree());
+	}
+
+	SECTION("Case 02")
+	{
+		//ascending then descending inserts split the nodes at both ends
+		B_Tree_Map<usize, usize> map;
+		for(usize i = 0; i < 5000; ++i)
+			map.insert(i, i);
+		for(usize i = 10000; i > 5000; --i)
+			map.insert(i, i);
+		CHECK(map._is_b_tree());
+		CHECK(map._height > 1);
+
+		usize expected = 0, mismatch_count = 0;
+		for(const auto& pair: map)
+		{
+			if(expected == 5000)
+				++expected;
+			mismatch_count += pair.key != expected || pair.value != expected;
+			++expected;
+		}
+		CHECK(mismatch_count == 0);
+		CHECK(expected == 10001);
+
+		//walk back from the max
+		auto it = map.max();
+		for(usize i = 10000; i > 5000; --i, --it)
+			mismatch_count += it->key != i;
+		CHECK(mismatch_count == 0);
+
+		auto range = map.range(100, 200);
+		CHECK(range.count() == 100);
+		CHECK(range.front().key == 100);
+		usize sum = 0;
+		for(const auto& pair: range)
+			sum += pair.key;
+		CHECK(sum == (100 + 199) * 100 / 2);
+
+		for(usize i = 0; i < 10001; i += 2)
+			map.remove(i);
+		CHECK(map._is_b_tree());
+		CHECK(map.count() == 5000);
+		for(usize i = 1; i < 10001; i += 2)
+			mismatch_count += map.lookup(i) == map.end() || map.lookup(i - 1) != map.end();
+		CHECK(mismatch_count == 0);
+
+		for(usize i = 1; i < 10001; i += 2)
+			map.remove(map.lookup(i));
+		CHECK(map.empty());
+		CHECK(map._is_b_tree());
+	}
+
+	SECTION("Case 03")
+	{
+		//random churn against a reference map
+		B_Tree_Map<u32, usize> map;
+		std::map<u32, usize> reference;
+		std::mt19937 generator(42);
+
+		usize mismatch_count = 0;
+		for(usize i = 0; i < 100000; ++i)
+		{
+			u32 key = generator() % 4096;
+			if(generator() % 2 == 0)
+			{
+				map.remove(key);
+				reference.erase(key);
+			}
+			else
+			{
+				map[key] = i;
+				reference[key] = i;
+			}
+
+			if(i % 10000 == 0)
+				mismatch_count += !map._is_b_tree();
+		}
+		CHECK(mismatch_count == 0);
+		CHECK(map._is_b_tree());
+		CHECK(map.count() == reference.size());
+
+		auto reference_it = reference.begin();
+		for(const auto& pair: map)
+		{
+			mismatch_count += pair.key != reference_it->first || pair.value != reference_it->second;
+			++reference_it;
+		}
+		CHECK(mismatch_count == 0);
+
+		const auto copy = map;
+		CHECK(copy._is_b_tree());
+		auto moved = std::move(map);
+		CHECK(map.empty());
+		for(const auto& pair: reference)
+		{
+			mismatch_count += copy.lookup(pair.first)->value != pair.second;
+			mismatch_count += moved.lookup(pair.first)->value != pair.second;
+		}
+		CHECK(mismatch_count == 0);
+		CHECK(copy.all().count() == reference.size());
+
+		map = copy;
+		map.clear();
+		CHECK(map.empty());
+		CHECK(map._is_b_tree());
+	}
+
+	SECTION("Case 04")
+	{
+		B_Tree_Map<String, usize> map;
+		std::map<std::string, usize> reference;
+		for(usize i = 0; i < 2000; ++i)
+		{
+			std::string key = "key." + std::to_string(i * 7 % 2000);
+			map.insert(String(key.c_str()), i);
+			reference.emplace(key, i);
+		}
+		CHECK(map._is_b_tree());
+
+		usize mismatch_count = 0;
+		auto reference_it = reference.begin();
+		for(const auto& pair: map)
+		{
+			mismatch_count += pair.key != reference_it->first.c_str() || pair.value != reference_it->second;
+			++reference_it;
+		}
+		CHECK(mismatch_count == 0);
+
+		for(usize i = 0; i < 2000; i += 3)
+			map.remove(String(("key." + std::to_string(i)).c_str()));
+		CHECK(map._is_b_tree());
+		CHECK(map.lookup("key.3") == map.end());
+		CHECK(map.lookup("key.4") != map.end());
+
+		B_Tree_Map<String, usize> copy = map;
+		CHECK(copy.count() == map.count());
+		CHECK(copy.min()->key == map.min()->key);
+	}
+}
@@ -0,0 +1,146 @@
+#include "catch.hpp"
+#include <cpprelude/Concurrent_Hash_Map.h>
+#include <cpprelude/Dynamic_Array.h>
+#include <cpprelude/Loom.h>
+
+using namespace cppr;
+
+struct Concurrent_Hash_Map_Job
+{
+	Concurrent_Hash_Map<usize, usize>* map;
+	usize id;
+	usize keys_count;
+	usize mismatch_count;
+};
+
+Executer*
+concurrent_hash_map_task(Executer* exe, Task::Arg arg)
+{
+	auto job = (Concurrent_Hash_Map_Job*)arg;
+	usize start = job->id * job->keys_count;
+	for(usize i = start; i < start + job->keys_count; ++i)
+	{
+		job->map->insert(i, i * 2);
+
+		//the key we just inserted must be visible to us and the keys of the other tasks are either missing or complete
+		usize value = 0;
+		if(!job->map->lookup(i, value) || value != i * 2)
+			++job->mismatch_count;
+
+		usize other_key = (i * 7919) % (job->keys_count * 16);
+		if(job->map->lookup(other_key, value) && value != other_key * 2)
+			++job->mismatch_count;
+
+		if(i % 4 == 0)
+			job->map->remove(i);
+	}
+	return exe;
+}
+
+TEST_CASE("Concurrent_Hash_Map", "[Concurrent_Hash_Map]")
+{
+	SECTION("Case 01")
+	{
+		Concurrent_Hash_Map<usize, usize> map(3);
+
+		CHECK(map.shards_count() == 16);
+		CHECK(map.empty());
+
+		CHECK(map.insert(1, 10));
+		CHECK(map.insert(1, 20) == false);
+		CHECK(map.insert(2, 20));
+
+		usize value = 0;
+		CHECK(map.lookup(1, value));
+		CHECK(value == 10);
+		CHECK(map.lookup(3, value) == false);
+
+		map.insert_or_assign(1, 30);
+		map.insert_or_assign(3, 40);
+		CHECK(map.lookup(1, value));
+		CHECK(value == 30);
+		CHECK(map.contains(3));
+		CHECK(map.count() == 3);
+
+		CHECK(map.remove(2));
+		CHECK(map.remove(2) == false);
+		CHECK(map.contains(2) == false);
+		CHECK(map.count() == 2);
+
+		map.clear();
+		CHECK(map.empty());
+	}
+
+	SECTION("Case 02")
+	{
+		Concurrent_Hash_Map<usize, usize> map(4);
+
+		Dynamic_Array<usize> keys, values;
+		for(usize i = 0; i < 1000; ++i)
+		{
+			keys.insert_back(i % 800);
+			values.insert_back(i);
+		}
+
+		CHECK(map.insert_batch(keys.all().convert<const usize>(), values.all().convert<const usize>()) == 800);
+		CHECK(map.count() == 800);
+
+		Dynamic_Array<usize> lookup_keys, lookup_values;
+		Dynamic_Array<bool> found;
+		for(usize i = 0; i < 1000; ++i)
+		{
+			lookup_keys.insert_back(i);
+			lookup_values.insert_back(0);
+			found.insert_back(false);
+		}
+
+		CHECK(map.lookup_batch(lookup_keys.all().convert<const usize>(), lookup_values.all(), found.all()) == 800);
+
+		usize mismatch_count = 0;
+		for(usize i = 0; i < 1000; ++i)
+		{
+			if(i < 800)
+				mismatch_count += found[i] == false || lookup_values[i] != i;
+			else
+				mismatch_count += found[i];
+		}
+		CHECK(mismatch_count == 0);
+	}
+
+	SECTION("Case 03")
+	{
+		Loom loom;
+		u32 workers_count = 4, max_tasks = 16;
+		usize required_size = loom.init(Owner<byte>(), workers_count, max_tasks, 16, KILOBYTES(32));
+		loom.init(alloc<byte>(required_size), workers_count, max_tasks, 16, KILOBYTES(32));
+
+		Concurrent_Hash_Map<usize, usize> map(workers_count);
+
+		constexpr usize KEYS_COUNT = 2000;
+		Dynamic_Array<Concurrent_Hash_Map_Job> jobs;
+		for(usize i = 0; i < max_tasks; ++i)
+			jobs.insert_back(Concurrent_Hash_Map_Job{ &map, i, KEYS_COUNT, 0 });
+
+		for(auto& job: jobs)
+			loom.task_push(concurrent_hash_map_task, &job);
+		loom.wait_until_finished();
+		loom.dispose();
+		free(loom.memory);
+
+		usize mismatch_count = 0;
+		for(const auto& job: jobs)
+			mismatch_count += job.mismatch_count;
+
+		for(usize i = 0; i < max_tasks * KEYS_COUNT; ++i)
+		{
+			usize value = 0;
+			bool found = map.lookup(i, value);
+			if(i % 4 == 0)
+				mismatch_count += found;
+			else
+				mismatch_count += !found || value != i * 2;
+		}
+		CHECK(mismatch_count == 0);
+		CHECK(map.count() == max_tasks * KEYS_COUNT / 4 * 3);
+	}
+}
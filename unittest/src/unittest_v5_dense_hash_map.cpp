@@ -0,0 +1,204 @@
+#include "catch.hpp"
+#include <cpprelude/Dense_Hash_Map.h>
+#include <cpprelude/String.h>
+#include <cpprelude/Allocators.h>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <string>
+
+using namespace cppr;
+
+TEST_CASE("Dense_Hash_Map", "[Dense_Hash_Map]")
+{
+	SECTION("Case 01")
+	{
+		Dense_Hash_Map<usize, usize> map;
+
+		CHECK(map.count() == 0);
+		CHECK(map.empty());
+		CHECK(map.capacity() == 0);
+		CHECK(map.lookup(1) == map.end());
+		CHECK(map.remove(1) == false);
+
+		for(usize i = 0; i < 100; ++i)
+			map.insert(100 - i, i);
+
+		CHECK(map.count() == 100);
+		CHECK(map.capacity() == 256);
+		CHECK(map.insert(100, 42)->value == 0);
+		CHECK(map.count() == 100);
+
+		//the pairs are iterated in their insertion order
+		usize i = 0;
+		for(const auto& pair: map)
+		{
+			CHECK(pair.key == 100 - i);
+			CHECK(pair.value == i);
+			++i;
+		}
+		CHECK(i == 100);
+		CHECK(map.front().key == 100);
+		CHECK(map.back().key == 1);
+
+		map[200] = 7;
+		map[100] += 5;
+		CHECK(map.back().key == 200);
+		CHECK(map.lookup(200)->value == 7);
+		CHECK(map.lookup(100)->value == 5);
+		CHECK(map.contains(50));
+		CHECK(map.contains(0) == false);
+
+		map.clear();
+		CHECK(map.empty());
+		CHECK(map.capacity() == 256);
+		CHECK(map.contains(50) == false);
+	}
+
+	SECTION("Case 02")
+	{
+		Dense_Hash_Map<usize, usize> map;
+		for(usize i = 0; i < 10; ++i)
+			map.insert(i, i * 10);
+
+		//ordered removal keeps the order of the rest
+		CHECK(map.remove(3));
+		CHECK(map.remove(3) == false);
+		CHECK(map.remove(map.lookup(0)));
+		CHECK(map.remove(map.end()) == false);
+
+		usize expected_ordered[] = {1, 2, 4, 5, 6, 7, 8, 9};
+		CHECK(map.count() == 8);
+		for(usize i = 0; i < map.count(); ++i)
+		{
+			CHECK(map.all()[i].key == expected_ordered[i]);
+			CHECK(map.lookup(expected_ordered[i]) == map.begin() + i);
+		}
+
+		//unordered removal moves the last pair into the removed place
+		CHECK(map.remove_unordered(2));
+		usize expected_unordered[] = {1, 9, 4, 5, 6, 7, 8};
+		CHECK(map.count() == 7);
+		for(usize i = 0; i < map.count(); ++i)
+		{
+			CHECK(map.all()[i].key == expected_unordered[i]);
+			CHECK(map.lookup(expected_unordered[i])->value == expected_unordered[i] * 10);
+		}
+
+		map.insert_or_assign(4, 44);
+		map.insert_or_assign(10, 100);
+		CHECK(map.all()[2].value == 44);
+		CHECK(map.back().key == 10);
+	}
+
+	SECTION("Case 03")
+	{
+		//random churn against a reference map and a reference order
+		Dense_Hash_Map<usize, usize> map;
+		std::unordered_map<usize, usize> reference;
+		std::vector<usize> order;
+		std::mt19937_64 generator(42);
+
+		usize mismatch_count = 0;
+		for(usize i = 0; i < 20000; ++i)
+		{
+			usize key = generator() % 1000;
+			usize op = generator() % 4;
+			if(op == 0)
+			{
+				bool removed = map.remove(key);
+				mismatch_count += removed != (reference.erase(key) == 1);
+				if(removed)
+					order.erase(std::find(order.begin(), order.end(), key));
+			}
+			else if(op == 1)
+			{
+				bool removed = map.remove_unordered(key);
+				mismatch_count += removed != (reference.erase(key) == 1);
+				if(removed)
+				{
+					auto it = std::find(order.begin(), order.end(), key);
+					*it = order.back();
+					order.pop_back();
+				}
+			}
+			else
+			{
+				if(reference.count(key) == 0)
+					order.push_back(key);
+				map.insert_or_assign(key, i);
+				reference[key] = i;
+			}
+		}
+
+		CHECK(map.count() == reference.size());
+		CHECK(map.count() == order.size());
+		for(usize i = 0; i < order.size(); ++i)
+		{
+			mismatch_count += map.all()[i].key != order[i];
+			mismatch_count += map.all()[i].value != reference[order[i]];
+			mismatch_count += map.lookup(order[i]) != map.begin() + i;
+		}
+		CHECK(mismatch_count == 0);
+
+		auto copy = map;
+		map.shrink_to_fit();
+		CHECK(map.capacity() == internal::_hash_capacity_for(map.count(), internal::HASH_DEFAULT_MAX_LOAD_FACTOR));
+		for(usize i = 0; i < order.size(); ++i)
+		{
+			mismatch_count += map.lookup(order[i]) != map.begin() + i;
+			mismatch_count += copy.lookup(order[i])->value != reference[order[i]];
+		}
+		CHECK(mismatch_count == 0);
+
+		auto moved = std::move(copy);
+		CHECK(moved.count() == order.size());
+		CHECK(copy.count() == 0);
+	}
+
+	SECTION("Case 04")
+	{
+		Dense_Hash_Map<String, String> map;
+		map.insert("Mostafa", "first");
+		map.try_emplace(String("Moka"), "second");
+		map.insert_or_assign("Koko", String("third"));
+		map["Mostafa"] = "changed";
+
+		CHECK(map.count() == 3);
+		CHECK(map.lookup(make_strrng("Moka"))->value == "second");
+		CHECK(map.lookup("Koko")->value == "third");
+		CHECK(map.all()[0].value == "changed");
+
+		CHECK(map.remove("Mostafa"));
+		CHECK(map.front().key == "Moka");
+		CHECK(map.back().key == "Koko");
+		CHECK(map.lookup(make_strrng("Mostafa")) == map.end());
+	}
+
+	SECTION("Case 05")
+	{
+		//the String keys are moved not copied when the entries grow or shift so none of them leaks
+		Instrumented_Allocator instrumented;
+		{
+			Dense_Hash_Map<String, usize> map(instrumented);
+			for(usize i = 0; i < 1000; ++i)
+				map.insert(String(("key." + std::to_string(i)).c_str(), instrumented), i);
+			CHECK(map.count() == 1000);
+
+			usize alloc_count = instrumented.stats.alloc_count;
+			CHECK(map.remove(String("key.0", instrumented)));
+			CHECK(map.remove_unordered(String("key.1", instrumented)));
+			//only the two temporary keys are allocated
+			CHECK(instrumented.stats.alloc_count == alloc_count + 2);
+			CHECK(map.front().key == "key.999");
+			CHECK(map.back().key == "key.998");
+
+			auto copy = map;
+			copy.shrink_to_fit();
+			CHECK(copy.lookup("key.500")->value == 500);
+		}
+		CHECK(instrumented.stats.live_size == 0);
+		CHECK(instrumented.stats.alloc_count == instrumented.stats.free_count);
+	}
+}
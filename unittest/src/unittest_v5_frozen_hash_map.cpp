@@ -0,0 +1,151 @@
+#include "catch.hpp"
+#include <cpprelude/Frozen_Hash_Map.h>
+#include <cpprelude/Dense_Hash_Map.h>
+#include <cpprelude/String.h>
+#include <cpprelude/Allocators.h>
+#include <cstdio>
+#include <string>
+
+using namespace cppr;
+
+TEST_CASE("Frozen_Hash_Map", "[Frozen_Hash_Map]")
+{
+	SECTION("Case 01")
+	{
+		Frozen_Hash_Map<usize, usize> map;
+		CHECK(map.empty());
+		CHECK(map.lookup(1) == map.end());
+		CHECK(map.contains(1) == false);
+
+		map.build(Hash_Map<usize, usize>());
+		CHECK(map.empty());
+
+		Hash_Map<usize, usize> source;
+		source.insert(42, 24);
+		map.build(source);
+		CHECK(map.count() == 1);
+		CHECK(map.lookup(42)->value == 24);
+		CHECK(map.contains(24) == false);
+	}
+
+	SECTION("Case 02")
+	{
+		Hash_Map<usize, usize> source;
+		for(usize i = 0; i < 50000; ++i)
+			source.insert(i * 7919, i);
+
+		Frozen_Hash_Map<usize, usize> map;
+		map.build(source);
+
+		//minimal, every slot holds a key
+		CHECK(map.count() == source.count());
+		CHECK(map.buckets_count() == source.count() / internal::FROZEN_HASH_BUCKET_SIZE + 1);
+
+		usize mismatch_count = 0;
+		for(usize i = 0; i < 50000; ++i)
+		{
+			auto it = map.lookup(i * 7919);
+			mismatch_count += it == map.end() || it->key != i * 7919 || it->value != i;
+			mismatch_count += map.contains(i * 7919 + 1);
+		}
+		CHECK(mismatch_count == 0);
+
+		usize sum = 0;
+		for(const auto& pair: map)
+			sum += pair.value;
+		CHECK(sum == 50000ULL * 49999 / 2);
+
+		auto copy = map;
+		auto moved = std::move(map);
+		CHECK(map.empty());
+		CHECK(copy.lookup(7919 * 100)->value == 100);
+		CHECK(moved.lookup(7919 * 200)->value == 200);
+	}
+
+	SECTION("Case 03")
+	{
+		Dynamic_Array<usize> keys, values;
+		for(usize i = 0; i < 1000; ++i)
+		{
+			keys.insert_back(i % 300);
+			values.insert_back(i);
+		}
+
+		//repeated keys keep their first value
+		Frozen_Hash_Map<usize, usize> map;
+		map.build(keys.all().convert<const usize>(), values.all().convert<const usize>());
+		CHECK(map.count() == 300);
+
+		usize mismatch_count = 0;
+		for(usize i = 0; i < 300; ++i)
+			mismatch_count += map.lookup(i)->value != i;
+		CHECK(mismatch_count == 0);
+
+		const char* file_name = "frozen_hash_map_image.bin";
+		{
+			File file = unwrap(File::open(file_name, IO_MODE::WRITE, OPEN_MODE::CREATE_OVERWRITE));
+			CHECK(map.save(file));
+			File::close(file);
+		}
+
+		Frozen_Hash_Map<usize, usize> loaded;
+		{
+			File file = unwrap(File::open(file_name, IO_MODE::READ, OPEN_MODE::OPEN_ONLY));
+			CHECK(loaded.load(file));
+			//nothing is left to read so it's an invalid image
+			Frozen_Hash_Map<usize, usize> truncated;
+			CHECK(truncated.load(file) == false);
+			CHECK(truncated.empty());
+			File::close(file);
+		}
+		std::remove(file_name);
+
+		CHECK(loaded.count() == 300);
+		CHECK(loaded.buckets_count() == map.buckets_count());
+		for(usize i = 0; i < 300; ++i)
+		{
+			mismatch_count += loaded.lookup(i)->value != i;
+			mismatch_count += loaded.lookup(i) - loaded.begin() != map.lookup(i) - map.begin();
+		}
+		mismatch_count += loaded.contains(300);
+		CHECK(mismatch_count == 0);
+	}
+
+	SECTION("Case 04")
+	{
+		Dense_Hash_Map<String, usize> source;
+		for(usize i = 0; i < 1000; ++i)
+		{
+			String key = "config.key.";
+			key.concat(std::to_string(i).c_str());
+			source.insert(key, i);
+		}
+
+		Frozen_Hash_Map<String, usize> map;
+		map.build(source);
+		CHECK(map.count() == 1000);
+		CHECK(map.lookup("config.key.42")->value == 42);
+		CHECK(map.lookup(make_strrng("config.key.999"))->value == 999);
+		CHECK(map.lookup(make_strrng("config.key.1000")) == map.end());
+		CHECK(map.contains("config.key") == false);
+	}
+
+	SECTION("Case 05")
+	{
+		//the String keys are moved into their slots and none of them leaks
+		Instrumented_Allocator instrumented;
+		{
+			Hash_Map<String, usize> source(instrumented);
+			for(usize i = 0; i < 1000; ++i)
+				source.insert(String(("key." + std::to_string(i)).c_str(), instrumented), i);
+
+			Frozen_Hash_Map<String, usize> map(instrumented);
+			map.build(source);
+			CHECK(map.count() == 1000);
+			CHECK(map.lookup("key.7")->value == 7);
+			CHECK(map.lookup(make_strrng("key.999"))->value == 999);
+		}
+		CHECK(instrumented.stats.live_size == 0);
+		CHECK(instrumented.stats.alloc_count == instrumented.stats.free_count);
+	}
+}
@@ -0,0 +1,133 @@
+#include "catch.hpp"
+#include <cpprelude/Hash.h>
+#include <cpprelude/String.h>
+#include <cpprelude/Hash_Map.h>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <string>
+#include <cstring>
+#include <cmath>
+
+using namespace cppr;
+
+//counts how often each output bit flips when each input bit is flipped, an ideal hash flips each output
+//bit half of the time, returns the worst bias of an input-output bit pair away from the half
+static r64
+hash_avalanche_worst_bias(HASH_ALGORITHM algorithm, usize len, usize samples)
+{
+	std::mt19937_64 generator(len);
+	std::vector<byte> data(len);
+	std::vector<usize> flips(len * 8 * 64, 0);
+
+	for(usize s = 0; s < samples; ++s)
+	{
+		for(auto& b: data)
+			b = static_cast<byte>(generator());
+
+		u64 hash_value = hash_bytes(data.data(), len, algorithm);
+		for(usize bit = 0; bit < len * 8; ++bit)
+		{
+			data[bit / 8] ^= static_cast<byte>(1 << (bit % 8));
+			u64 diff = hash_value ^ hash_bytes(data.data(), len, algorithm);
+			data[bit / 8] ^= static_cast<byte>(1 << (bit % 8));
+
+			for(usize out = 0; out < 64; ++out)
+				flips[bit * 64 + out] += (diff >> out) & 1;
+		}
+	}
+
+	r64 worst_bias = 0;
+	for(auto flip_count: flips)
+		worst_bias = std::max(worst_bias, std::abs(r64(flip_count) / samples - 0.5));
+	return worst_bias;
+}
+
+TEST_CASE("Hash", "[Hash]")
+{
+	SECTION("Case 01")
+	{
+		const char* text = "The quick brown fox jumps over the lazy dog, the quick brown fox jumps over the lazy dog again";
+		usize len = std::strlen(text);
+
+		//same bytes hash the same regardless of their alignment
+		std::vector<byte> buffer(len + 8);
+		for(usize offset = 0; offset < 8; ++offset)
+		{
+			std::memcpy(buffer.data() + offset, text, len);
+			CHECK(wyhash(buffer.data() + offset, len) == wyhash(text, len));
+		}
+
+		CHECK(wyhash(text, len, 1) != wyhash(text, len, 2));
+
+		//every prefix length goes through a different path of the function, none of them should collide
+		std::vector<usize> prefixes;
+		for(usize i = 0; i <= len; ++i)
+			prefixes.push_back(wyhash(text, i));
+		std::sort(prefixes.begin(), prefixes.end());
+		CHECK(std::adjacent_find(prefixes.begin(), prefixes.end()) == prefixes.end());
+	}
+
+	SECTION("Case 02")
+	{
+		for(usize len: {4, 8, 16, 24, 64, 100})
+		{
+			CHECK(hash_avalanche_worst_bias(HASH_ALGORITHM::WYHASH, len, 2000) < 0.05);
+		}
+	}
+
+	SECTION("Case 03")
+	{
+		for(auto algorithm: {HASH_ALGORITHM::MURMUR, HASH_ALGORITHM::WYHASH})
+		{
+			constexpr usize KEYS_COUNT = 1 << 18;
+			constexpr usize BUCKETS_COUNT = 1 << 12;
+
+			std::vector<usize> hashes;
+			std::vector<usize> buckets(BUCKETS_COUNT, 0);
+			for(u64 i = 0; i < KEYS_COUNT; ++i)
+			{
+				usize hash_value = hash_bytes(&i, sizeof(i), algorithm);
+				hashes.push_back(hash_value);
+				++buckets[hash_value & (BUCKETS_COUNT - 1)];
+			}
+
+			std::sort(hashes.begin(), hashes.end());
+			CHECK(std::adjacent_find(hashes.begin(), hashes.end()) == hashes.end());
+
+			//the low bits of sequential integers should spread evenly, 64 keys per bucket in average
+			auto minmax = std::minmax_element(buckets.begin(), buckets.end());
+			CHECK(*minmax.first > 25);
+			CHECK(*minmax.second < 110);
+		}
+	}
+
+	SECTION("Case 04")
+	{
+		String str = "cpprelude hash";
+		String_Range range = str.all();
+
+		CHECK(Hash<String>()(str) == wyhash(range.data(), range.size()));
+		CHECK(Hash<String>(HASH_ALGORITHM::MURMUR)(str) == murmur_hash(range.data(), range.size()));
+		CHECK(Hash<String>(HASH_ALGORITHM::MURMUR)(range) == Hash<String_Range>(HASH_ALGORITHM::MURMUR)(range));
+		CHECK(Hash<String>(HASH_ALGORITHM::MURMUR)("cpprelude hash") == Hash<String>(HASH_ALGORITHM::MURMUR)(str));
+
+		Hash_Set<String> set(Hash<String>(HASH_ALGORITHM::MURMUR));
+		Hash_Map<String, usize> map(internal::Pair_Hash_Functor<String, usize>(HASH_ALGORITHM::MURMUR));
+		for(usize i = 0; i < 100; ++i)
+		{
+			String key = "key";
+			key.concat(std::to_string(i).c_str());
+			set.insert(key);
+			map.insert(key, i);
+		}
+
+		CHECK(set._hasher.algorithm == HASH_ALGORITHM::MURMUR);
+		CHECK(map._hasher.algorithm == HASH_ALGORITHM::MURMUR);
+		CHECK(set.count() == 100);
+		CHECK(map.count() == 100);
+		CHECK(set.contains("key42"));
+		CHECK(map.lookup(make_strrng("key99")) != map.end());
+		CHECK(map.lookup(make_strrng("key99"))->value == 99);
+	}
+}
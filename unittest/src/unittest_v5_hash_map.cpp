@@ -1,9 +1,96 @@
 #include "catch.hpp"
 #include <cpprelude/Hash_Map.h>
 #include <cpprelude/String.h>
+#include <cpprelude/Allocators.h>
+#include <unordered_map>
+#include <random>
+#include <cstdio>
 
 using namespace cppr;
 
+struct Counted_Value
+{
+	static usize construct_count;
+	static usize assign_count;
+
+	usize value;
+
+	Counted_Value(usize v = 0)
+		:value(v)
+	{
+		++construct_count;
+	}
+
+	Counted_Value(usize a, usize b)
+		:value(a + b)
+	{
+		++construct_count;
+	}
+
+	Counted_Value(const Counted_Value& other)
+		:value(other.value)
+	{
+		++construct_count;
+	}
+
+	Counted_Value&
+	operator=(const Counted_Value& other)
+	{
+		value = other.value;
+		++assign_count;
+		return *this;
+	}
+};
+
+usize Counted_Value::construct_count = 0;
+usize Counted_Value::assign_count = 0;
+
+struct Constant_Hash
+{
+	inline usize
+	operator()(usize) const
+	{
+		return 42;
+	}
+};
+
+//a key which isn't trivially copyable so the hash containers cache its hash by default
+struct Counted_Key
+{
+	static usize hash_count;
+	static usize compare_count;
+
+	usize id;
+
+	Counted_Key(usize v = 0)
+		:id(v)
+	{}
+
+	Counted_Key(const Counted_Key& other)
+		:id(other.id)
+	{}
+
+	bool
+	operator==(const Counted_Key& other) const
+	{
+		++compare_count;
+		return id == other.id;
+	}
+};
+
+usize Counted_Key::hash_count = 0;
+usize Counted_Key::compare_count = 0;
+
+struct Counted_Key_Hash
+{
+	inline usize
+	operator()(const Counted_Key& key) const
+	{
+		++Counted_Key::hash_count;
+		return wyhash(&key.id, sizeof(key.id));
+	}
+};
+
 TEST_CASE("Hash_Map", "[Hash_Map]")
 {
 	SECTION("Case 01")
@@ -54,6 +141,8 @@ TEST_CASE("Hash_Map", "[Hash_Map]")
 		CHECK(map.count() == 64);
 		CHECK(map.empty() == false);
 		CHECK(map.capacity() >= 64);
+		//capacities are kept at powers of two
+		CHECK((map.capacity() & (map.capacity() - 1)) == 0);
 	}
 
 	SECTION("Case 05")
@@ -220,12 +309,15 @@ TEST_CASE("Hash_Map", "[Hash_Map]")
 			if(i % 2 == 0)
 				map.remove(i);
 
-		usize i = 1;
+		usize key_sum = 0, iterated_count = 0;
 		for(const auto& num: map)
 		{
-			CHECK(num.key == i);
-			i += 2;
+			CHECK(num.key % 2 == 1);
+			key_sum += num.key;
+			++iterated_count;
 		}
+		CHECK(iterated_count == 32);
+		CHECK(key_sum == 32 * 32);
 	}
 
 	SECTION("Case 15")
@@ -270,4 +362,496 @@ TEST_CASE("Hash_Map", "[Hash_Map]")
 		CHECK(map[&b] == 1);
 		CHECK(map.lookup(&c) == map.end());
 	}
-}
\ No newline at end of file
+
+	SECTION("Case 17")
+	{
+		Hash_Map<usize, usize> map;
+		std::unordered_map<usize, usize> expected;
+
+		std::mt19937 gen(1234);
+		for(usize i = 0; i < 20000; ++i)
+		{
+			usize key = gen() % 1000;
+			if(gen() % 3 == 0)
+			{
+				CHECK(map.remove(key) == (expected.erase(key) == 1));
+			}
+			else
+			{
+				map[key] = i;
+				expected[key] = i;
+			}
+		}
+
+		CHECK(map.count() == expected.size());
+		usize mismatch_count = 0;
+		for(usize key = 0; key < 1000; ++key)
+		{
+			auto it = map.lookup(key);
+			auto expected_it = expected.find(key);
+			if(expected_it == expected.end())
+				mismatch_count += it != map.end();
+			else
+				mismatch_count += it == map.end() || it->value != expected_it->second;
+		}
+		CHECK(mismatch_count == 0);
+
+		usize iterated_count = 0;
+		for(const auto& pair: map)
+		{
+			CHECK(expected[pair.key] == pair.value);
+			++iterated_count;
+		}
+		CHECK(iterated_count == expected.size());
+	}
+
+	SECTION("Case 18")
+	{
+		Hash_Set<String> set;
+		char buffer[32];
+
+		for(usize i = 0; i < 100; ++i)
+		{
+			::snprintf(buffer, sizeof(buffer), "key%zu", i);
+			set.insert(String(buffer));
+		}
+
+		CHECK(set.count() == 100);
+		CHECK(set.lookup("key0") != set.end());
+		CHECK(set.lookup("key99") != set.end());
+		CHECK(set.lookup("key") == set.end());
+
+		for(usize i = 0; i < 100; i += 2)
+		{
+			::snprintf(buffer, sizeof(buffer), "key%zu", i);
+			CHECK(set.remove(String(buffer)));
+		}
+		CHECK(set.count() == 50);
+		CHECK(set.lookup("key0") == set.end());
+		CHECK(set.lookup("key1") != set.end());
+
+		Hash_Set<String> other;
+		other = set;
+		CHECK(other.count() == 50);
+		for(const auto& str: set)
+			CHECK(other.lookup(str) != other.end());
+	}
+
+	SECTION("Case 19")
+	{
+		Hash_Map<usize, usize, internal::Pair_Hash_Functor<usize, usize>, HASH_PROBING::ROBIN_HOOD> map;
+		std::unordered_map<usize, usize> expected;
+
+		std::mt19937 gen(4321);
+		for(usize i = 0; i < 20000; ++i)
+		{
+			usize key = gen() % 1000;
+			if(gen() % 2 == 0)
+			{
+				CHECK(map.remove(key) == (expected.erase(key) == 1));
+			}
+			else
+			{
+				map[key] = i;
+				expected[key] = i;
+			}
+		}
+
+		CHECK(map.count() == expected.size());
+		usize mismatch_count = 0;
+		for(usize key = 0; key < 1000; ++key)
+		{
+			auto it = map.lookup(key);
+			auto expected_it = expected.find(key);
+			if(expected_it == expected.end())
+				mismatch_count += it != map.end();
+			else
+				mismatch_count += it == map.end() || it->value != expected_it->second;
+		}
+		CHECK(mismatch_count == 0);
+
+		usize iterated_count = 0;
+		for(const auto& pair: map)
+		{
+			CHECK(expected[pair.key] == pair.value);
+			++iterated_count;
+		}
+		CHECK(iterated_count == expected.size());
+	}
+
+	SECTION("Case 20")
+	{
+		Hash_Set<usize, Constant_Hash> swiss;
+		Hash_Set<usize, Constant_Hash, HASH_PROBING::ROBIN_HOOD> robin_hood;
+
+		for(usize i = 0; i < 300; ++i)
+		{
+			swiss.insert(i);
+			robin_hood.insert(i);
+		}
+		CHECK(swiss.count() == 300);
+		CHECK(robin_hood.count() == 300);
+
+		for(usize i = 0; i < 300; i += 3)
+		{
+			CHECK(swiss.remove(i));
+			CHECK(robin_hood.remove(i));
+		}
+
+		usize mismatch_count = 0;
+		for(usize i = 0; i < 300; ++i)
+		{
+			bool found = i % 3 != 0;
+			mismatch_count += (swiss.lookup(i) != swiss.end()) != found;
+			mismatch_count += (robin_hood.lookup(i) != robin_hood.end()) != found;
+		}
+		CHECK(mismatch_count == 0);
+		CHECK(swiss.count() == 200);
+		CHECK(robin_hood.count() == 200);
+	}
+
+	SECTION("Case 21")
+	{
+		Hash_Set<String, Hash<String>, HASH_PROBING::ROBIN_HOOD> set;
+		char buffer[32];
+
+		for(usize i = 0; i < 100; ++i)
+		{
+			::snprintf(buffer, sizeof(buffer), "key%zu", i);
+			set.insert(String(buffer));
+		}
+
+		for(usize i = 0; i < 100; i += 2)
+		{
+			::snprintf(buffer, sizeof(buffer), "key%zu", i);
+			CHECK(set.remove(String(buffer)));
+		}
+		CHECK(set.count() == 50);
+		CHECK(set.lookup("key0") == set.end());
+		CHECK(set.lookup("key1") != set.end());
+
+		Hash_Set<String, Hash<String>, HASH_PROBING::ROBIN_HOOD> other;
+		other = set;
+		CHECK(other.count() == 50);
+		for(const auto& str: set)
+			CHECK(other.lookup(str) != other.end());
+	}
+
+	SECTION("Case 22")
+	{
+		Hash_Map<usize, usize> map;
+		map.max_load_factor(0.875f);
+		CHECK(map.max_load_factor() == 0.875f);
+
+		for(usize i = 0; i < 1500; ++i)
+			map[i] = i;
+		CHECK(map.count() == 1500);
+		CHECK(map.capacity() == 2048);
+
+		for(usize i = 100; i < 1500; ++i)
+			CHECK(map.remove(i));
+
+		map.shrink_to_fit();
+		CHECK(map.count() == 100);
+		CHECK(map.capacity() == 128);
+
+		usize mismatch_count = 0;
+		for(usize i = 0; i < 1500; ++i)
+		{
+			auto it = map.lookup(i);
+			if(i < 100)
+				mismatch_count += it == map.end() || it->value != i;
+			else
+				mismatch_count += it != map.end();
+		}
+		CHECK(mismatch_count == 0);
+
+		map.rehash(5000);
+		CHECK(map.capacity() == 8192);
+		CHECK(map.count() == 100);
+		CHECK(map.lookup(99)->value == 99);
+
+		map.max_load_factor(0.25f);
+		map.shrink_to_fit();
+		CHECK(map.capacity() == 512);
+
+		map.clear();
+		map.shrink_to_fit();
+		CHECK(map.capacity() == 0);
+	}
+
+	SECTION("Case 23")
+	{
+		Hash_Set<usize> set;
+		set.max_load_factor(0.9375f);
+		std::unordered_map<usize, bool> expected;
+
+		std::mt19937 gen(5678);
+		for(usize i = 0; i < 30000; ++i)
+		{
+			usize key = gen() % 2000;
+			if(gen() % 2 == 0)
+			{
+				set.remove(key);
+				expected.erase(key);
+			}
+			else
+			{
+				set.insert(key);
+				expected[key] = true;
+			}
+		}
+		CHECK(set.count() == expected.size());
+
+		usize capacity = set.capacity();
+		set.rehash(set.count());
+		CHECK(set.capacity() == capacity);
+		CHECK(set._deleted_count == 0);
+
+		usize mismatch_count = 0;
+		for(usize key = 0; key < 2000; ++key)
+			mismatch_count += (set.lookup(key) != set.end()) != (expected.find(key) != expected.end());
+		CHECK(mismatch_count == 0);
+
+		usize used_count = 0;
+		for(usize i = 0; i < set.capacity(); ++i)
+			used_count += internal::_hash_flag_used(set._flags[i]);
+		CHECK(used_count == set.count());
+	}
+
+	SECTION("Case 24")
+	{
+		CHECK(Hash<String>()(String("Content-Type")) == Hash<String_Range>()(make_strrng("Content-Type")));
+		CHECK(Hash<String>()("Content-Type") == Hash<String_Range>()(make_strrng("Content-Type")));
+		CHECK(Hash<String>()(String()) == Hash<String_Range>()(make_strrng("")));
+
+		Hash_Map<String, usize> map;
+		map["Host"] = 1;
+		map["Content-Type"] = 2;
+		map["Content-Length"] = 3;
+
+		const char* request = "Content-Length: 42";
+		String_Range header = make_strrng(request, 14);
+
+		CHECK(map.lookup(header)->value == 3);
+		CHECK(map.lookup(make_strrng("Host"))->value == 1);
+		CHECK(map.lookup(make_strrng("Hos")) == map.end());
+		CHECK(map.lookup("Content-Type")->value == 2);
+		CHECK(map.contains(header));
+		CHECK(map.contains(String("Host")));
+		CHECK(map.contains(make_strrng("Accept")) == false);
+
+		const auto& const_map = map;
+		CHECK(const_map.lookup(header)->value == 3);
+
+		CHECK(map.remove(header));
+		CHECK(map.remove(header) == false);
+		CHECK(map.count() == 2);
+		CHECK(map.contains("Content-Length") == false);
+
+		Hash_Set<String> set;
+		set.insert(String("Accept"));
+		set.insert(String());
+		CHECK(set.contains(make_strrng("Accept")));
+		CHECK(set.contains(make_strrng("")));
+		CHECK(set.lookup("Accept") != set.end());
+		CHECK(set.remove(make_strrng("Accept")));
+		CHECK(set.count() == 1);
+	}
+
+	SECTION("Case 25")
+	{
+		Hash_Map<usize, Counted_Value> map;
+		map.reserve(64);
+		Counted_Value::construct_count = 0;
+		Counted_Value::assign_count = 0;
+
+		CHECK(map.try_emplace(1, 40, 2)->value.value == 42);
+		CHECK(Counted_Value::construct_count == 1);
+
+		//the key exists so nothing is constructed
+		CHECK(map.try_emplace(1, 1, 1)->value.value == 42);
+		CHECK(Counted_Value::construct_count == 1);
+
+		CHECK(map.lookup_or_insert(2).value == 0);
+		CHECK(Counted_Value::construct_count == 2);
+		map.lookup_or_insert(2, 5).value += 3;
+		CHECK(map.lookup(2)->value.value == 3);
+		CHECK(Counted_Value::construct_count == 2);
+
+		Counted_Value v(7);
+		Counted_Value::construct_count = 0;
+		CHECK(map.insert_or_assign(3, v)->value.value == 7);
+		CHECK(Counted_Value::construct_count == 1);
+		CHECK(Counted_Value::assign_count == 0);
+
+		v.value = 9;
+		CHECK(map.insert_or_assign(3, v)->value.value == 9);
+		CHECK(Counted_Value::construct_count == 1);
+		CHECK(Counted_Value::assign_count == 1);
+		CHECK(map.count() == 3);
+
+		Hash_Map<String, String> strings;
+		strings.try_emplace(String("key"), "value");
+		strings.insert_or_assign("other", String("first"));
+		strings.insert_or_assign("other", String("second"));
+		CHECK(strings.count() == 2);
+		CHECK(strings.lookup("key")->value == "value");
+		CHECK(strings.lookup("other")->value == "second");
+		CHECK(strings.lookup_or_insert(String("new"), "third") == "third");
+		CHECK(strings.count() == 3);
+	}
+
+	SECTION("Case 26")
+	{
+		static_assert(Hash_Cache_Default<String>::value, "String hashes should be cached");
+		static_assert(Hash_Cache_Default<usize>::value == false, "integer hashes shouldn't be cached");
+
+		Hash_Set<Counted_Key, Counted_Key_Hash> set;
+		Hash_Set<Counted_Key, Counted_Key_Hash, HASH_PROBING::SWISS, false> uncached_set;
+
+		Counted_Key::hash_count = 0;
+		for(usize i = 0; i < 1000; ++i)
+			set.insert(Counted_Key(i * 2));
+
+		//growing reads the cached hashes instead of calling the hasher
+		CHECK(Counted_Key::hash_count == 1000);
+		set.reserve(100000);
+		set.rehash(0);
+		CHECK(Counted_Key::hash_count == 1000);
+
+		Counted_Key::hash_count = 0;
+		for(usize i = 0; i < 1000; ++i)
+			uncached_set.insert(Counted_Key(i * 2));
+		CHECK(Counted_Key::hash_count > 1000);
+
+		//the missing keys are never compared since their full hashes differ from the stored ones
+		usize found_count = 0;
+		Counted_Key::compare_count = 0;
+		for(usize i = 0; i < 1000; ++i)
+			found_count += set.contains(Counted_Key(i * 2 + 1));
+		CHECK(Counted_Key::compare_count == 0);
+
+		Counted_Key::compare_count = 0;
+		for(usize i = 0; i < 1000; ++i)
+			found_count += uncached_set.contains(Counted_Key(i * 2 + 1));
+		CHECK(Counted_Key::compare_count > 0);
+		CHECK(found_count == 0);
+
+		for(usize i = 0; i < 1000; ++i)
+			found_count += set.contains(Counted_Key(i * 2));
+		CHECK(found_count == 1000);
+
+		auto copy = set;
+		CHECK(copy.count() == 1000);
+		CHECK(copy.contains(Counted_Key(1998)));
+	}
+
+	SECTION("Case 27")
+	{
+		//the cached hashes follow the values when they are shifted by robin hood insertion and removal
+		Hash_Map<String, usize, internal::Pair_Hash_Functor<String, usize>, HASH_PROBING::ROBIN_HOOD> map;
+		std::unordered_map<usize, usize> reference;
+		std::mt19937_64 generator(7);
+
+		char buffer[32];
+		usize mismatch_count = 0;
+		for(usize i = 0; i < 20000; ++i)
+		{
+			usize key = generator() % 2000;
+			std::snprintf(buffer, sizeof(buffer), "key%zu", key);
+			if(generator() % 3 == 0)
+			{
+				mismatch_count += map.remove(make_strrng(buffer)) != (reference.erase(key) == 1);
+			}
+			else
+			{
+				map.insert_or_assign(String(buffer), i);
+				reference[key] = i;
+			}
+		}
+
+		CHECK(map.count() == reference.size());
+		for(const auto& pair: reference)
+		{
+			std::snprintf(buffer, sizeof(buffer), "key%zu", pair.first);
+			auto it = map.lookup(make_strrng(buffer));
+			mismatch_count += it == map.end() || it->value != pair.second;
+		}
+		CHECK(mismatch_count == 0);
+
+		map.shrink_to_fit();
+		for(usize i = 0; i < map._capacity; ++i)
+			if(map._flags[i] != internal::HASH_FLAGS::EMPTY)
+				mismatch_count += map._hashes[i] != map._hasher(map._values[i].key);
+		CHECK(mismatch_count == 0);
+	}
+
+	SECTION("Case 28")
+	{
+		//robin hood shifts and rehashes move the String keys instead of copying them
+		Instrumented_Allocator instrumented;
+		{
+			Hash_Map<String, usize, internal::Pair_Hash_Functor<String, usize>, HASH_PROBING::ROBIN_HOOD> map(instrumented);
+			char buffer[32];
+			for(usize i = 0; i < 1500; ++i)
+			{
+				std::snprintf(buffer, sizeof(buffer), "key%zu", i);
+				map.try_emplace(String(buffer, instrumented), i);
+			}
+			CHECK(map.count() == 1500);
+
+			usize alloc_count = instrumented.stats.alloc_count;
+			for(usize i = 0; i < 1500; ++i)
+			{
+				std::snprintf(buffer, sizeof(buffer), "key%zu", i);
+				CHECK(map.remove(make_strrng(buffer)));
+			}
+			CHECK(map.count() == 0);
+			CHECK(instrumented.stats.alloc_count == alloc_count);
+
+			for(usize i = 0; i < 1500; ++i)
+			{
+				std::snprintf(buffer, sizeof(buffer), "key%zu", i);
+				map.try_emplace(String(buffer, instrumented), i);
+			}
+			//only the inserted keys are allocated
+			CHECK(instrumented.stats.alloc_count == alloc_count + 1500);
+
+			map.rehash(map._capacity * 2);
+			//only the flags, values and cached hashes are allocated
+			CHECK(instrumented.stats.alloc_count == alloc_count + 1500 + 3);
+			CHECK(map.lookup(make_strrng("key42"))->value == 42);
+		}
+		CHECK(instrumented.stats.live_size == 0);
+	}
+
+	SECTION("Case 29")
+	{
+		//without cached hashes no hashes buffer is allocated when growing or copying
+		Instrumented_Allocator instrumented;
+		{
+			Hash_Map<usize, usize> map(instrumented);
+			usize rehash_count = 0;
+			for(usize i = 0; i < 1000; ++i)
+			{
+				usize capacity = map._capacity;
+				map.insert(i, i);
+				rehash_count += map._capacity != capacity;
+			}
+			CHECK(map._hashes.ptr == nullptr);
+			CHECK(instrumented.stats.alloc_count == rehash_count * 2);
+
+			usize alloc_count = instrumented.stats.alloc_count;
+			auto copy = map;
+			CHECK(instrumented.stats.alloc_count == alloc_count + 2);
+
+			Hash_Map<usize, usize> other(instrumented);
+			other = copy;
+			CHECK(instrumented.stats.alloc_count == alloc_count + 4);
+			CHECK(other.lookup(999)->value == 999);
+		}
+		CHECK(instrumented.stats.live_size == 0);
+		CHECK(instrumented.stats.alloc_count == instrumented.stats.free_count);
+	}
+}
@@ -0,0 +1,137 @@
+#include "catch.hpp"
+#include <cpprelude/Small_Map.h>
+#include <cpprelude/String.h>
+#include <unordered_map>
+#include <random>
+#include <string>
+
+using namespace cppr;
+
+TEST_CASE("Small_Map", "[Small_Map]")
+{
+	SECTION("Case 01")
+	{
+		Small_Map<usize, usize, 4> map;
+
+		CHECK(map.is_inline());
+		CHECK(map.empty());
+		CHECK(map.capacity() == 4);
+		CHECK(map.begin() == map.end());
+		CHECK(map.lookup(1) == map.end());
+		CHECK(map.remove(1) == false);
+
+		for(usize i = 0; i < 4; ++i)
+			map.insert(i, i * 10);
+
+		//the inline pairs need no memory
+		CHECK(map.is_inline());
+		CHECK(map._map._values.ptr == nullptr);
+		CHECK(map.count() == 4);
+		CHECK(map.insert(2, 42)->value == 20);
+		CHECK(map.lookup(3)->value == 30);
+
+		usize sum = 0;
+		for(const auto& pair: map)
+			sum += pair.value;
+		CHECK(sum == 60);
+
+		CHECK(map.remove(0));
+		CHECK(map.count() == 3);
+		CHECK(map.contains(0) == false);
+		CHECK(map.lookup(3)->value == 30);
+		map[0] = 5;
+		CHECK(map.is_inline());
+
+		//the fifth key moves the pairs into the hash map
+		map[4] = 40;
+		CHECK(map.is_inline() == false);
+		CHECK(map.count() == 5);
+		for(usize i = 1; i < 5; ++i)
+			CHECK(map.lookup(i)->value == i * 10);
+		CHECK(map.lookup(0)->value == 5);
+
+		map.remove(4);
+		map.remove(0);
+		map.shrink_to_fit();
+		CHECK(map.is_inline());
+		CHECK(map.count() == 3);
+		CHECK(map.lookup(2)->value == 20);
+
+		map.reserve(10);
+		CHECK(map.is_inline() == false);
+		CHECK(map.lookup(1)->value == 10);
+
+		map.reset();
+		CHECK(map.is_inline());
+		CHECK(map.empty());
+	}
+
+	SECTION("Case 02")
+	{
+		//random churn around the inline limit against a reference map
+		Small_Map<usize, usize> map;
+		std::unordered_map<usize, usize> reference;
+		std::mt19937_64 generator(42);
+
+		usize mismatch_count = 0;
+		for(usize i = 0; i < 20000; ++i)
+		{
+			usize key = generator() % 12;
+			if(generator() % 3 == 0)
+			{
+				mismatch_count += map.remove(key) != (reference.erase(key) == 1);
+			}
+			else
+			{
+				map.insert_or_assign(key, i);
+				reference[key] = i;
+			}
+
+			if(i % 1000 == 0)
+				map.shrink_to_fit();
+
+			mismatch_count += map.count() != reference.size();
+			for(const auto& pair: map)
+				mismatch_count += reference[pair.key] != pair.value;
+		}
+		CHECK(mismatch_count == 0);
+
+		auto copy = map;
+		auto moved = std::move(map);
+		CHECK(map.empty());
+		CHECK(copy.count() == reference.size());
+		CHECK(moved.count() == reference.size());
+		for(const auto& pair: reference)
+		{
+			mismatch_count += copy.lookup(pair.first)->value != pair.second;
+			mismatch_count += moved.lookup(pair.first)->value != pair.second;
+		}
+		CHECK(mismatch_count == 0);
+	}
+
+	SECTION("Case 03")
+	{
+		Small_Map<String, String, 2> map;
+		map.insert("Mostafa", "first");
+		map.try_emplace(String("Moka"), "second");
+
+		Small_Map<String, String, 2> copy = map;
+		CHECK(copy.is_inline());
+		CHECK(copy.lookup(make_strrng("Moka"))->value == "second");
+
+		map.insert_or_assign("Koko", String("third"));
+		map["Mostafa"] = "changed";
+		CHECK(map.is_inline() == false);
+		CHECK(map.count() == 3);
+		CHECK(map.lookup("Mostafa")->value == "changed");
+		CHECK(map.lookup(make_strrng("Koko"))->value == "third");
+
+		CHECK(copy.remove(copy.lookup("Mostafa")));
+		CHECK(copy.count() == 1);
+		CHECK(copy.begin()->key == "Moka");
+
+		copy = std::move(map);
+		CHECK(copy.count() == 3);
+		CHECK(copy.contains(make_strrng("Koko")));
+	}
+}
@@ -3,6 +3,7 @@
 #include <cpprelude/Dynamic_Array.h>
 #include <cpprelude/Algorithms.h>
 #include <cpprelude/String.h>
+#include <cpprelude/Allocators.h>
 
 using namespace cppr;
 
@@ -728,4 +729,305 @@ TEST_CASE("Tree_Map", "[Tree_Map]")
 			++i;
 		}
 	}
+	SECTION("Case 27")
+	{
+		//the subtree sizes stay right through the insertion and removal rotations
+		Tree_Map<usize, usize> map;
+		for (usize i = 0; i < 1000; ++i)
+			map.insert((i * 7919) % 1000, i);
+		CHECK(map._is_red_black_tree());
+		CHECK(map._root->size == 1000);
+
+		usize mismatch_count = 0;
+		for (usize i = 0; i < 1000; ++i)
+		{
+			mismatch_count += map.select(i)->key != i;
+			mismatch_count += map.rank(i) != i;
+		}
+		CHECK(mismatch_count == 0);
+		CHECK(map.select(1000) == map.end());
+
+		for (usize i = 0; i < 1000; i += 3)
+			map.remove(i);
+		CHECK(map._is_red_black_tree());
+		CHECK(map.count() == 666);
+
+		//the remaining keys are the ones not divisible by 3
+		for (usize i = 0; i < 1000; ++i)
+		{
+			usize expected_rank = i - (i + 2) / 3;
+			mismatch_count += map.rank(i) != expected_rank;
+			if (i % 3 != 0)
+				mismatch_count += map.select(expected_rank)->key != i;
+		}
+		CHECK(mismatch_count == 0);
+		CHECK(map.rank(5000) == 666);
+
+		auto range = map.range(100, 110);
+		CHECK(range.count() == 10);
+		for (usize i = 100; !range.empty(); ++i, range.pop_front())
+			mismatch_count += range.front().key != map.select(i)->key;
+		CHECK(mismatch_count == 0);
+
+		auto sub_range = map.all().range(300, 400).range(50, 60);
+		CHECK(sub_range.front().key == map.select(350)->key);
+		CHECK(map.all().range(665, 666).front().key == 998);
+		CHECK(map.all().range(666, 666).empty());
+
+		const auto& const_map = map;
+		CHECK(const_map.select(0)->key == 1);
+		CHECK(const_map.range(1, 2).front().key == 2);
+
+		Tree_Set<usize> set{5, 1, 3};
+		CHECK(set.rank(3) == 1);
+		CHECK(set.rank(4) == 2);
+		CHECK(*set.select(2) == 5);
+	}
+	SECTION("Case 28")
+	{
+		//every size builds a valid red black tree in order
+		usize mismatch_count = 0;
+		for (usize n = 0; n < 300; ++n)
+		{
+			Dynamic_Array<Pair_Node<usize, usize>> pairs;
+			for (usize i = 0; i < n; ++i)
+				pairs.insert_back(Pair_Node<usize, usize>(i * 2, i));
+
+			Tree_Map<usize, usize> map;
+			map.insert(1, 1);
+			map.build_from_sorted(pairs.all());
+			mismatch_count += !map._is_red_black_tree();
+			mismatch_count += map.count() != n;
+			mismatch_count += map.lookup(1) != map.end();
+
+			usize i = 0;
+			for (const auto& pair : map)
+			{
+				mismatch_count += pair.key != i * 2 || pair.value != i;
+				++i;
+			}
+			mismatch_count += i != n;
+		}
+		CHECK(mismatch_count == 0);
+
+		//the repeated keys keep their first pair
+		Dynamic_Array<Pair_Node<usize, usize>> pairs;
+		for (usize i = 0; i < 3000; ++i)
+			pairs.insert_back(Pair_Node<usize, usize>(i / 3, i));
+		Tree_Map<usize, usize> map;
+		map.build_from_sorted(pairs.all());
+		CHECK(map._is_red_black_tree());
+		CHECK(map.count() == 1000);
+		CHECK(map.lookup(10)->value == 30);
+		CHECK(map.select(500)->key == 500);
+
+		//the block nodes mix with the allocated ones
+		for (usize i = 0; i < 1000; i += 2)
+			map.remove(i);
+		for (usize i = 1000; i < 1500; ++i)
+			map.insert(i, i);
+		CHECK(map._is_red_black_tree());
+		CHECK(map.count() == 1000);
+		CHECK(map.rank(1000) == 500);
+
+		Tree_Map<usize, usize> copy = map;
+		CHECK(copy._is_red_black_tree());
+		CHECK(copy.count() == 1000);
+
+		Tree_Set<usize> set;
+		Dynamic_Array<usize> values = {1, 3, 5, 7};
+		set.build_from_sorted(values.all());
+		CHECK(set._is_red_black_tree());
+		CHECK(*set.select(3) == 7);
+	}
+
+	SECTION("Case 29")
+	{
+		Tree_Map<usize, usize> a, b;
+		for (usize i = 0; i < 1000; ++i)
+			a.insert(i * 2, 0);
+		for (usize i = 0; i < 1000; ++i)
+			b.insert(i * 3, 1);
+
+		a.merge(b);
+		CHECK(b.empty());
+		CHECK(b._root == nullptr);
+		CHECK(a._is_red_black_tree());
+
+		//the keys of both maps, the shared multiples of 6 keep the value of the first map
+		usize mismatch_count = 0;
+		usize expected_count = 0;
+		for (usize i = 0; i < 3000; ++i)
+		{
+			bool in_a = i % 2 == 0 && i < 2000;
+			bool in_b = i % 3 == 0;
+			if (!in_a && !in_b)
+			{
+				mismatch_count += a.lookup(i) != a.end();
+				continue;
+			}
+			++expected_count;
+			auto it = a.lookup(i);
+			mismatch_count += it == a.end() || it->value != (in_a ? 0 : 1);
+		}
+		CHECK(mismatch_count == 0);
+		CHECK(a.count() == expected_count);
+
+		//merge into a built tree then into an empty one
+		Tree_Map<usize, usize> c;
+		c.insert(5000, 2);
+		a.merge(c);
+		CHECK(a.count() == expected_count + 1);
+		CHECK(a.max()->key == 5000);
+
+		Tree_Map<usize, usize> d;
+		d.merge(a);
+		CHECK(a.empty());
+		CHECK(d.count() == expected_count + 1);
+		CHECK(d._is_red_black_tree());
+		d.merge(d);
+		CHECK(d.count() == expected_count + 1);
+
+		Tree_Map<String, usize> e, f;
+		e.insert("b", 1);
+		f.insert("a", 2);
+		f.insert("b", 3);
+		e.merge(f);
+		CHECK(e.count() == 2);
+		CHECK(e.lookup("b")->value == 1);
+		CHECK(e.min()->key == "a");
+	}
+	SECTION("Case 30")
+	{
+		//keys 0, 10, 20, ..., 990
+		Tree_Map<usize, usize> map;
+		for (usize i = 0; i < 100; ++i)
+			map.insert(i * 10, i);
+
+		auto range = map.lower_bound(250);
+		CHECK(range.count() == 75);
+		CHECK(range.front().key == 250);
+		usize visited = 0;
+		for (const auto& pair: range)
+			visited += pair.key >= 250;
+		CHECK(visited == 75);
+
+		CHECK(map.lower_bound(255).front().key == 260);
+		CHECK(map.upper_bound(250).front().key == 260);
+		CHECK(map.upper_bound(250).count() == 74);
+		CHECK(map.lower_bound(0).count() == 100);
+		CHECK(map.lower_bound(991).empty());
+		CHECK(map.upper_bound(990).empty());
+		CHECK(map.lower_bound(991).begin() == map.lower_bound(991).end());
+
+		CHECK(map.equal_range(500).count() == 1);
+		CHECK(map.equal_range(500).front().value == 50);
+		CHECK(map.equal_range(505).empty());
+		usize equal_count = 0;
+		for (const auto& pair: map.equal_range(500))
+			equal_count += pair.key == 500;
+		CHECK(equal_count == 1);
+
+		CHECK(map.floor(255)->key == 250);
+		CHECK(map.floor(250)->key == 250);
+		CHECK(map.floor(5000)->key == 990);
+		CHECK(map.ceil(255)->key == 260);
+		CHECK(map.ceil(990)->key == 990);
+		CHECK(map.ceil(991) == map.end());
+
+		const Tree_Map<usize, usize>& const_map = map;
+		CHECK(const_map.floor(5)->key == 0);
+		CHECK(const_map.lower_bound(985).count() == 1);
+
+		//a key window [from, to) stops at its end instead of walking to the end of the map
+		auto window = map.range(map.ceil(123), map.ceil(456));
+		CHECK(window.count() == 33);
+		usize sum = 0, window_count = 0;
+		for (const auto& pair: window)
+		{
+			sum += pair.key;
+			++window_count;
+		}
+		CHECK(window_count == 33);
+		CHECK(sum == (130 + 450) * 33 / 2);
+
+		auto tail = const_map.range(const_map.ceil(900), const_map.end());
+		CHECK(tail.count() == 10);
+		window_count = 0;
+		for (const auto& pair: tail)
+			window_count += pair.key >= 900;
+		CHECK(window_count == 10);
+
+		//index ranges are bounded too
+		window_count = 0;
+		for (const auto& pair: map.range(10, 20))
+			window_count += pair.value >= 10 && pair.value < 20;
+		CHECK(window_count == 10);
+		window_count = 0;
+		for (const auto& pair: map.all().range(95, 100))
+			window_count += pair.value >= 95;
+		CHECK(window_count == 5);
+
+		Tree_Map<usize, usize> empty;
+		CHECK(empty.lower_bound(1).empty());
+		CHECK(empty.equal_range(1).empty());
+		CHECK(empty.floor(1) == empty.end());
+		CHECK(empty.range(empty.begin(), empty.end()).empty());
+
+		Tree_Set<usize> set;
+		for (usize i = 0; i < 20; i += 2)
+			set.insert(i);
+		CHECK(set.lower_bound(5).count() == 7);
+		CHECK(*set.floor(5) == 4);
+		CHECK(*set.ceil(5) == 6);
+		CHECK(set.range(set.ceil(4), set.ceil(10)).count() == 3);
+	}
+
+	SECTION("Case 31")
+	{
+		//merge relinks the nodes of both trees, the built trees hand over their node blocks
+		Instrumented_Allocator instrumented;
+		{
+			Dynamic_Array<Pair_Node<usize, usize>> a_pairs, b_pairs;
+			for (usize i = 0; i < 500; ++i)
+			{
+				a_pairs.insert_back(Pair_Node<usize, usize>(i * 2, 0));
+				b_pairs.insert_back(Pair_Node<usize, usize>(i * 3, 1));
+			}
+
+			Tree_Map<usize, usize> a(instrumented), b(instrumented);
+			a.build_from_sorted(a_pairs.all());
+			b.build_from_sorted(b_pairs.all());
+			b.insert(7000, 1);
+
+			auto first_node = a.lookup(2).node;
+			auto other_node = b.lookup(3).node;
+			usize alloc_count = instrumented.stats.alloc_count;
+			a.merge(b);
+			//only the node pointers and the blocks array are allocated
+			CHECK(instrumented.stats.alloc_count <= alloc_count + 2);
+			CHECK(a.lookup(2).node == first_node);
+			CHECK(a.lookup(3).node == other_node);
+			CHECK(a._blocks.count() == 2);
+			CHECK(b.empty());
+			CHECK(a._is_red_black_tree());
+			CHECK(a.count() == 500 + 500 - 167 + 1);
+			CHECK(a.lookup(6)->value == 0);
+			a.remove(3);
+			a.remove(7000);
+			CHECK(a.count() == 500 + 500 - 167 - 1);
+
+			//the nodes of a tree with another allocator are moved into new nodes
+			Tree_Map<usize, usize> c;
+			c.insert(1, 1);
+			c.insert(2, 1);
+			a.merge(c);
+			CHECK(c.empty());
+			CHECK(a.lookup(1)->value == 1);
+			CHECK(a.lookup(2)->value == 0);
+			CHECK(a._is_red_black_tree());
+		}
+		CHECK(instrumented.stats.live_size == 0);
+		CHECK(instrumented.stats.alloc_count == instrumented.stats.free_count);
+	}
 }
\ No newline at end of file